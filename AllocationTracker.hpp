@@ -0,0 +1,149 @@
+// AllocationTracker.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// The AllocationTracker keeps a running total of heap memory allocated
+// through it: how many bytes are allocated now, the most that ever were
+// at once, and how many allocations there have been.  It's fed in one of
+// two ways:
+//
+// * A container can be given a TrackingAllocator, which reports every
+//   allocation it makes (for example, a std::map<int, int, std::less<int>,
+//   TrackingAllocator<std::pair<const int, int>>>).  Like benchmain's,
+//   it reports the size of the heap block that holds each allocation,
+//   as heapBlockBytes() computes it, so that its totals can be compared
+//   with the estimates in MemoryFootprint.hpp.
+//
+// * A program can replace the global operator new and operator delete
+//   with versions that report to it, as benchmain does, so that every
+//   allocation in the program is counted.
+//
+// Either way, comparing snapshots taken before and after building a data
+// structure shows what it really costs, to compare layouts or to catch a
+// change that makes one bigger.  The totals are shared by all threads.
+
+#ifndef ALLOCATIONTRACKER_HPP
+#define ALLOCATIONTRACKER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include "MemoryFootprint.hpp"
+
+
+
+struct AllocationCounts
+{
+    std::size_t currentBytes;
+    std::size_t peakBytes;
+    std::size_t allocations;
+};
+
+
+
+class AllocationTracker
+{
+public:
+    static void allocated(std::size_t bytes) noexcept;
+    static void deallocated(std::size_t bytes) noexcept;
+
+    static AllocationCounts counts() noexcept;
+
+    // resetPeak() makes the peak the current number of bytes, so that the
+    // peak of one phase of a program can be measured on its own.
+    static void resetPeak() noexcept;
+
+private:
+    static std::atomic<std::size_t> currentBytes_;
+    static std::atomic<std::size_t> peakBytes_;
+    static std::atomic<std::size_t> allocations_;
+};
+
+
+
+template <typename T>
+class TrackingAllocator
+{
+public:
+    using value_type = T;
+
+    TrackingAllocator() noexcept = default;
+
+    template <typename U>
+    TrackingAllocator(const TrackingAllocator<U>&) noexcept
+    {
+    }
+
+    T* allocate(std::size_t count)
+    {
+        T* p = static_cast<T*>(::operator new(count * sizeof(T)));
+        AllocationTracker::allocated(heapBlockBytes(count * sizeof(T)));
+        return p;
+    }
+
+    void deallocate(T* p, std::size_t count) noexcept
+    {
+        AllocationTracker::deallocated(heapBlockBytes(count * sizeof(T)));
+        ::operator delete(p);
+    }
+};
+
+
+template <typename T, typename U>
+bool operator==(const TrackingAllocator<T>&, const TrackingAllocator<U>&) noexcept
+{
+    return true;
+}
+
+
+template <typename T, typename U>
+bool operator!=(const TrackingAllocator<T>&, const TrackingAllocator<U>&) noexcept
+{
+    return false;
+}
+
+
+
+inline std::atomic<std::size_t> AllocationTracker::currentBytes_{0};
+inline std::atomic<std::size_t> AllocationTracker::peakBytes_{0};
+inline std::atomic<std::size_t> AllocationTracker::allocations_{0};
+
+
+inline void AllocationTracker::allocated(std::size_t bytes) noexcept
+{
+    std::size_t current = currentBytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    std::size_t peak = peakBytes_.load(std::memory_order_relaxed);
+
+    while (current > peak && !peakBytes_.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+    {
+    }
+
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+inline void AllocationTracker::deallocated(std::size_t bytes) noexcept
+{
+    currentBytes_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+
+inline AllocationCounts AllocationTracker::counts() noexcept
+{
+    return AllocationCounts{
+        currentBytes_.load(std::memory_order_relaxed),
+        peakBytes_.load(std::memory_order_relaxed),
+        allocations_.load(std::memory_order_relaxed)};
+}
+
+
+inline void AllocationTracker::resetPeak() noexcept
+{
+    peakBytes_.store(currentBytes_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+
+
+#endif
+
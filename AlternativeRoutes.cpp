@@ -0,0 +1,184 @@
+// AlternativeRoutes.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <set>
+#include <utility>
+#include "AlternativeRoutes.hpp"
+#include "CompactDigraph.hpp"
+#include "TripPlanner.hpp"
+
+
+namespace
+{
+    // sameLength() compares two path lengths, allowing for the rounding
+    // that comes from adding up the same weights in a different order.
+    bool sameLength(double a, double b)
+    {
+        return std::abs(a - b) <= 1e-9 * std::max(1.0, std::abs(a));
+    }
+}
+
+
+AlternativeRouteFinder::AlternativeRouteFinder(
+    const RoadMap& roadMap, TripMetric metric, double maxStretch, double maxSharing)
+    : roadMap_{roadMap}, forward_{roadMap, TripPlanner::edgeWeightFor(metric)},
+      maxStretch_{maxStretch}, maxSharing_{maxSharing}
+{
+    backward_ = forward_.reversed();
+}
+
+
+std::vector<Route> AlternativeRouteFinder::findRoutes(int startVertex, int endVertex, int k) const
+{
+    std::vector<Route> routes;
+
+    int start = forward_.indexOf(startVertex);
+    int end = forward_.indexOf(endVertex);
+
+    if (k <= 0)
+    {
+        return routes;
+    }
+
+    // fromStart holds distances from the start vertex, with fromParents
+    // pointing back toward it; toEnd holds distances to the end vertex,
+    // with toParents pointing onward toward it.  No vertex farther than
+    // the longest route that could be kept is ever part of one, so both
+    // searches stop there, leaving the rest at infinity.
+    std::vector<double> fromStart;
+    std::vector<int> fromParents;
+    std::vector<double> toEnd;
+    std::vector<int> toParents;
+
+    double limit = std::numeric_limits<double>::infinity();
+
+    forward_.findDistances(
+        std::vector<int>{start}, fromStart, fromParents,
+        [&](int settled)
+        {
+            if (settled == end)
+            {
+                limit = maxStretch_ * fromStart[end];
+            }
+
+            return fromStart[settled] > limit;
+        });
+
+    double best = fromStart[end];
+
+    if (best == std::numeric_limits<double>::infinity())
+    {
+        return routes;
+    }
+
+    backward_.findDistances(
+        std::vector<int>{end}, toEnd, toParents,
+        [&](int settled)
+        {
+            return toEnd[settled] > limit;
+        });
+
+    std::vector<std::pair<double, int>> candidates;
+
+    for (int v = 0; v < forward_.vertexCount(); ++v)
+    {
+        double length = fromStart[v] + toEnd[v];
+
+        if (length <= limit)
+        {
+            candidates.emplace_back(length, v);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+
+    std::vector<bool> examined(forward_.vertexCount(), false);
+    std::set<std::pair<int, int>> keptEdges;
+
+    for (const std::pair<double, int>& candidate : candidates)
+    {
+        if (examined[candidate.second])
+        {
+            continue;
+        }
+
+        // The route through v is the start vertex's tree path to v followed
+        // by v's tree path to the end vertex.  Along tree paths, each edge's
+        // weight is just the difference in distance across it.
+        std::vector<int> path;
+        std::vector<double> weights;
+
+        for (int v = candidate.second; v != start; v = fromParents[v])
+        {
+            path.push_back(v);
+            weights.push_back(fromStart[v] - fromStart[fromParents[v]]);
+        }
+
+        path.push_back(start);
+        std::reverse(path.begin(), path.end());
+        std::reverse(weights.begin(), weights.end());
+
+        for (int v = candidate.second; v != end; v = toParents[v])
+        {
+            path.push_back(toParents[v]);
+            weights.push_back(toEnd[v] - toEnd[toParents[v]]);
+        }
+
+        // Every vertex on the route whose own via-route is this same route
+        // would only produce it again, so none of them need to be tried.
+        for (int v : path)
+        {
+            if (sameLength(fromStart[v] + toEnd[v], candidate.first))
+            {
+                examined[v] = true;
+            }
+        }
+
+        std::set<int> distinct(path.begin(), path.end());
+
+        if (distinct.size() != path.size())
+        {
+            continue;
+        }
+
+        double shared = 0.0;
+
+        for (std::size_t i = 1; i < path.size(); ++i)
+        {
+            if (keptEdges.count({path[i - 1], path[i]}) > 0)
+            {
+                shared += weights[i - 1];
+            }
+        }
+
+        if (!routes.empty() && shared > maxSharing_ * best)
+        {
+            continue;
+        }
+
+        for (std::size_t i = 1; i < path.size(); ++i)
+        {
+            keptEdges.insert({path[i - 1], path[i]});
+        }
+
+        for (int& v : path)
+        {
+            v = forward_.vertexAt(v);
+        }
+
+        routes.push_back(TripPlanner::routeAlong(roadMap_, std::move(path)));
+
+        if (static_cast<int>(routes.size()) == k)
+        {
+            break;
+        }
+    }
+
+    return routes;
+}
+
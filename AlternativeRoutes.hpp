@@ -0,0 +1,65 @@
+// AlternativeRoutes.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// An AlternativeRouteFinder answers a trip with up to k reasonable routes
+// rather than just the single best one.  It uses the via-vertex technique:
+// one search outward from the start vertex and one search backward from
+// the end vertex give, for every vertex v, the best route that passes
+// through v.  Those routes are considered from shortest to longest, and a
+// route is kept when it is
+//
+// * not too much longer than the best route (its "stretch"),
+// * a simple path, i.e., it doesn't loop back on itself, and
+// * different enough from the routes already kept (the fraction of its
+//   length shared with them is limited).
+//
+// However many routes are asked for, the work is two searches plus a walk
+// along each route that's considered, so alternatives cost only a small
+// multiple of one query.  Both searches stop once they're past the
+// longest route that could be kept, and the flat graphs they run on are
+// built once, when the AlternativeRouteFinder is, rather than per trip.
+
+#ifndef ALTERNATIVEROUTES_HPP
+#define ALTERNATIVEROUTES_HPP
+
+#include <vector>
+#include "CompactDigraph.hpp"
+#include "RoadMap.hpp"
+#include "Route.hpp"
+#include "TripMetric.hpp"
+
+
+
+class AlternativeRouteFinder
+{
+public:
+    // Initializes an AlternativeRouteFinder for the given RoadMap, which
+    // must outlive it, measuring routes by the given metric.  It keeps
+    // routes at most maxStretch times as long as the best one, sharing at
+    // most maxSharing of the best route's length with the routes already
+    // kept.
+    AlternativeRouteFinder(
+        const RoadMap& roadMap, TripMetric metric,
+        double maxStretch = 1.4, double maxSharing = 0.75);
+
+    // findRoutes() returns up to k routes from the given start vertex to
+    // the given end vertex, best first.  The first one is always the
+    // shortest route; if the end vertex is unreachable, no routes are
+    // returned.  If either vertex does not exist, a DigraphException is
+    // thrown instead.
+    std::vector<Route> findRoutes(int startVertex, int endVertex, int k) const;
+
+private:
+    const RoadMap& roadMap_;
+    CompactDigraph forward_;
+    CompactDigraph backward_;
+    double maxStretch_;
+    double maxSharing_;
+};
+
+
+
+#endif
+
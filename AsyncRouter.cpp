@@ -0,0 +1,199 @@
+// AsyncRouter.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+#include <vector>
+#include "AsyncRouter.hpp"
+#include "TripPlanner.hpp"
+
+
+namespace
+{
+    // The routers given no TurnTable share this empty one, which allows
+    // every turn.
+    const TurnTable& noTurns()
+    {
+        static const TurnTable turns;
+        return turns;
+    }
+}
+
+
+AsyncRouter::AsyncRouter(
+    const RoadMap& roadMap, unsigned int workerCount,
+    std::size_t maxQueueDepth, std::size_t maxBatchSize)
+    : AsyncRouter{roadMap, noTurns(), workerCount, maxQueueDepth, maxBatchSize}
+{
+}
+
+
+AsyncRouter::AsyncRouter(
+    const RoadMap& roadMap, const TurnTable& turns, unsigned int workerCount,
+    std::size_t maxQueueDepth, std::size_t maxBatchSize)
+    : roadMap_{&roadMap}, replicas_{nullptr}, turns_{turns},
+      maxQueueDepth_{std::max<std::size_t>(1, maxQueueDepth)},
+      maxBatchSize_{std::max<std::size_t>(1, maxBatchSize)}, runningLoops_{0},
+      workers_{workerCount}
+{
+}
+
+
+AsyncRouter::AsyncRouter(
+    const NumaReplicas<RoadMap>& replicas, unsigned int workerCount,
+    std::size_t maxQueueDepth, std::size_t maxBatchSize)
+    : AsyncRouter{replicas, noTurns(), workerCount, maxQueueDepth, maxBatchSize}
+{
+}
+
+
+AsyncRouter::AsyncRouter(
+    const NumaReplicas<RoadMap>& replicas, const TurnTable& turns, unsigned int workerCount,
+    std::size_t maxQueueDepth, std::size_t maxBatchSize)
+    : roadMap_{nullptr}, replicas_{&replicas}, turns_{turns},
+      maxQueueDepth_{std::max<std::size_t>(1, maxQueueDepth)},
+      maxBatchSize_{std::max<std::size_t>(1, maxBatchSize)}, runningLoops_{0},
+      workers_{workerCount, replicas.topology()}
+{
+}
+
+
+AsyncRouter::~AsyncRouter() noexcept
+{
+    // The WorkerPool's destructor finishes every batch loop it was given,
+    // and each one runs until the queue is empty.
+}
+
+
+std::future<Route> AsyncRouter::submit(Trip trip)
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+    roomAvailable_.wait(lock, [this]() { return queue_.size() < maxQueueDepth_; });
+
+    return enqueue(std::move(trip), lock);
+}
+
+
+std::optional<std::future<Route>> AsyncRouter::trySubmit(Trip trip)
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    if (queue_.size() >= maxQueueDepth_)
+    {
+        return std::nullopt;
+    }
+
+    return enqueue(std::move(trip), lock);
+}
+
+
+std::size_t AsyncRouter::queueDepth()
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    return queue_.size();
+}
+
+
+std::future<Route> AsyncRouter::enqueue(Trip trip, std::unique_lock<std::mutex>& lock)
+{
+    queue_.push_back(Request{std::move(trip), std::promise<Route>{}});
+    std::future<Route> route = queue_.back().route.get_future();
+
+    // A batch loop keeps going until the queue is empty, so one is only
+    // started when there's a worker that isn't running one already.
+    bool startLoop = runningLoops_ < workers_.threadCount();
+
+    if (startLoop)
+    {
+        runningLoops_++;
+    }
+
+    lock.unlock();
+
+    if (startLoop)
+    {
+        workers_.submit([this]() { planBatches(); });
+    }
+
+    return route;
+}
+
+
+void AsyncRouter::planBatches()
+{
+    // Workers are pinned to their nodes, so the local copy is the same
+    // one for the whole loop.
+    const RoadMap& roadMap = replicas_ != nullptr ? replicas_->local() : *roadMap_;
+
+    TripPlanner planner{turns_};
+    std::vector<Request> batch;
+    std::vector<Trip> trips;
+
+    while (true)
+    {
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+
+            if (queue_.empty())
+            {
+                runningLoops_--;
+                return;
+            }
+
+            // A batch takes its share of the queue, rather than all of it,
+            // so that the other workers have something to do, too.
+            std::size_t share = (queue_.size() + workers_.threadCount() - 1) / workers_.threadCount();
+            std::size_t batchSize = std::min(maxBatchSize_, share);
+
+            while (batch.size() < batchSize)
+            {
+                batch.push_back(std::move(queue_.front()));
+                queue_.pop_front();
+            }
+        }
+
+        roomAvailable_.notify_all();
+
+        // Trips naming missing vertices are failed on their own, so they
+        // can't take the rest of the batch down with them.
+        std::vector<Request*> planned;
+
+        for (Request& request : batch)
+        {
+            try
+            {
+                TripPlanner::checkVertices(roadMap, request.trip);
+                trips.push_back(request.trip);
+                planned.push_back(&request);
+            }
+            catch (...)
+            {
+                request.route.set_exception(std::current_exception());
+            }
+        }
+
+        try
+        {
+            std::vector<Route> routes = planner.planTrips(roadMap, trips);
+
+            for (std::size_t i = 0; i < planned.size(); ++i)
+            {
+                planned[i]->route.set_value(std::move(routes[i]));
+            }
+        }
+        catch (...)
+        {
+            for (Request* request : planned)
+            {
+                request->route.set_exception(std::current_exception());
+            }
+        }
+
+        batch.clear();
+        trips.clear();
+    }
+}
+
@@ -0,0 +1,132 @@
+// AsyncRouter.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// An AsyncRouter plans trips without blocking the threads that ask for
+// them.  submit() queues a trip and immediately returns a std::future
+// that will hold its Route.  A fixed pool of worker threads takes the
+// queued trips in micro-batches: whatever has accumulated, up to a
+// maximum batch size, is planned at once by a TripPlanner, so trips from
+// the same start vertex that arrive close together share one search.
+//
+// The queue has a depth limit.  Once it's reached, submit() waits for
+// room (applying backpressure to whoever is submitting), while
+// trySubmit() gives up right away instead.
+//
+// A trip that refers to a vertex not in the RoadMap gets a future that
+// holds a DigraphException rather than a Route.
+//
+// On a machine with more than one NUMA node, an AsyncRouter can instead
+// be given a copy of the RoadMap on each node (see NumaReplicas.hpp); its
+// workers are then pinned across the nodes, and each plans its trips on
+// the copy on its own node.
+//
+// Given a TurnTable, an AsyncRouter plans every trip obeying its banned
+// turns and turn penalties, as a TripPlanner given the same table would.
+
+#ifndef ASYNCROUTER_HPP
+#define ASYNCROUTER_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <optional>
+#include "NumaReplicas.hpp"
+#include "RoadMap.hpp"
+#include "Route.hpp"
+#include "Trip.hpp"
+#include "TurnTable.hpp"
+#include "WorkerPool.hpp"
+
+
+
+class AsyncRouter
+{
+public:
+    // Initializes an AsyncRouter that plans trips on the given RoadMap with
+    // the given number of worker threads (0 meaning one per core), holding
+    // at most maxQueueDepth trips that haven't been started yet and
+    // planning at most maxBatchSize of them at a time on each thread.
+    // The RoadMap must outlive the AsyncRouter.
+    AsyncRouter(
+        const RoadMap& roadMap, unsigned int workerCount,
+        std::size_t maxQueueDepth = 4096, std::size_t maxBatchSize = 64);
+
+    // Initializes an AsyncRouter the same way, except that it plans trips
+    // obeying the given TurnTable, which must also outlive it.
+    AsyncRouter(
+        const RoadMap& roadMap, const TurnTable& turns, unsigned int workerCount,
+        std::size_t maxQueueDepth = 4096, std::size_t maxBatchSize = 64);
+
+    // Initializes an AsyncRouter the same way, except that its workers are
+    // pinned across the NUMA nodes of the given replicas, each planning
+    // trips on the copy of the RoadMap on its node.  The replicas must
+    // outlive the AsyncRouter.
+    AsyncRouter(
+        const NumaReplicas<RoadMap>& replicas, unsigned int workerCount,
+        std::size_t maxQueueDepth = 4096, std::size_t maxBatchSize = 64);
+
+    // Initializes an AsyncRouter on NUMA replicas that plans trips obeying
+    // the given TurnTable, which must also outlive it.
+    AsyncRouter(
+        const NumaReplicas<RoadMap>& replicas, const TurnTable& turns, unsigned int workerCount,
+        std::size_t maxQueueDepth = 4096, std::size_t maxBatchSize = 64);
+
+    // Destroying an AsyncRouter waits for every trip already submitted to
+    // be planned.
+    ~AsyncRouter() noexcept;
+
+    AsyncRouter(const AsyncRouter&) = delete;
+    AsyncRouter& operator=(const AsyncRouter&) = delete;
+
+    // submit() queues the given trip, waiting first for room in the queue
+    // if it's full, and returns a future for its Route.
+    std::future<Route> submit(Trip trip);
+
+    // trySubmit() is like submit(), except that it returns no future at
+    // all, rather than waiting, if the queue is full.
+    std::optional<std::future<Route>> trySubmit(Trip trip);
+
+    // queueDepth() returns the number of trips waiting to be started.
+    std::size_t queueDepth();
+
+private:
+    struct Request
+    {
+        Trip trip;
+        std::promise<Route> route;
+    };
+
+    // enqueue() adds a request to the queue, which the caller has already
+    // locked and made sure has room, and starts another batch loop on the
+    // workers if not all of them are running one.
+    std::future<Route> enqueue(Trip trip, std::unique_lock<std::mutex>& lock);
+
+    // planBatches() runs on a worker thread, planning batches of queued
+    // requests until the queue is empty.
+    void planBatches();
+
+    // Exactly one of roadMap_ and replicas_ is not null.
+    const RoadMap* roadMap_;
+    const NumaReplicas<RoadMap>* replicas_;
+    const TurnTable& turns_;
+    std::size_t maxQueueDepth_;
+    std::size_t maxBatchSize_;
+
+    std::mutex mutex_;
+    std::condition_variable roomAvailable_;
+    std::deque<Request> queue_;
+    unsigned int runningLoops_;
+
+    // The workers are declared last, so they are destroyed (finishing the
+    // queued work) before anything they use.
+    WorkerPool workers_;
+};
+
+
+
+#endif
+
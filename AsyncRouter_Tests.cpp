@@ -0,0 +1,94 @@
+// AsyncRouter_Tests.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// Unit tests for AsyncRouter, checking that the futures it hands back
+// are fulfilled with the routes a TripPlanner would have planned, whether
+// its workers share one RoadMap or each use the copy on its NUMA node,
+// and that it obeys a TurnTable when given one.
+
+#include <future>
+#include <limits>
+#include <vector>
+#include <gtest/gtest.h>
+#include "AsyncRouter.hpp"
+#include "NumaReplicas.hpp"
+#include "TurnTable.hpp"
+
+
+TEST(AsyncRouter_Tests, fulfilsFuturesLikePlanner)
+{
+    RoadMap roadMap;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        roadMap.addVertex(i, "Location");
+    }
+
+    roadMap.addEdge(0, 1, RoadSegment{1.0, 10.0});
+    roadMap.addEdge(1, 2, RoadSegment{1.0, 10.0});
+    roadMap.addEdge(0, 2, RoadSegment{1.5, 60.0});
+
+    AsyncRouter router{roadMap, 2, 2, 4};
+    std::vector<std::future<Route>> routes;
+
+    for (int i = 0; i < 20; ++i)
+    {
+        routes.push_back(router.submit(Trip{0, 1 + i % 2, TripMetric::Distance}));
+    }
+
+    std::future<Route> missing = router.submit(Trip{0, 7, TripMetric::Time});
+
+    for (int i = 0; i < 20; ++i)
+    {
+        ASSERT_EQ((std::vector<int>{0, 1 + i % 2}), routes[i].get().vertices);
+    }
+
+    ASSERT_THROW(missing.get(), DigraphException);
+}
+
+
+TEST(AsyncRouter_Tests, routesOnNumaReplicas)
+{
+    RoadMap roadMap;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        roadMap.addVertex(i, "Location");
+    }
+
+    roadMap.addEdge(0, 1, RoadSegment{1.0, 10.0});
+    roadMap.addEdge(1, 2, RoadSegment{1.0, 10.0});
+    roadMap.addEdge(0, 2, RoadSegment{2.5, 60.0});
+
+    // Two nodes sharing one CPU that every process can use, so pinning
+    // workers to either of them always works.
+    int cpu = NumaTopology::detect().cpusOf(0).front();
+    NumaReplicas<RoadMap> replicas{NumaTopology{{{cpu}, {cpu}}}, [&]() { return roadMap.detachedCopy(); }};
+
+    AsyncRouter router{replicas, 2};
+    ASSERT_EQ((std::vector<int>{0, 2}), router.submit(Trip{0, 2, TripMetric::Time}).get().vertices);
+    ASSERT_EQ((std::vector<int>{0, 1, 2}), router.submit(Trip{0, 2, TripMetric::Distance}).get().vertices);
+}
+
+
+TEST(AsyncRouter_Tests, obeysTurnTable)
+{
+    RoadMap roadMap;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        roadMap.addVertex(i, "Location");
+    }
+
+    roadMap.addEdge(0, 1, RoadSegment{1.0, 10.0});
+    roadMap.addEdge(1, 2, RoadSegment{1.0, 10.0});
+    roadMap.addEdge(0, 2, RoadSegment{2.5, 60.0});
+
+    TurnTable turns{{TurnRule{0, 1, 2, std::numeric_limits<float>::infinity()}}};
+    AsyncRouter router{roadMap, turns, 2};
+
+    ASSERT_EQ((std::vector<int>{0, 2}), router.submit(Trip{0, 2, TripMetric::Distance}).get().vertices);
+    ASSERT_EQ((std::vector<int>{0, 1}), router.submit(Trip{0, 1, TripMetric::Distance}).get().vertices);
+}
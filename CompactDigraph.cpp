@@ -0,0 +1,108 @@
+// CompactDigraph.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include "CompactDigraph.hpp"
+
+
+CompactDigraph::CompactDigraph()
+    : offsets_(1, 0)
+{
+}
+
+
+int CompactDigraph::indexOf(int vertex) const
+{
+    auto found = std::lower_bound(vertexNumbers_.begin(), vertexNumbers_.end(), vertex);
+
+    if (found == vertexNumbers_.end() || *found != vertex)
+    {
+        throw DigraphException("No appropriate vertex found!");
+    }
+
+    return static_cast<int>(found - vertexNumbers_.begin());
+}
+
+
+CompactDigraph CompactDigraph::reversed() const
+{
+    CompactDigraph result;
+    result.vertexNumbers_ = vertexNumbers_;
+
+    std::vector<std::pair<std::pair<int, int>, double>> edges;
+    edges.reserve(targets_.size());
+
+    for (int i = 0; i < vertexCount(); ++i)
+    {
+        for (std::size_t e = offsets_[i]; e < offsets_[i + 1]; ++e)
+        {
+            edges.push_back({{targets_[e], i}, weights_[e]});
+        }
+    }
+
+    result.fromEdges(edges, usesHugePages());
+    return result;
+}
+
+
+void CompactDigraph::findDistances(int startIndex, std::vector<double>& distances, std::vector<int>& parents) const
+{
+    findDistances(std::vector<int>{startIndex}, distances, parents, [](int) { return false; });
+}
+
+
+std::map<int, int> CompactDigraph::predecessorMap(const std::vector<int>& parents) const
+{
+    std::map<int, int> returnValue;
+
+    for (int i = 0; i < vertexCount(); ++i)
+    {
+        int parent = parents[i] < 0 ? i : parents[i];
+        returnValue.emplace_hint(returnValue.end(), vertexNumbers_[i], vertexNumbers_[parent]);
+    }
+
+    return returnValue;
+}
+
+
+MemoryFootprint CompactDigraph::memoryFootprint() const
+{
+    MemoryFootprint footprint;
+    footprint.add("vertex numbers", sizeof(*this) + heapBytes(vertexNumbers_));
+    footprint.add("edge offsets", heapBytes(offsets_));
+    footprint.add("edge targets", heapBytes(targets_));
+    footprint.add("edge weights", heapBytes(weights_));
+
+    return footprint;
+}
+
+
+void CompactDigraph::fromEdges(std::vector<std::pair<std::pair<int, int>, double>>& edges, bool hugePages)
+{
+    // A stable sort keeps each vertex's edges in the order the Digraph
+    // listed them.
+    std::stable_sort(
+        edges.begin(), edges.end(),
+        [](const auto& a, const auto& b) { return a.first.first < b.first.first; });
+
+    offsets_ = HugePageVector<std::size_t>(vertexNumbers_.size() + 1, 0, HugePageAllocator<std::size_t>{hugePages});
+    targets_ = HugePageVector<int>(HugePageAllocator<int>{hugePages});
+    weights_ = HugePageVector<double>(HugePageAllocator<double>{hugePages});
+    targets_.reserve(edges.size());
+    weights_.reserve(edges.size());
+
+    for (const auto& edge : edges)
+    {
+        offsets_[edge.first.first + 1]++;
+        targets_.push_back(edge.first.second);
+        weights_.push_back(edge.second);
+    }
+
+    for (std::size_t i = 1; i < offsets_.size(); ++i)
+    {
+        offsets_[i] += offsets_[i - 1];
+    }
+}
+
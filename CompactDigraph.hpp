@@ -0,0 +1,245 @@
+// CompactDigraph.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A CompactDigraph is a read-only snapshot of a Digraph laid out for fast
+// searching.  Vertices are renumbered densely as indexes 0..n-1 (in order
+// of their vertex numbers), and the outgoing edges of all vertices are
+// stored back to back in flat arrays, with each edge's weight computed
+// once up front by an edge weight function, the same kind of function
+// passed to Digraph::findShortestPaths().  The outgoing edges of index i
+// are the edges numbered firstEdge(i) up to (but not including)
+// firstEdge(i + 1).
+//
+// Searches that need many threads, or need to run over the same graph
+// many times, work on a CompactDigraph instead of on the Digraph itself.
+// On large graphs, the edge arrays can be backed by huge pages (see
+// HugePageAllocator.hpp), which cuts the TLB misses of searches that
+// wander all over them.
+
+#ifndef COMPACTDIGRAPH_HPP
+#define COMPACTDIGRAPH_HPP
+
+#include <cstddef>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+#include <utility>
+#include <vector>
+#include "Digraph.hpp"
+#include "HugePageAllocator.hpp"
+#include "MemoryFootprint.hpp"
+
+
+
+class CompactDigraph
+{
+public:
+    // Initializes an empty CompactDigraph.
+    CompactDigraph();
+
+    // Initializes a CompactDigraph from the current contents of the given
+    // Digraph, weighing each edge with the given function.  If hugePages
+    // is true, the edge arrays are backed by huge pages.
+    template <typename VertexInfo, typename EdgeInfo>
+    CompactDigraph(
+        const Digraph<VertexInfo, EdgeInfo>& digraph,
+        std::function<double(const EdgeInfo&)> edgeWeightFunc,
+        bool hugePages = false);
+
+    int vertexCount() const noexcept;
+    std::size_t edgeCount() const noexcept;
+
+    // indexOf() returns the dense index of the given vertex number.  If
+    // the vertex does not exist, a DigraphException is thrown instead.
+    int indexOf(int vertex) const;
+
+    // vertexAt() returns the vertex number of the given dense index.
+    int vertexAt(int index) const noexcept;
+
+    std::size_t firstEdge(int index) const noexcept;
+    int edgeTarget(std::size_t edge) const noexcept;
+    double edgeWeight(std::size_t edge) const noexcept;
+
+    // usesHugePages() returns true if the edge arrays are backed by huge
+    // pages.
+    bool usesHugePages() const noexcept;
+
+    // reversed() returns a CompactDigraph with the same vertices and
+    // every edge turned around, so that the outgoing edges of a vertex
+    // in the result are its incoming edges in this graph.  It uses huge
+    // pages if this one does.
+    CompactDigraph reversed() const;
+
+    // findDistances() runs Dijkstra's algorithm from the given dense
+    // index, filling in the distance to and parent index of every dense
+    // index.  Unreachable indexes are left at infinity and -1; the start
+    // index's parent is itself.
+    void findDistances(int startIndex, std::vector<double>& distances, std::vector<int>& parents) const;
+
+    // This overload of findDistances() is a multi-source search: every one
+    // of the given start indexes begins at distance 0, so each index ends
+    // up with its distance from the nearest of them, and following parents
+    // from it leads back to that one.  After each index is settled, it is
+    // passed to settled(), and the search stops early if that returns true;
+    // indexes not settled by then are left at infinity and -1.
+    template <typename SettledFunc>
+    void findDistances(
+        const std::vector<int>& startIndexes,
+        std::vector<double>& distances, std::vector<int>& parents,
+        SettledFunc settled) const;
+
+    // predecessorMap() converts a vector of parent indexes (one per dense
+    // index, with -1 or the index itself meaning "no predecessor") into
+    // the std::map form returned by Digraph::findShortestPaths().
+    std::map<int, int> predecessorMap(const std::vector<int>& parents) const;
+
+    // memoryFootprint() returns the bytes that this CompactDigraph
+    // occupies, one component per array.
+    MemoryFootprint memoryFootprint() const;
+
+private:
+    // fromEdges() builds the flat arrays from (fromIndex, toIndex, weight)
+    // triples, backing them with huge pages if hugePages is true.
+    void fromEdges(std::vector<std::pair<std::pair<int, int>, double>>& edges, bool hugePages);
+
+    std::vector<int> vertexNumbers_;
+    HugePageVector<std::size_t> offsets_;
+    HugePageVector<int> targets_;
+    HugePageVector<double> weights_;
+};
+
+
+
+template <typename VertexInfo, typename EdgeInfo>
+CompactDigraph::CompactDigraph(
+    const Digraph<VertexInfo, EdgeInfo>& digraph,
+    std::function<double(const EdgeInfo&)> edgeWeightFunc,
+    bool hugePages)
+    : vertexNumbers_{digraph.vertices()}
+{
+    std::vector<std::pair<std::pair<int, int>, double>> edges;
+    edges.reserve(digraph.edgeCount());
+
+    for (int i = 0; i < static_cast<int>(vertexNumbers_.size()); ++i)
+    {
+        digraph.forEachEdge(
+            vertexNumbers_[i],
+            [&](const DigraphEdge<EdgeInfo>& edge)
+            {
+                edges.push_back({{i, indexOf(edge.toVertex)}, edgeWeightFunc(edge.einfo)});
+            });
+    }
+
+    fromEdges(edges, hugePages);
+}
+
+
+
+template <typename SettledFunc>
+void CompactDigraph::findDistances(
+    const std::vector<int>& startIndexes,
+    std::vector<double>& distances, std::vector<int>& parents,
+    SettledFunc settled) const
+{
+    distances.assign(vertexNumbers_.size(), std::numeric_limits<double>::infinity());
+    parents.assign(vertexNumbers_.size(), -1);
+
+    // Distances and parents only become final once an index is settled;
+    // until then they're kept on the side, so that an early stop leaves
+    // nothing half-done in the results.
+    std::vector<double> tentative(vertexNumbers_.size(), std::numeric_limits<double>::infinity());
+    std::vector<int> tentativeParents(vertexNumbers_.size(), -1);
+
+    using Entry = std::pair<double, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> pq;
+
+    for (int startIndex : startIndexes)
+    {
+        tentative[startIndex] = 0.0;
+        tentativeParents[startIndex] = startIndex;
+        pq.push({0.0, startIndex});
+    }
+
+    while (!pq.empty())
+    {
+        Entry top = pq.top();
+        pq.pop();
+
+        if (parents[top.second] >= 0 || top.first > tentative[top.second])
+        {
+            continue;
+        }
+
+        distances[top.second] = top.first;
+        parents[top.second] = tentativeParents[top.second];
+
+        if (settled(top.second))
+        {
+            return;
+        }
+
+        for (std::size_t e = offsets_[top.second]; e < offsets_[top.second + 1]; ++e)
+        {
+            double candidate = top.first + weights_[e];
+
+            if (candidate < tentative[targets_[e]])
+            {
+                tentative[targets_[e]] = candidate;
+                tentativeParents[targets_[e]] = top.second;
+                pq.push({candidate, targets_[e]});
+            }
+        }
+    }
+}
+
+
+
+inline int CompactDigraph::vertexCount() const noexcept
+{
+    return static_cast<int>(vertexNumbers_.size());
+}
+
+
+inline std::size_t CompactDigraph::edgeCount() const noexcept
+{
+    return targets_.size();
+}
+
+
+inline bool CompactDigraph::usesHugePages() const noexcept
+{
+    return offsets_.get_allocator().hugePagesEnabled();
+}
+
+
+inline int CompactDigraph::vertexAt(int index) const noexcept
+{
+    return vertexNumbers_[index];
+}
+
+
+inline std::size_t CompactDigraph::firstEdge(int index) const noexcept
+{
+    return offsets_[index];
+}
+
+
+inline int CompactDigraph::edgeTarget(std::size_t edge) const noexcept
+{
+    return targets_[edge];
+}
+
+
+inline double CompactDigraph::edgeWeight(std::size_t edge) const noexcept
+{
+    return weights_[edge];
+}
+
+
+
+#endif
+
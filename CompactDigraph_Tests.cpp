@@ -0,0 +1,32 @@
+// CompactDigraph_Tests.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// Unit tests for CompactDigraph's storage options.  Its searches are
+// tested against Digraph's in Digraph_ShortestPathTests.cpp.
+
+#include <gtest/gtest.h>
+#include "CompactDigraph.hpp"
+#include "RoadMap.hpp"
+#include "TripPlanner.hpp"
+
+
+TEST(CompactDigraph_Tests, hugePagesCarryOverToReversedCopies)
+{
+    RoadMap roadMap;
+    roadMap.addVertex(0, "Location");
+    roadMap.addVertex(1, "Location");
+    roadMap.addEdge(0, 1, RoadSegment{1.0, 10.0});
+
+    auto weight = TripPlanner::edgeWeightFor(TripMetric::Distance);
+
+    CompactDigraph normal{roadMap, weight};
+    ASSERT_FALSE(normal.usesHugePages());
+    ASSERT_FALSE(normal.reversed().usesHugePages());
+
+    CompactDigraph huge{roadMap, weight, true};
+    ASSERT_TRUE(huge.usesHugePages());
+    ASSERT_TRUE(huge.reversed().usesHugePages());
+    ASSERT_EQ(1, huge.reversed().edgeCount());
+}
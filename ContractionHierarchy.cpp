@@ -0,0 +1,373 @@
+// ContractionHierarchy.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include "ContractionHierarchy.hpp"
+
+
+namespace
+{
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+
+    // Witness searches give up after settling this many vertices, in which
+    // case the shortcut is simply added; that's never wrong, only wasteful.
+    constexpr int witnessSettleLimit = 500;
+
+
+    struct Arc
+    {
+        int vertex;
+        double weight;
+    };
+
+
+    // A Contractor holds the shrinking graph while vertices are being
+    // contracted.  Contracted vertices are only marked, not removed, so
+    // by the end the adjacency lists hold every original edge and every
+    // shortcut, which is exactly what the hierarchy is built from.
+    class Contractor
+    {
+    public:
+        explicit Contractor(const CompactDigraph& graph)
+            : out_(graph.vertexCount()), in_(graph.vertexCount()),
+              contracted_(graph.vertexCount(), false),
+              contractedNeighbors_(graph.vertexCount(), 0),
+              distances_(graph.vertexCount(), infinity),
+              shortcutCount_{0}
+        {
+            for (int u = 0; u < graph.vertexCount(); ++u)
+            {
+                for (std::size_t e = graph.firstEdge(u); e < graph.firstEdge(u + 1); ++e)
+                {
+                    if (graph.edgeTarget(e) != u)
+                    {
+                        addArc(u, graph.edgeTarget(e), graph.edgeWeight(e));
+                    }
+                }
+            }
+        }
+
+        // priority() estimates how costly contracting a vertex now would
+        // be: the shortcuts it would add, less the edges it would remove,
+        // plus a term that spreads contraction evenly across the graph.
+        int priority(int v)
+        {
+            int removed = 0;
+
+            for (const Arc& arc : in_[v])
+            {
+                removed += contracted_[arc.vertex] ? 0 : 1;
+            }
+
+            for (const Arc& arc : out_[v])
+            {
+                removed += contracted_[arc.vertex] ? 0 : 1;
+            }
+
+            return contract(v, false) - removed + contractedNeighbors_[v];
+        }
+
+        // contract() works out which shortcuts are needed to contract the
+        // given vertex and returns how many there are; when apply is true,
+        // it also adds them and marks the vertex as contracted.
+        int contract(int v, bool apply)
+        {
+            int shortcuts = 0;
+
+            for (std::size_t i = 0; i < in_[v].size(); ++i)
+            {
+                Arc from = in_[v][i];
+
+                if (contracted_[from.vertex])
+                {
+                    continue;
+                }
+
+                double maxWeight = -infinity;
+
+                for (const Arc& to : out_[v])
+                {
+                    if (!contracted_[to.vertex] && to.vertex != from.vertex)
+                    {
+                        maxWeight = std::max(maxWeight, from.weight + to.weight);
+                    }
+                }
+
+                if (maxWeight < 0.0)
+                {
+                    continue;
+                }
+
+                witnessSearch(from.vertex, v, maxWeight);
+
+                for (std::size_t j = 0; j < out_[v].size(); ++j)
+                {
+                    Arc to = out_[v][j];
+
+                    if (contracted_[to.vertex] || to.vertex == from.vertex)
+                    {
+                        continue;
+                    }
+
+                    double weight = from.weight + to.weight;
+
+                    if (distances_[to.vertex] > weight)
+                    {
+                        shortcuts++;
+
+                        if (apply && addArc(from.vertex, to.vertex, weight))
+                        {
+                            shortcutCount_++;
+                        }
+                    }
+                }
+
+                clearWitnessSearch();
+            }
+
+            if (apply)
+            {
+                contracted_[v] = true;
+
+                for (const Arc& arc : in_[v])
+                {
+                    contractedNeighbors_[arc.vertex]++;
+                }
+
+                for (const Arc& arc : out_[v])
+                {
+                    contractedNeighbors_[arc.vertex]++;
+                }
+            }
+
+            return shortcuts;
+        }
+
+        const std::vector<Arc>& outgoing(int v) const noexcept
+        {
+            return out_[v];
+        }
+
+        std::size_t shortcutCount() const noexcept
+        {
+            return shortcutCount_;
+        }
+
+    private:
+        // addArc() adds an edge, or lowers the weight of an existing one;
+        // it returns true if a new edge was added.
+        bool addArc(int u, int w, double weight)
+        {
+            for (Arc& arc : out_[u])
+            {
+                if (arc.vertex == w)
+                {
+                    if (weight < arc.weight)
+                    {
+                        arc.weight = weight;
+
+                        for (Arc& back : in_[w])
+                        {
+                            if (back.vertex == u)
+                            {
+                                back.weight = weight;
+                            }
+                        }
+                    }
+
+                    return false;
+                }
+            }
+
+            out_[u].push_back(Arc{w, weight});
+            in_[w].push_back(Arc{u, weight});
+            return true;
+        }
+
+        // witnessSearch() runs a bounded Dijkstra search from the given
+        // vertex through the uncontracted graph, avoiding the vertex that
+        // is about to be contracted, leaving its results in distances_.
+        void witnessSearch(int start, int avoid, double maxWeight)
+        {
+            using Entry = std::pair<double, int>;
+            std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> pq;
+
+            distances_[start] = 0.0;
+            touched_.push_back(start);
+            pq.push({0.0, start});
+
+            int settled = 0;
+
+            while (!pq.empty() && settled < witnessSettleLimit)
+            {
+                Entry top = pq.top();
+                pq.pop();
+
+                if (top.first > distances_[top.second])
+                {
+                    continue;
+                }
+
+                if (top.first > maxWeight)
+                {
+                    break;
+                }
+
+                settled++;
+
+                for (const Arc& arc : out_[top.second])
+                {
+                    if (arc.vertex == avoid || contracted_[arc.vertex])
+                    {
+                        continue;
+                    }
+
+                    double candidate = top.first + arc.weight;
+
+                    if (candidate < distances_[arc.vertex])
+                    {
+                        if (distances_[arc.vertex] == infinity)
+                        {
+                            touched_.push_back(arc.vertex);
+                        }
+
+                        distances_[arc.vertex] = candidate;
+                        pq.push({candidate, arc.vertex});
+                    }
+                }
+            }
+        }
+
+        void clearWitnessSearch()
+        {
+            for (int v : touched_)
+            {
+                distances_[v] = infinity;
+            }
+
+            touched_.clear();
+        }
+
+        std::vector<std::vector<Arc>> out_;
+        std::vector<std::vector<Arc>> in_;
+        std::vector<bool> contracted_;
+        std::vector<int> contractedNeighbors_;
+
+        std::vector<double> distances_;
+        std::vector<int> touched_;
+
+        std::size_t shortcutCount_;
+    };
+}
+
+
+ContractionHierarchy::ContractionHierarchy(const CompactDigraph& graph)
+    : positions_(graph.vertexCount()), indexes_(graph.vertexCount()), shortcutCount_{0}
+{
+    const int n = graph.vertexCount();
+    Contractor contractor{graph};
+
+    // Vertices are contracted in order of priority, with priorities only
+    // recomputed when a vertex reaches the top of the queue; if it's no
+    // longer the cheapest, it goes back in with its new priority.
+    using Entry = std::pair<int, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> pq;
+
+    for (int v = 0; v < n; ++v)
+    {
+        pq.push({contractor.priority(v), v});
+    }
+
+    int rank = 0;
+
+    while (!pq.empty())
+    {
+        int v = pq.top().second;
+        pq.pop();
+
+        int current = contractor.priority(v);
+
+        if (!pq.empty() && current > pq.top().first)
+        {
+            pq.push({current, v});
+            continue;
+        }
+
+        contractor.contract(v, true);
+
+        // The highest rank ends up at sweep position 0.
+        positions_[v] = n - 1 - rank;
+        indexes_[n - 1 - rank] = v;
+        rank++;
+    }
+
+    shortcutCount_ = contractor.shortcutCount();
+
+    // Every edge, original or shortcut, either climbs to a higher-ranked
+    // vertex (a lower position) and belongs to the upward search, or
+    // descends to a lower-ranked one and belongs to the downward sweep.
+    std::vector<std::vector<Arc>> up(n);
+    std::vector<std::vector<Arc>> down(n);
+
+    for (int u = 0; u < n; ++u)
+    {
+        for (const Arc& arc : contractor.outgoing(u))
+        {
+            int from = positions_[u];
+            int to = positions_[arc.vertex];
+
+            if (to < from)
+            {
+                up[from].push_back(Arc{to, arc.weight});
+            }
+            else
+            {
+                down[to].push_back(Arc{from, arc.weight});
+            }
+        }
+    }
+
+    upOffsets_.assign(1, 0);
+    downOffsets_.assign(1, 0);
+
+    for (int position = 0; position < n; ++position)
+    {
+        for (const Arc& arc : up[position])
+        {
+            upTargets_.push_back(arc.vertex);
+            upWeights_.push_back(arc.weight);
+        }
+
+        // Sorting each vertex's incoming downward edges by source keeps
+        // the sweep's reads moving forward through memory.
+        std::sort(
+            down[position].begin(), down[position].end(),
+            [](const Arc& a, const Arc& b) { return a.vertex < b.vertex; });
+
+        for (const Arc& arc : down[position])
+        {
+            downSources_.push_back(arc.vertex);
+            downWeights_.push_back(arc.weight);
+        }
+
+        upOffsets_.push_back(upTargets_.size());
+        downOffsets_.push_back(downSources_.size());
+    }
+}
+
+
+MemoryFootprint ContractionHierarchy::memoryFootprint() const
+{
+    MemoryFootprint footprint;
+    footprint.add("sweep order", sizeof(*this) + heapBytes(positions_) + heapBytes(indexes_));
+    footprint.add("upward edges", heapBytes(upOffsets_) + heapBytes(upTargets_) + heapBytes(upWeights_));
+    footprint.add("downward edges", heapBytes(downOffsets_) + heapBytes(downSources_) + heapBytes(downWeights_));
+
+    return footprint;
+}
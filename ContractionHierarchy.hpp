@@ -0,0 +1,142 @@
+// ContractionHierarchy.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A ContractionHierarchy is a preprocessed form of a CompactDigraph that
+// makes repeated searches over the same graph much cheaper.  Vertices are
+// "contracted" one at a time, least important first; contracting a vertex
+// removes it from the remaining graph, adding a shortcut edge between two
+// of its neighbors whenever the path through it was the only shortest way
+// between them.  Each vertex's rank is its position in that order.
+//
+// Afterward, every shortest path in the original graph has a counterpart
+// that first climbs only to higher-ranked vertices and then descends only
+// to lower-ranked ones.  The hierarchy stores the edges needed for both
+// halves, with vertices laid out in decreasing rank order (their "sweep
+// position"), which is the order a Phast sweep visits them in.
+
+#ifndef CONTRACTIONHIERARCHY_HPP
+#define CONTRACTIONHIERARCHY_HPP
+
+#include <cstddef>
+#include <vector>
+#include "CompactDigraph.hpp"
+#include "MemoryFootprint.hpp"
+
+
+
+class ContractionHierarchy
+{
+public:
+    // Initializes a ContractionHierarchy by contracting every vertex of
+    // the given CompactDigraph.
+    explicit ContractionHierarchy(const CompactDigraph& graph);
+
+    int vertexCount() const noexcept;
+
+    // shortcutCount() returns how many shortcut edges were added.
+    std::size_t shortcutCount() const noexcept;
+
+    // positionOf() returns the sweep position of the given dense index
+    // of the original CompactDigraph; indexAt() does the reverse.  The
+    // highest-ranked vertex is at position 0.
+    int positionOf(int index) const noexcept;
+    int indexAt(int position) const noexcept;
+
+    // The upward edges leaving the vertex at a sweep position, which all
+    // lead to lower positions (i.e., higher ranks), are numbered from
+    // firstUpEdge(position) up to firstUpEdge(position + 1).
+    std::size_t firstUpEdge(int position) const noexcept;
+    int upEdgeTarget(std::size_t edge) const noexcept;
+    double upEdgeWeight(std::size_t edge) const noexcept;
+
+    // The downward edges arriving at the vertex at a sweep position, which
+    // all come from lower positions, are numbered from
+    // firstDownEdge(position) up to firstDownEdge(position + 1).
+    std::size_t firstDownEdge(int position) const noexcept;
+    int downEdgeSource(std::size_t edge) const noexcept;
+    double downEdgeWeight(std::size_t edge) const noexcept;
+
+    // memoryFootprint() returns the bytes that this ContractionHierarchy
+    // occupies: its sweep order, upward edges, and downward edges.
+    MemoryFootprint memoryFootprint() const;
+
+private:
+    std::vector<int> positions_;
+    std::vector<int> indexes_;
+    std::size_t shortcutCount_;
+
+    std::vector<std::size_t> upOffsets_;
+    std::vector<int> upTargets_;
+    std::vector<double> upWeights_;
+
+    std::vector<std::size_t> downOffsets_;
+    std::vector<int> downSources_;
+    std::vector<double> downWeights_;
+};
+
+
+
+inline int ContractionHierarchy::vertexCount() const noexcept
+{
+    return static_cast<int>(indexes_.size());
+}
+
+
+inline std::size_t ContractionHierarchy::shortcutCount() const noexcept
+{
+    return shortcutCount_;
+}
+
+
+inline int ContractionHierarchy::positionOf(int index) const noexcept
+{
+    return positions_[index];
+}
+
+
+inline int ContractionHierarchy::indexAt(int position) const noexcept
+{
+    return indexes_[position];
+}
+
+
+inline std::size_t ContractionHierarchy::firstUpEdge(int position) const noexcept
+{
+    return upOffsets_[position];
+}
+
+
+inline int ContractionHierarchy::upEdgeTarget(std::size_t edge) const noexcept
+{
+    return upTargets_[edge];
+}
+
+
+inline double ContractionHierarchy::upEdgeWeight(std::size_t edge) const noexcept
+{
+    return upWeights_[edge];
+}
+
+
+inline std::size_t ContractionHierarchy::firstDownEdge(int position) const noexcept
+{
+    return downOffsets_[position];
+}
+
+
+inline int ContractionHierarchy::downEdgeSource(std::size_t edge) const noexcept
+{
+    return downSources_[edge];
+}
+
+
+inline double ContractionHierarchy::downEdgeWeight(std::size_t edge) const noexcept
+{
+    return downWeights_[edge];
+}
+
+
+
+#endif
@@ -0,0 +1,377 @@
+// DeltaStepping.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include "DeltaStepping.hpp"
+
+
+namespace
+{
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+
+
+    // A PhaseTeam is a fixed set of threads that repeatedly run one phase
+    // of work together.  run() hands the same function to every thread
+    // (the calling thread being thread 0) and returns once all of them
+    // have finished it, so the search can do its bookkeeping between
+    // phases without starting new threads each time.
+    class PhaseTeam
+    {
+    public:
+        explicit PhaseTeam(unsigned int threadCount)
+            : threadCount_{threadCount}, generation_{0}, running_{0}, stopping_{false}
+        {
+            for (unsigned int i = 1; i < threadCount_; ++i)
+            {
+                helpers_.emplace_back([this, i]() { help(i); });
+            }
+        }
+
+        ~PhaseTeam() noexcept
+        {
+            {
+                std::lock_guard<std::mutex> lock{mutex_};
+                stopping_ = true;
+            }
+
+            started_.notify_all();
+
+            for (std::thread& helper : helpers_)
+            {
+                helper.join();
+            }
+        }
+
+        unsigned int threadCount() const noexcept
+        {
+            return threadCount_;
+        }
+
+        void run(const std::function<void(unsigned int)>& work)
+        {
+            if (threadCount_ > 1)
+            {
+                std::lock_guard<std::mutex> lock{mutex_};
+                work_ = &work;
+                running_ = threadCount_ - 1;
+                generation_++;
+            }
+
+            started_.notify_all();
+            work(0);
+
+            std::unique_lock<std::mutex> lock{mutex_};
+            finished_.wait(lock, [this]() { return running_ == 0; });
+        }
+
+    private:
+        void help(unsigned int threadIndex)
+        {
+            unsigned long seen = 0;
+
+            while (true)
+            {
+                const std::function<void(unsigned int)>* work;
+
+                {
+                    std::unique_lock<std::mutex> lock{mutex_};
+                    started_.wait(lock, [&]() { return stopping_ || generation_ != seen; });
+
+                    if (stopping_)
+                    {
+                        return;
+                    }
+
+                    seen = generation_;
+                    work = work_;
+                }
+
+                (*work)(threadIndex);
+
+                std::lock_guard<std::mutex> lock{mutex_};
+
+                if (--running_ == 0)
+                {
+                    finished_.notify_all();
+                }
+            }
+        }
+
+        unsigned int threadCount_;
+        std::vector<std::thread> helpers_;
+
+        std::mutex mutex_;
+        std::condition_variable started_;
+        std::condition_variable finished_;
+        const std::function<void(unsigned int)>* work_;
+        unsigned long generation_;
+        unsigned int running_;
+        bool stopping_;
+    };
+
+
+    // relaxTo() lowers the distance of the given vertex to the given one
+    // if that's an improvement, returning true if it was.
+    bool relaxTo(std::atomic<double>& distance, double candidate)
+    {
+        double current = distance.load(std::memory_order_relaxed);
+
+        while (candidate < current)
+        {
+            if (distance.compare_exchange_weak(current, candidate, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+
+    // slice() returns the part of [0, size) that the given thread handles.
+    std::pair<std::size_t, std::size_t> slice(std::size_t size, unsigned int threadIndex, unsigned int threadCount)
+    {
+        return {size * threadIndex / threadCount, size * (threadIndex + 1) / threadCount};
+    }
+}
+
+
+DeltaStepping::DeltaStepping(double bucketWidth, unsigned int threadCount)
+    : bucketWidth_{bucketWidth}, threadCount_{threadCount}
+{
+    if (!(bucketWidth_ > 0.0))
+    {
+        throw std::invalid_argument{"Delta-stepping bucket width must be positive"};
+    }
+
+    if (threadCount_ == 0)
+    {
+        threadCount_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+
+std::map<int, int> DeltaStepping::findShortestPaths(const CompactDigraph& graph, int startVertex) const
+{
+    std::vector<double> distances;
+    std::vector<int> parents;
+
+    findDistances(graph, graph.indexOf(startVertex), distances, parents);
+
+    return graph.predecessorMap(parents);
+}
+
+
+void DeltaStepping::findDistances(
+    const CompactDigraph& graph, int startIndex,
+    std::vector<double>& distances, std::vector<int>& parents) const
+{
+    const std::size_t n = static_cast<std::size_t>(graph.vertexCount());
+    const double delta = bucketWidth_;
+
+    PhaseTeam team{threadCount_};
+
+    std::vector<std::atomic<double>> d(n);
+
+    for (std::atomic<double>& distance : d)
+    {
+        distance.store(infinity, std::memory_order_relaxed);
+    }
+
+    d[startIndex].store(0.0, std::memory_order_relaxed);
+
+    // No relaxation can land more than ceil(maxWeight / delta) buckets
+    // past the one being expanded, so only that many buckets beyond it
+    // are ever in use at once; they're kept in a ring, bucket b in slot
+    // b % ringSize, with one slot to spare for rounding.  The numbers of
+    // the non-empty buckets are kept in order, so the search can jump
+    // straight to the next one rather than stepping through empty ones.
+    double maxWeight = 0.0;
+
+    for (std::size_t e = 0; e < graph.edgeCount(); ++e)
+    {
+        double w = graph.edgeWeight(e);
+
+        if (w < infinity)
+        {
+            maxWeight = std::max(maxWeight, w);
+        }
+    }
+
+    const std::size_t ringSize = static_cast<std::size_t>(std::ceil(maxWeight / delta)) + 2;
+
+    // Each thread collects the (bucket, vertex) pairs it improved during
+    // a phase; they're merged into the shared buckets between phases, so
+    // the buckets themselves never need a lock.
+    std::vector<std::vector<std::pair<std::size_t, int>>> improved(team.threadCount());
+    std::vector<std::vector<int>> buckets(ringSize);
+    std::set<std::size_t> occupied{0};
+
+    buckets[0].push_back(startIndex);
+
+    auto bucketOf = [delta](double distance)
+    {
+        return static_cast<std::size_t>(distance / delta);
+    };
+
+    auto mergeImproved = [&]()
+    {
+        for (auto& local : improved)
+        {
+            for (const std::pair<std::size_t, int>& entry : local)
+            {
+                std::vector<int>& bucket = buckets[entry.first % ringSize];
+
+                if (bucket.empty())
+                {
+                    occupied.insert(entry.first);
+                }
+
+                bucket.push_back(entry.second);
+            }
+
+            local.clear();
+        }
+    };
+
+    auto relaxEdges = [&](const std::vector<int>& vertices, bool light)
+    {
+        team.run(
+            [&](unsigned int threadIndex)
+            {
+                auto range = slice(vertices.size(), threadIndex, team.threadCount());
+
+                for (std::size_t i = range.first; i < range.second; ++i)
+                {
+                    int u = vertices[i];
+                    double du = d[u].load(std::memory_order_relaxed);
+
+                    for (std::size_t e = graph.firstEdge(u); e < graph.firstEdge(u + 1); ++e)
+                    {
+                        double w = graph.edgeWeight(e);
+
+                        if ((w <= delta) != light)
+                        {
+                            continue;
+                        }
+
+                        int v = graph.edgeTarget(e);
+
+                        if (relaxTo(d[v], du + w))
+                        {
+                            improved[threadIndex].emplace_back(bucketOf(du + w), v);
+                        }
+                    }
+                }
+            });
+
+        mergeImproved();
+    };
+
+    std::vector<std::size_t> queuedIn(n, std::numeric_limits<std::size_t>::max());
+    std::vector<std::size_t> settledIn(n, std::numeric_limits<std::size_t>::max());
+    std::vector<int> frontier;
+    std::vector<int> settled;
+    std::size_t pass = 0;
+
+    while (!occupied.empty())
+    {
+        std::size_t current = *occupied.begin();
+        std::vector<int>& bucket = buckets[current % ringSize];
+        settled.clear();
+
+        while (!bucket.empty())
+        {
+            // A vertex can be listed in a bucket more than once, or in a
+            // bucket it has since improved its way out of; only the
+            // entries that still match its distance are expanded.
+            frontier.clear();
+            pass++;
+
+            for (int v : bucket)
+            {
+                if (queuedIn[v] != pass && bucketOf(d[v].load(std::memory_order_relaxed)) == current)
+                {
+                    queuedIn[v] = pass;
+                    frontier.push_back(v);
+
+                    if (settledIn[v] != current)
+                    {
+                        settledIn[v] = current;
+                        settled.push_back(v);
+                    }
+                }
+            }
+
+            bucket.clear();
+            relaxEdges(frontier, true);
+        }
+
+        // Heavy edges always lead past the current bucket, so it can be
+        // retired before they're relaxed.
+        occupied.erase(current);
+        relaxEdges(settled, false);
+    }
+
+    // Parents are chosen after the fact, since a vertex's distance and
+    // parent can't be updated together atomically: any neighbor whose
+    // distance plus edge weight exactly reproduces a vertex's distance is
+    // a parent that some shortest path actually uses.  Zero-weight edges
+    // can make two neighbors parents of each other that way, so a
+    // neighbor at the same distance only counts if its last expansion
+    // came before the vertex's; the one whose expansion set the vertex's
+    // distance always does, and parents can then never form a cycle.
+    std::vector<std::atomic<int>> p(n);
+
+    for (std::atomic<int>& parent : p)
+    {
+        parent.store(-1, std::memory_order_relaxed);
+    }
+
+    team.run(
+        [&](unsigned int threadIndex)
+        {
+            auto range = slice(n, threadIndex, team.threadCount());
+
+            for (std::size_t u = range.first; u < range.second; ++u)
+            {
+                double du = d[u].load(std::memory_order_relaxed);
+
+                for (std::size_t e = graph.firstEdge(static_cast<int>(u)); e < graph.firstEdge(static_cast<int>(u) + 1); ++e)
+                {
+                    int v = graph.edgeTarget(e);
+
+                    double dv = d[v].load(std::memory_order_relaxed);
+
+                    if (v != startIndex && du + graph.edgeWeight(e) == dv
+                        && (du < dv || queuedIn[u] < queuedIn[v]))
+                    {
+                        p[v].store(static_cast<int>(u), std::memory_order_relaxed);
+                    }
+                }
+            }
+        });
+
+    distances.resize(n);
+    parents.resize(n);
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        distances[i] = d[i].load(std::memory_order_relaxed);
+        parents[i] = p[i].load(std::memory_order_relaxed);
+    }
+
+    parents[startIndex] = startIndex;
+}
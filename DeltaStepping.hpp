@@ -0,0 +1,64 @@
+// DeltaStepping.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// DeltaStepping is a parallel version of the one-to-all search done by
+// Digraph::findShortestPaths(), for when the whole shortest path tree is
+// actually needed (coverage maps, analytics, and so on).  It uses the
+// delta-stepping algorithm: tentative distances are sorted into buckets
+// of width delta rather than into a priority queue, and all the vertices
+// in the lowest non-empty bucket are expanded at once, spread across a
+// fixed number of threads.  Edges no heavier than delta ("light" edges)
+// can put vertices back into the current bucket, so a bucket is expanded
+// repeatedly until it stays empty; "heavy" edges are relaxed once, after
+// the bucket is done.
+//
+// A small delta does little wasted work but offers less parallelism; a
+// large one does the reverse.  Something near the average edge weight is
+// a reasonable place to start.  Only ceil(heaviest edge / delta) + 2
+// buckets are kept, reused in a ring, and empty ones are skipped without
+// being visited, so a small delta doesn't cost memory in proportion to
+// the longest distance.  Edge weights must not be negative.
+
+#ifndef DELTASTEPPING_HPP
+#define DELTASTEPPING_HPP
+
+#include <map>
+#include <vector>
+#include "CompactDigraph.hpp"
+
+
+
+class DeltaStepping
+{
+public:
+    // Initializes a DeltaStepping search with the given bucket width and
+    // number of threads (a threadCount of 0 means one thread per core).
+    // A bucket width that isn't positive causes a std::invalid_argument
+    // to be thrown instead.
+    DeltaStepping(double bucketWidth, unsigned int threadCount);
+
+    // findShortestPaths() returns the same result that the Digraph from
+    // which the given CompactDigraph was built would have returned from
+    // findShortestPaths(startVertex, ...), using the same edge weights.
+    // If the start vertex does not exist, a DigraphException is thrown
+    // instead.
+    std::map<int, int> findShortestPaths(const CompactDigraph& graph, int startVertex) const;
+
+    // findDistances() does the same search from the given dense index,
+    // filling in the distance to and parent index of each dense index.
+    // Unreachable indexes are left at infinity and -1; the start index's
+    // parent is itself.
+    void findDistances(
+        const CompactDigraph& graph, int startIndex,
+        std::vector<double>& distances, std::vector<int>& parents) const;
+
+private:
+    double bucketWidth_;
+    unsigned int threadCount_;
+};
+
+
+
+#endif
@@ -20,6 +20,7 @@
 #ifndef DIGRAPH_HPP
 #define DIGRAPH_HPP
 
+#include <algorithm>
 #include <exception>
 #include <functional>
 #include <list>
@@ -27,7 +28,14 @@
 #include <utility>
 #include <vector>
 #include <queue>
+#include <set>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include "MemoryFootprint.hpp"
+#include "PersistentVertexTable.hpp"
+#include "SearchStats.hpp"
 
 // DigraphExceptions are thrown from some of the member functions in the
 // Digraph class template, so that exception is declared here, so it
@@ -63,15 +71,34 @@ struct DigraphEdge
 
 
 
-// A DigraphVertex includes two things: a VertexInfo object and a list of
-// its outgoing edges.  Because different kinds of Digraphs store different
-// kinds of vertex and edge information, DigraphVertex is a struct template.
+// A DigraphVertex includes three things: a VertexInfo object, a list of
+// its outgoing edges, and the vertex numbers of the vertices with an edge
+// pointing to it, which is what lets a vertex's incoming edges be found
+// without searching the whole graph.  Because different kinds of Digraphs
+// store different kinds of vertex and edge information, DigraphVertex is
+// a struct template.
 
 template <typename VertexInfo, typename EdgeInfo>
 struct DigraphVertex
 {
     VertexInfo vinfo;
     std::list<DigraphEdge<EdgeInfo>> edges;
+    std::vector<int> incoming = {};
+};
+
+
+
+// A DigraphReachableSet is the result of a bounded search: every vertex
+// reachable from the start vertex within some budget, along with the cost
+// of reaching it and its predecessor on the way there, plus the edges that
+// the boundary of the budget cuts across (those leaving a reachable vertex
+// whose far end can't be reached within the budget along that edge).
+
+struct DigraphReachableSet
+{
+    std::map<int, double> costs;
+    std::map<int, int> predecessors;
+    std::vector<std::pair<int, int>> frontier;
 };
 
 
@@ -99,7 +126,10 @@ public:
 
     // The copy constructor initializes a new Digraph to be a deep copy
     // of another one (i.e., any change to the copy will not affect the
-    // original).
+    // original).  The two share their vertices and edges until one of
+    // them changes, so copying takes constant time, and a change only
+    // copies the vertex it touches (see PersistentVertexTable.hpp); any
+    // number of copies can therefore be kept around as cheap snapshots.
     Digraph(const Digraph& d);
 
     // The move constructor initializes a new Digraph from an expiring one.
@@ -111,13 +141,21 @@ public:
     // The assignment operator assigns the contents of the given Digraph
     // into "this" Digraph, with "this" Digraph becoming a separate, deep
     // copy of the contents of the given one (i.e., any change made to
-    // "this" Digraph afterward will not affect the other).
+    // "this" Digraph afterward will not affect the other).  Like the copy
+    // constructor, it takes constant time.
     Digraph& operator=(const Digraph& d);
 
     // The move assignment operator assigns the contents of an expiring
     // Digraph into "this" Digraph.
     Digraph& operator=(Digraph&& d) noexcept;
 
+    // detachedCopy() returns a copy of this Digraph that shares none of
+    // its storage, all of it freshly allocated by the calling thread, in
+    // time proportional to the size of the Digraph.  It's meant for when
+    // it matters where the memory lives (e.g., to keep a replica on each
+    // NUMA node); otherwise, the copy constructor is far cheaper.
+    Digraph detachedCopy() const;
+
     // vertices() returns a std::vector containing the vertex numbers of
     // every vertex in this Digraph.
     std::vector<int> vertices() const;
@@ -134,6 +172,14 @@ public:
     // not exist, a DigraphException is thrown instead.
     std::vector<std::pair<int, int>> edges(int vertex) const;
 
+    // forEachEdge() calls the given function once for each edge outgoing
+    // from the given vertex number, passing it the DigraphEdge itself, so
+    // callers can look at every edge's EdgeInfo without copying it or
+    // searching for it again.  If the given vertex does not exist, a
+    // DigraphException is thrown instead.
+    template <typename EdgeFunc>
+    void forEachEdge(int vertex, EdgeFunc edgeFunc) const;
+
     // vertexInfo() returns the VertexInfo object belonging to the vertex
     // with the given vertex number.  If that vertex does not exist, a
     // DigraphException is thrown instead.
@@ -145,6 +191,14 @@ public:
     // DigraphException is thrown instead.
     EdgeInfo edgeInfo(int fromVertex, int toVertex) const;
 
+    // findVertexInfo() and findEdgeInfo() are like vertexInfo() and
+    // edgeInfo(), except that they return a pointer to the object stored
+    // in the Digraph, rather than a copy of it, or nullptr if the vertex
+    // or edge does not exist.  The pointer is good until that vertex or
+    // edge is removed.
+    const VertexInfo* findVertexInfo(int vertex) const;
+    const EdgeInfo* findEdgeInfo(int fromVertex, int toVertex) const;
+
     // addVertex() adds a vertex to the Digraph with the given vertex
     // number and VertexInfo object.  If there is already a vertex in
     // the graph with the given vertex number, a DigraphException is
@@ -160,10 +214,17 @@ public:
 
     // removeVertex() removes the vertex (and all of its incoming
     // and outgoing edges) with the given vertex number from the
-    // Digraph.  If the vertex does not exist already, a DigraphException
+    // Digraph, in time proportional to the number of those edges.
+    // If the vertex does not exist already, a DigraphException
     // is thrown instead.
     void removeVertex(int vertex);
 
+    // removeVertices() removes every one of the given vertices, along with
+    // their incoming and outgoing edges (e.g., to close a whole area at
+    // once).  If any of them does not exist, a DigraphException is thrown
+    // instead, and nothing is removed.
+    void removeVertices(const std::vector<int>& vertices);
+
     // removeEdge() removes the edge pointing from the given "from"
     // vertex number to the given "to" vertex number from the Digraph.
     // If either of these vertices does not exist *or* if the edge
@@ -171,6 +232,13 @@ public:
     // thrown instead.
     void removeEdge(int fromVertex, int toVertex);
 
+    // updateEdge() replaces, in place, the EdgeInfo object associated
+    // with the edge pointing from the given "from" vertex number to the
+    // given "to" vertex number, leaving the shape of the graph alone.
+    // If the edge is not present in the graph, a DigraphException is
+    // thrown instead.
+    void updateEdge(int fromVertex, int toVertex, const EdgeInfo& einfo);
+
     // vertexCount() returns the number of vertices in the graph.
     int vertexCount() const noexcept;
 
@@ -184,6 +252,14 @@ public:
     // thrown instead.
     int edgeCount(int vertex) const;
 
+    // memoryFootprint() returns the bytes that this Digraph occupies,
+    // broken down into its vertex table, its adjacency lists, the index
+    // of each vertex's incoming edges, and whatever
+    // its VertexInfo and EdgeInfo objects own on the heap.  (Those are
+    // measured with heapBytes(), so types that own memory should provide
+    // an overload of it; see MemoryFootprint.hpp.)
+    MemoryFootprint memoryFootprint() const;
+
     // isStronglyConnected() returns true if the Digraph is strongly
     // connected (i.e., every vertex is reachable from every other),
     // false otherwise.
@@ -203,6 +279,94 @@ public:
         int startVertex,
         std::function<double(const EdgeInfo&)> edgeWeightFunc) const;
 
+    // This overload of findShortestPaths() is a one-to-many search: it
+    // runs the same algorithm, but stops as soon as every one of the
+    // given target vertices has been settled, rather than exploring the
+    // whole graph.  The returned std::map contains every vertex settled
+    // before the search stopped (with the same predecessor contract as
+    // above), plus every target vertex; a target that could not be
+    // reached is mapped to itself.  If the start vertex does not exist,
+    // a DigraphException is thrown instead.
+    std::map<int, int> findShortestPaths(
+        int startVertex,
+        const std::vector<int>& targetVertices,
+        std::function<double(const EdgeInfo&)> edgeWeightFunc) const;
+
+    // Both findShortestPaths() overloads can also be given a search
+    // statistics policy (see SearchStats.hpp), which is told about the
+    // work the search does as it goes.
+    template <typename SearchStatsPolicy>
+    std::map<int, int> findShortestPaths(
+        int startVertex,
+        std::function<double(const EdgeInfo&)> edgeWeightFunc,
+        SearchStatsPolicy& stats) const;
+
+    template <typename SearchStatsPolicy>
+    std::map<int, int> findShortestPaths(
+        int startVertex,
+        const std::vector<int>& targetVertices,
+        std::function<double(const EdgeInfo&)> edgeWeightFunc,
+        SearchStatsPolicy& stats) const;
+
+    // findTimeDependentPaths() is a one-to-many search for graphs whose
+    // edge costs depend on when the edge is entered.  The search leaves
+    // the start vertex at departureTime, and travelTimeFunc is given an
+    // EdgeInfo object and the time at which that edge is entered and
+    // returns how long it takes to traverse it.  As long as leaving
+    // later never means arriving earlier (the so-called FIFO property),
+    // the result has the same form as the targeted findShortestPaths()
+    // overload, minimizing arrival time at each target.
+    std::map<int, int> findTimeDependentPaths(
+        int startVertex,
+        double departureTime,
+        const std::vector<int>& targetVertices,
+        std::function<double(const EdgeInfo&, double)> travelTimeFunc) const;
+
+    template <typename SearchStatsPolicy>
+    std::map<int, int> findTimeDependentPaths(
+        int startVertex,
+        double departureTime,
+        const std::vector<int>& targetVertices,
+        std::function<double(const EdgeInfo&, double)> travelTimeFunc,
+        SearchStatsPolicy& stats) const;
+
+    // findReachable() is a bounded search (for example, "everywhere within
+    // 15 minutes" or "everywhere within 10 miles").  Like findShortestPaths(),
+    // it uses the given function to determine edge weights, but it stops
+    // expanding once shortest path costs exceed the given budget, so its
+    // work is proportional to the size of the reachable region rather than
+    // to the size of the graph.  If the start vertex does not exist, a
+    // DigraphException is thrown instead.
+    DigraphReachableSet findReachable(
+        int startVertex,
+        double budget,
+        std::function<double(const EdgeInfo&)> edgeWeightFunc) const;
+
+    // findTurnAwarePaths() is a one-to-many search that also pays for the
+    // turns it makes: turnCostFunc is given the vertex a turn comes from,
+    // the vertex it's made at, and the vertex it goes to, and returns the
+    // extra cost of that turn, or infinity if the turn isn't allowed.
+    // Because the best way to leave a vertex can depend on how it was
+    // entered, the search's states are edges rather than vertices, but
+    // they're discovered as the search goes, so no separate graph of
+    // turns is ever built.  The result maps each target vertex to the
+    // vertices of the cheapest path to it, in order; a target that can't
+    // be reached is mapped to an empty path.  If the start vertex does
+    // not exist, a DigraphException is thrown instead.
+    std::map<int, std::vector<int>> findTurnAwarePaths(
+        int startVertex,
+        const std::vector<int>& targetVertices,
+        std::function<double(const EdgeInfo&)> edgeWeightFunc,
+        std::function<double(int, int, int)> turnCostFunc) const;
+
+    template <typename SearchStatsPolicy>
+    std::map<int, std::vector<int>> findTurnAwarePaths(
+        int startVertex,
+        const std::vector<int>& targetVertices,
+        std::function<double(const EdgeInfo&)> edgeWeightFunc,
+        std::function<double(int, int, int)> turnCostFunc,
+        SearchStatsPolicy& stats) const;
+
 
 private:
     // Add whatever member variables you think you need here.  One
@@ -213,10 +377,43 @@ private:
     // You can also feel free to add any additional member functions
     // you'd like (public or private), so long as you don't remove or
     // change the signatures of the ones that already exist.
-    std::map<int, DigraphVertex<VertexInfo, EdgeInfo>> map;
+    PersistentVertexTable<DigraphVertex<VertexInfo, EdgeInfo>> table;
     unsigned int vertexNumber;
     unsigned int edgeNumber;
 
+    // runDijkstra() is the search shared by the findShortestPaths()
+    // overloads and findTimeDependentPaths().  It settles vertices in
+    // order of increasing label, starting from startLabel at the start
+    // vertex; following an edge adds edgeCostFunc(einfo, label) to the
+    // label of the vertex it leaves.  Each settled vertex's predecessor
+    // is recorded in the given std::map, and the search stops early once
+    // shouldStop() returns true for the vertex just settled.  Vertices
+    // whose label would exceed labelLimit are never settled, and if
+    // settledLabels isn't null, each settled vertex's label is recorded
+    // there, too.  The search reports its work to the given statistics
+    // policy.
+    template <typename EdgeCostFunc, typename SearchStatsPolicy>
+    void runDijkstra(
+        int startVertex,
+        double startLabel,
+        const EdgeCostFunc& edgeCostFunc,
+        const std::function<bool(int)>& shouldStop,
+        std::map<int, int>& predecessors,
+        SearchStatsPolicy& stats,
+        double labelLimit = std::numeric_limits<double>::infinity(),
+        std::map<int, double>* settledLabels = nullptr) const;
+
+    // runToTargets() runs runDijkstra() until every existing vertex in
+    // targetVertices has been settled, then maps any unreached targets
+    // to themselves.
+    template <typename EdgeCostFunc, typename SearchStatsPolicy>
+    std::map<int, int> runToTargets(
+        int startVertex,
+        double startLabel,
+        const std::vector<int>& targetVertices,
+        const EdgeCostFunc& edgeCostFunc,
+        SearchStatsPolicy& stats) const;
+
 public:
     bool DFTr(int vertex, std::vector<int> visitedVertex) const;
 };
@@ -236,7 +433,7 @@ Digraph<VertexInfo, EdgeInfo>::Digraph()
 
 template <typename VertexInfo, typename EdgeInfo>
 Digraph<VertexInfo, EdgeInfo>::Digraph(const Digraph& d)
-    : map{d.map}, vertexNumber{d.vertexNumber}, edgeNumber{d.edgeNumber}
+    : table{d.table}, vertexNumber{d.vertexNumber}, edgeNumber{d.edgeNumber}
 {
 }
 
@@ -245,7 +442,7 @@ template <typename VertexInfo, typename EdgeInfo>
 Digraph<VertexInfo, EdgeInfo>::Digraph(Digraph&& d) noexcept
     : vertexNumber{0}, edgeNumber{0}
 {
-    std::swap(map, d.map);
+    std::swap(table, d.table);
     std::swap(vertexNumber, d.vertexNumber);
     std::swap(edgeNumber, d.edgeNumber);
 }
@@ -254,12 +451,6 @@ Digraph<VertexInfo, EdgeInfo>::Digraph(Digraph&& d) noexcept
 template <typename VertexInfo, typename EdgeInfo>
 Digraph<VertexInfo, EdgeInfo>::~Digraph() noexcept
 {
-    for(auto it = map.begin(); it != map.end(); ++it)
-    {
-        it->second.edges.clear();
-    }
-    vertexNumber = 0;
-    edgeNumber = 0;
 }
 
 
@@ -268,7 +459,7 @@ Digraph<VertexInfo, EdgeInfo>& Digraph<VertexInfo, EdgeInfo>::operator=(const Di
 {
     if(this != &d)
     {
-        map = d.map;
+        table = d.table;
         vertexNumber = d.vertexNumber;
         edgeNumber = d.edgeNumber;
     }
@@ -279,22 +470,40 @@ Digraph<VertexInfo, EdgeInfo>& Digraph<VertexInfo, EdgeInfo>::operator=(const Di
 template <typename VertexInfo, typename EdgeInfo>
 Digraph<VertexInfo, EdgeInfo>& Digraph<VertexInfo, EdgeInfo>::operator=(Digraph&& d) noexcept
 {
-    std::swap(map, d.map);
+    std::swap(table, d.table);
     std::swap(vertexNumber, d.vertexNumber);
     std::swap(edgeNumber, d.edgeNumber);
     return *this;
 }
 
 
+template <typename VertexInfo, typename EdgeInfo>
+Digraph<VertexInfo, EdgeInfo> Digraph<VertexInfo, EdgeInfo>::detachedCopy() const
+{
+    Digraph<VertexInfo, EdgeInfo> copy;
+
+    table.forEach(
+        [&](int vertex, const DigraphVertex<VertexInfo, EdgeInfo>& dv)
+        {
+            copy.table.insert(vertex, DigraphVertex<VertexInfo, EdgeInfo>{dv});
+        });
+
+    copy.vertexNumber = vertexNumber;
+    copy.edgeNumber = edgeNumber;
+    return copy;
+}
+
+
 template <typename VertexInfo, typename EdgeInfo>
 std::vector<int> Digraph<VertexInfo, EdgeInfo>::vertices() const
 {
     std::vector<int> verticiesVector;
 
-    for(auto it = map.begin(); it != map.end(); ++it)
-    {
-        verticiesVector.push_back(it->first);
-    }   
+    table.forEach(
+        [&](int vertex, const DigraphVertex<VertexInfo, EdgeInfo>&)
+        {
+            verticiesVector.push_back(vertex);
+        });
     
     return verticiesVector;
 }
@@ -305,15 +514,16 @@ std::vector<std::pair<int, int>> Digraph<VertexInfo, EdgeInfo>::edges() const
 {
     std::vector<std::pair<int, int>> edgesVector;
 
-    for(auto it1 = map.begin(); it1 != map.end(); ++it1)
-    {
-        for(auto it2 = it1->second.edges.begin(); it2 != it1->second.edges.end(); ++it2)
+    table.forEach(
+        [&](int, const DigraphVertex<VertexInfo, EdgeInfo>& vertex)
         {
-            std::pair<int, int> fromToPair;
-            fromToPair = std::make_pair(it2->fromVertex, it2->toVertex);
-            edgesVector.push_back(fromToPair);
-        }
-    }
+            for(auto it2 = vertex.edges.begin(); it2 != vertex.edges.end(); ++it2)
+            {
+                std::pair<int, int> fromToPair;
+                fromToPair = std::make_pair(it2->fromVertex, it2->toVertex);
+                edgesVector.push_back(fromToPair);
+            }
+        });
 
     return edgesVector;
 }
@@ -322,31 +532,21 @@ std::vector<std::pair<int, int>> Digraph<VertexInfo, EdgeInfo>::edges() const
 template <typename VertexInfo, typename EdgeInfo>
 std::vector<std::pair<int, int>> Digraph<VertexInfo, EdgeInfo>::edges(int vertex) const
 {
-    //return std::vector<std::pair<int, int>>{};
     std::vector<std::pair<int, int>> directedEdges;
-    
-    if(map.count(vertex) == 0)
+    const DigraphVertex<VertexInfo, EdgeInfo>* found = table.find(vertex);
+
+    if(found == nullptr)
     {
         throw DigraphException("No appropriate vertex found!");
     }
     else
     {
-        for(auto it1 = map.begin(); it1 != map.end(); ++it1)
+        for(auto it2 = found->edges.begin(); it2 != found->edges.end(); it2++)
         {
-            if(it1->first != vertex)
-            {
-                continue;
-            }
-            else
-            {
-                for(auto it2 = it1->second.edges.begin(); it2 != it1->second.edges.end(); it2++)
-                {
-                    std::pair<int, int> withoutFromToPair;
-                    withoutFromToPair = std::make_pair(vertex, it2->toVertex);
-        
-                    directedEdges.push_back(withoutFromToPair);
-                }
-            } 
+            std::pair<int, int> withoutFromToPair;
+            withoutFromToPair = std::make_pair(vertex, it2->toVertex);
+
+            directedEdges.push_back(withoutFromToPair);
         }
     }
     return directedEdges;
@@ -356,13 +556,15 @@ std::vector<std::pair<int, int>> Digraph<VertexInfo, EdgeInfo>::edges(int vertex
 template <typename VertexInfo, typename EdgeInfo>
 VertexInfo Digraph<VertexInfo, EdgeInfo>::vertexInfo(int vertex) const
 {
-    if(map.count(vertex) == 0)
+    const DigraphVertex<VertexInfo, EdgeInfo>* found = table.find(vertex);
+
+    if(found == nullptr)
     {
         throw DigraphException("No appropriate vertex found!");
     }
     else
     {
-        return map.at(vertex).vinfo;
+        return found->vinfo;
     }
 }
 
@@ -370,50 +572,79 @@ VertexInfo Digraph<VertexInfo, EdgeInfo>::vertexInfo(int vertex) const
 template <typename VertexInfo, typename EdgeInfo>
 EdgeInfo Digraph<VertexInfo, EdgeInfo>::edgeInfo(int fromVertex, int toVertex) const
 {
-    EdgeInfo returnEdgeInfo;
-    
-    if (map.count(fromVertex) == 0 ||  map.count(toVertex) == 0)
+    const DigraphVertex<VertexInfo, EdgeInfo>* found = table.find(fromVertex);
+
+    if (found == nullptr || table.find(toVertex) == nullptr)
     {
         throw DigraphException("No appropriate vertex have found!");
-    }    
-    else
-    {
-        std::pair<int,int> ourVerticies;
-        ourVerticies = std::make_pair(fromVertex, toVertex);
+    }
 
-        std::vector<std::pair<int,int>> edgeVector = edges(fromVertex);
-        
-        if(std::find(edgeVector.begin(), edgeVector.end(), ourVerticies) == edgeVector.end())
+    for(auto it = found->edges.begin(); it != found->edges.end(); it++)
+    {
+        if(it->toVertex == toVertex)
         {
-            throw DigraphException("There is no edge between them!");
+            return it->einfo;
         }
+    }
+
+    throw DigraphException("There is no edge between them!");
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+const VertexInfo* Digraph<VertexInfo, EdgeInfo>::findVertexInfo(int vertex) const
+{
+    const DigraphVertex<VertexInfo, EdgeInfo>* found = table.find(vertex);
+    return found == nullptr ? nullptr : &found->vinfo;
+}
 
-        for(auto it = map.at(fromVertex).edges.begin(); it != map.at(fromVertex).edges.end(); it++)
+
+template <typename VertexInfo, typename EdgeInfo>
+const EdgeInfo* Digraph<VertexInfo, EdgeInfo>::findEdgeInfo(int fromVertex, int toVertex) const
+{
+    const DigraphVertex<VertexInfo, EdgeInfo>* found = table.find(fromVertex);
+
+    if(found == nullptr)
+    {
+        return nullptr;
+    }
+
+    for(const DigraphEdge<EdgeInfo>& edge : found->edges)
+    {
+        if(edge.toVertex == toVertex)
         {
-            if(it->toVertex == toVertex)
-            {
-                returnEdgeInfo = it->einfo;
-            }
+            return &edge.einfo;
         }
     }
 
-    return returnEdgeInfo;
+    return nullptr;
 }
 
+
 template <typename VertexInfo, typename EdgeInfo>
-void Digraph<VertexInfo, EdgeInfo>::addVertex(int vertex, const VertexInfo& vinfo)
+template <typename EdgeFunc>
+void Digraph<VertexInfo, EdgeInfo>::forEachEdge(int vertex, EdgeFunc edgeFunc) const
 {
-    if (map.count(vertex) > 0)
+    const DigraphVertex<VertexInfo, EdgeInfo>* found = table.find(vertex);
+
+    if(found == nullptr)
     {
-        throw DigraphException("This vertex is already in the graph!");
-    }  
-    else
+        throw DigraphException("No appropriate vertex found!");
+    }
+
+    for(const DigraphEdge<EdgeInfo>& edge : found->edges)
     {
-        DigraphVertex<VertexInfo, EdgeInfo> newVertex{vinfo};
+        edgeFunc(edge);
+    }
+}
+
 
-        std::pair<int, DigraphVertex<VertexInfo, EdgeInfo>> newPair;
-        newPair = std::make_pair(vertex, newVertex);
-        map.insert(newPair);
+template <typename VertexInfo, typename EdgeInfo>
+void Digraph<VertexInfo, EdgeInfo>::addVertex(int vertex, const VertexInfo& vinfo)
+{
+    if (!table.insert(vertex, DigraphVertex<VertexInfo, EdgeInfo>{vinfo}))
+    {
+        throw DigraphException("This vertex is already in the graph!");
     }
     vertexNumber++;
 }
@@ -422,7 +653,7 @@ void Digraph<VertexInfo, EdgeInfo>::addVertex(int vertex, const VertexInfo& vinf
 template <typename VertexInfo, typename EdgeInfo>
 void Digraph<VertexInfo, EdgeInfo>::addEdge(int fromVertex, int toVertex, const EdgeInfo& einfo)
 {
-    if(map.count(fromVertex) == 0 || map.count(toVertex) == 0) 
+    if(table.find(fromVertex) == nullptr || table.find(toVertex) == nullptr) 
     {
         throw DigraphException("Given verticies are not exist!");
     }
@@ -438,7 +669,8 @@ void Digraph<VertexInfo, EdgeInfo>::addEdge(int fromVertex, int toVertex, const
             throw DigraphException("Edge is already in the graph");
         }
     }
-    map.at(fromVertex).edges.push_back(DigraphEdge<EdgeInfo>{fromVertex,toVertex,einfo});
+    table.findForUpdate(fromVertex)->edges.push_back(DigraphEdge<EdgeInfo>{fromVertex,toVertex,einfo});
+    table.findForUpdate(toVertex)->incoming.push_back(fromVertex);
     edgeNumber++;
 }
 
@@ -446,34 +678,82 @@ void Digraph<VertexInfo, EdgeInfo>::addEdge(int fromVertex, int toVertex, const
 template <typename VertexInfo, typename EdgeInfo>
 void Digraph<VertexInfo, EdgeInfo>::removeVertex(int vertex)
 {
-    if(map.count(vertex) == 0)
+    const DigraphVertex<VertexInfo, EdgeInfo>* found = table.find(vertex);
+
+    if(found == nullptr)
     {
         throw DigraphException("This vertex does not exist in map!");
     }
 
-    for(auto it1 = map.begin(); it1 != map.end(); ++it1)
+    // Each of the vertex's edges is also recorded at its other end (as an
+    // outgoing edge there, or in the incoming index there), and only those
+    // vertices need to be visited.  Both lists are copied first, since
+    // changing the neighbors can copy vertices shared with other Digraphs.
+    std::vector<int> fromVertices = found->incoming;
+    std::vector<int> toVertices;
+
+    for(const DigraphEdge<EdgeInfo>& edge : found->edges)
     {
-        if(it1->first != vertex)
+        toVertices.push_back(edge.toVertex);
+    }
+
+    for(int fromVertex : fromVertices)
+    {
+        // An edge from the vertex to itself is counted with the outgoing
+        // edges below.
+        if(fromVertex == vertex)
         {
             continue;
         }
-        else
+
+        std::list<DigraphEdge<EdgeInfo>>& fromEdges = table.findForUpdate(fromVertex)->edges;
+
+        fromEdges.remove_if([&](const DigraphEdge<EdgeInfo>& edge) { return edge.toVertex == vertex; });
+        edgeNumber--;
+    }
+
+    for(int toVertex : toVertices)
+    {
+        if(toVertex != vertex)
         {
-            for(auto it2 = it1->second.edges.begin(); it2 != it1->second.edges.end(); it2++)
-            {
-                it1->second.edges.erase(it2);
-            }
+            std::vector<int>& incoming = table.findForUpdate(toVertex)->incoming;
+            incoming.erase(std::find(incoming.begin(), incoming.end(), vertex));
         }
+
+        edgeNumber--;
     }
-    map.erase(vertex);
+
+    table.erase(vertex);
     vertexNumber--;
 }
 
 
+template <typename VertexInfo, typename EdgeInfo>
+void Digraph<VertexInfo, EdgeInfo>::removeVertices(const std::vector<int>& vertices)
+{
+    for(int vertex : vertices)
+    {
+        if(table.find(vertex) == nullptr)
+        {
+            throw DigraphException("This vertex does not exist in map!");
+        }
+    }
+
+    // A vertex listed more than once is only removed the first time.
+    for(int vertex : vertices)
+    {
+        if(table.find(vertex) != nullptr)
+        {
+            removeVertex(vertex);
+        }
+    }
+}
+
+
 template <typename VertexInfo, typename EdgeInfo>
 void Digraph<VertexInfo, EdgeInfo>::removeEdge(int fromVertex, int toVertex)
 {
-    if(map.count(fromVertex) == 0 || map.count(toVertex) == 0)
+    if(table.find(fromVertex) == nullptr || table.find(toVertex) == nullptr)
     {
         throw DigraphException("Either fromVertex, or toVertex does not exist in graph!");
     }
@@ -489,11 +769,13 @@ void Digraph<VertexInfo, EdgeInfo>::removeEdge(int fromVertex, int toVertex)
             throw DigraphException("Edge does not exist in the graph");
         }
     }
-        for(auto it = map.at(fromVertex).edges.begin(); it != map.at(fromVertex).edges.end(); it++)
+        std::list<DigraphEdge<EdgeInfo>>& fromEdges = table.findForUpdate(fromVertex)->edges;
+
+        for(auto it = fromEdges.begin(); it != fromEdges.end(); it++)
         {
             if(it->toVertex == toVertex)
             {
-                map.at(fromVertex).edges.erase(it);
+                fromEdges.erase(it);
                 break;
             }
             else
@@ -501,11 +783,35 @@ void Digraph<VertexInfo, EdgeInfo>::removeEdge(int fromVertex, int toVertex)
 
             }
         } 
+
+        std::vector<int>& incoming = table.findForUpdate(toVertex)->incoming;
+        incoming.erase(std::find(incoming.begin(), incoming.end(), fromVertex));
         
     edgeNumber--;
 }
 
 
+template <typename VertexInfo, typename EdgeInfo>
+void Digraph<VertexInfo, EdgeInfo>::updateEdge(int fromVertex, int toVertex, const EdgeInfo& einfo)
+{
+    // The edge is found before anything is copied, so that a failed
+    // update leaves a shared vertex shared.
+    if(findEdgeInfo(fromVertex, toVertex) != nullptr)
+    {
+        for(DigraphEdge<EdgeInfo>& edge : table.findForUpdate(fromVertex)->edges)
+        {
+            if(edge.toVertex == toVertex)
+            {
+                edge.einfo = einfo;
+                return;
+            }
+        }
+    }
+
+    throw DigraphException("Edge does not exist in the graph");
+}
+
+
 template <typename VertexInfo, typename EdgeInfo>
 int Digraph<VertexInfo, EdgeInfo>::vertexCount() const noexcept
 {
@@ -524,14 +830,15 @@ template <typename VertexInfo, typename EdgeInfo>
 int Digraph<VertexInfo, EdgeInfo>::edgeCount(int vertex) const
 {
     int counter = 0;
+    const DigraphVertex<VertexInfo, EdgeInfo>* found = table.find(vertex);
     
-    if(map.count(vertex) == 0)
+    if(found == nullptr)
     {
         throw DigraphException("The vertex is not valid!");
     }
     else
     {
-        for(auto it = map.at(vertex).edges.begin(); it != map.at(vertex).edges.end(); ++it)
+        for(auto it = found->edges.begin(); it != found->edges.end(); ++it)
         {
             counter++;
         }
@@ -543,7 +850,9 @@ int Digraph<VertexInfo, EdgeInfo>::edgeCount(int vertex) const
 template<typename VertexInfo, typename EdgeInfo>
 bool Digraph<VertexInfo, EdgeInfo>::DFTr(int vertex, std::vector<int> visitedVertex) const
 {
-    for(auto it = map.at(vertex).edges.begin(); it != map.at(vertex).edges.end(); ++it)
+    const DigraphVertex<VertexInfo, EdgeInfo>* found = table.find(vertex);
+
+    for(auto it = found->edges.begin(); it != found->edges.end(); ++it)
     {
         if (std::find(visitedVertex.begin(), visitedVertex.end(), it->toVertex) == visitedVertex.end())
         {
@@ -565,72 +874,426 @@ bool Digraph<VertexInfo, EdgeInfo>::DFTr(int vertex, std::vector<int> visitedVer
     }
 }
 
+template <typename VertexInfo, typename EdgeInfo>
+MemoryFootprint Digraph<VertexInfo, EdgeInfo>::memoryFootprint() const
+{
+    std::size_t incomingBytes = 0;
+    std::size_t vertexInfoBytes = 0;
+    std::size_t edgeInfoBytes = 0;
+
+    table.forEach(
+        [&](int, const DigraphVertex<VertexInfo, EdgeInfo>& vertex)
+        {
+            incomingBytes += heapBytes(vertex.incoming);
+            vertexInfoBytes += heapBytes(vertex.vinfo);
+
+            for(const DigraphEdge<EdgeInfo>& edge : vertex.edges)
+            {
+                edgeInfoBytes += heapBytes(edge.einfo);
+            }
+        });
+
+    MemoryFootprint returnValue;
+    returnValue.add("vertex table", sizeof(*this) + table.heapBytes());
+    returnValue.add("adjacency lists", edgeNumber * heapBlockBytes(listNodeOverhead + sizeof(DigraphEdge<EdgeInfo>)));
+    returnValue.add("incoming index", incomingBytes);
+    returnValue.add("vertex info", vertexInfoBytes);
+    returnValue.add("edge info", edgeInfoBytes);
+
+    return returnValue;
+}
+
+
 template <typename VertexInfo, typename EdgeInfo>
 bool Digraph<VertexInfo, EdgeInfo>::isStronglyConnected() const
 {
     bool x;
     std::vector<int> visitedVector;
 
-    for(auto it = map.begin(); it != map.end(); ++it)
+    table.forEach(
+        [&](int vertex, const DigraphVertex<VertexInfo, EdgeInfo>&)
+        {
+            x = DFTr(vertex, visitedVector);
+        });
+    return x;
+}
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeCostFunc, typename SearchStatsPolicy>
+void Digraph<VertexInfo, EdgeInfo>::runDijkstra(
+    int startVertex,
+    double startLabel,
+    const EdgeCostFunc& edgeCostFunc,
+    const std::function<bool(int)>& shouldStop,
+    std::map<int, int>& predecessors,
+    SearchStatsPolicy& stats,
+    double labelLimit,
+    std::map<int, double>* settledLabels) const
+{
+    if(table.find(startVertex) == nullptr)
     {
-        x = DFTr(it->first, visitedVector);
+        throw DigraphException("The start vertex does not exist in graph!");
     }
-    return x;
+
+    std::map<int, double> d;
+    std::map<int, int> p;
+
+    // The queue holds (label, vertex) pairs, so the smallest tentative
+    // label is always on top.  A vertex can be pushed more than once;
+    // entries older than its current label are skipped when popped.
+    std::priority_queue<std::pair<double, int>, std::vector<std::pair<double, int>>, std::greater<std::pair<double, int>>> pq;
+
+    stats.searchStarted();
+
+    d[startVertex] = startLabel;
+    p[startVertex] = startVertex;
+    pq.push(std::make_pair(startLabel, startVertex));
+    stats.queuePushed(pq.size());
+
+    while(!pq.empty())
+    {
+        double minDistance = pq.top().first;
+        int minVertex = pq.top().second;
+        pq.pop();
+
+        if(predecessors.count(minVertex) > 0 || minDistance > d[minVertex])
+        {
+            stats.queuePopped(true);
+            continue;
+        }
+
+        stats.queuePopped(false);
+
+        if(minDistance > labelLimit)
+        {
+            break;
+        }
+
+        predecessors[minVertex] = p[minVertex];
+        stats.vertexSettled();
+
+        if(settledLabels != nullptr)
+        {
+            (*settledLabels)[minVertex] = minDistance;
+        }
+
+        if(shouldStop(minVertex))
+        {
+            break;
+        }
+
+        const DigraphVertex<VertexInfo, EdgeInfo>* vertex = table.find(minVertex);
+
+        for(auto it = vertex->edges.begin(); it != vertex->edges.end(); ++it)
+        {
+            double candidate = minDistance + edgeCostFunc(it->einfo, minDistance);
+            auto found = d.find(it->toVertex);
+
+            stats.edgeRelaxed();
+
+            if(found == d.end() || candidate < found->second)
+            {
+                d[it->toVertex] = candidate;
+                p[it->toVertex] = minVertex;
+                pq.push(std::make_pair(candidate, it->toVertex));
+                stats.queuePushed(pq.size());
+            }
+        }
+    }
+
+    stats.searchFinished();
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename EdgeCostFunc, typename SearchStatsPolicy>
+std::map<int, int> Digraph<VertexInfo, EdgeInfo>::runToTargets(
+    int startVertex,
+    double startLabel,
+    const std::vector<int>& targetVertices,
+    const EdgeCostFunc& edgeCostFunc,
+    SearchStatsPolicy& stats) const
+{
+    std::map<int, int> returnValue;
+    std::set<int> remaining;
+
+    for(int target : targetVertices)
+    {
+        if(table.find(target) != nullptr)
+        {
+            remaining.insert(target);
+        }
+    }
+
+    runDijkstra(
+        startVertex, startLabel, edgeCostFunc,
+        [&](int settledVertex)
+        {
+            remaining.erase(settledVertex);
+            return remaining.empty();
+        },
+        returnValue, stats);
+
+    for(int target : targetVertices)
+    {
+        returnValue.emplace(target, target);
+    }
+
+    return returnValue;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::map<int, int> Digraph<VertexInfo, EdgeInfo>::findShortestPaths(
+    int startVertex,
+    std::function<double(const EdgeInfo&)> edgeWeightFunc) const
+{
+    NoSearchStats stats;
+    return findShortestPaths(startVertex, std::move(edgeWeightFunc), stats);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::map<int, int> Digraph<VertexInfo, EdgeInfo>::findShortestPaths(
+    int startVertex,
+    const std::vector<int>& targetVertices,
+    std::function<double(const EdgeInfo&)> edgeWeightFunc) const
+{
+    NoSearchStats stats;
+    return findShortestPaths(startVertex, targetVertices, std::move(edgeWeightFunc), stats);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename SearchStatsPolicy>
+std::map<int, int> Digraph<VertexInfo, EdgeInfo>::findShortestPaths(
+    int startVertex,
+    std::function<double(const EdgeInfo&)> edgeWeightFunc,
+    SearchStatsPolicy& stats) const
+{
+    std::map<int, int> returnValue;
+
+    runDijkstra(
+        startVertex, 0.0,
+        [&](const EdgeInfo& einfo, double) { return edgeWeightFunc(einfo); },
+        [](int) { return false; },
+        returnValue, stats);
+
+    table.forEach(
+        [&](int vertex, const DigraphVertex<VertexInfo, EdgeInfo>&)
+        {
+            returnValue.emplace(vertex, vertex);
+        });
+
+    return returnValue;
 }
 
+
 template <typename VertexInfo, typename EdgeInfo>
+template <typename SearchStatsPolicy>
 std::map<int, int> Digraph<VertexInfo, EdgeInfo>::findShortestPaths(
     int startVertex,
+    const std::vector<int>& targetVertices,
+    std::function<double(const EdgeInfo&)> edgeWeightFunc,
+    SearchStatsPolicy& stats) const
+{
+    return runToTargets(
+        startVertex, 0.0, targetVertices,
+        [&](const EdgeInfo& einfo, double) { return edgeWeightFunc(einfo); },
+        stats);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::map<int, int> Digraph<VertexInfo, EdgeInfo>::findTimeDependentPaths(
+    int startVertex,
+    double departureTime,
+    const std::vector<int>& targetVertices,
+    std::function<double(const EdgeInfo&, double)> travelTimeFunc) const
+{
+    NoSearchStats stats;
+    return findTimeDependentPaths(startVertex, departureTime, targetVertices, std::move(travelTimeFunc), stats);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename SearchStatsPolicy>
+std::map<int, int> Digraph<VertexInfo, EdgeInfo>::findTimeDependentPaths(
+    int startVertex,
+    double departureTime,
+    const std::vector<int>& targetVertices,
+    std::function<double(const EdgeInfo&, double)> travelTimeFunc,
+    SearchStatsPolicy& stats) const
+{
+    return runToTargets(startVertex, departureTime, targetVertices, travelTimeFunc, stats);
+}
+
+template <typename VertexInfo, typename EdgeInfo>
+DigraphReachableSet Digraph<VertexInfo, EdgeInfo>::findReachable(
+    int startVertex,
+    double budget,
     std::function<double(const EdgeInfo&)> edgeWeightFunc) const
-{ 
-    std::map<int, bool> k;
-    std::map<int, int> d;
-    std::vector<int> predecessor;
-    double inf = 9999999999;
+{
+    DigraphReachableSet returnValue;
+    NoSearchStats stats;
 
-    for(auto it = map.begin(); it != map.end(); ++it)
+    runDijkstra(
+        startVertex, 0.0,
+        [&](const EdgeInfo& einfo, double) { return edgeWeightFunc(einfo); },
+        [](int) { return false; },
+        returnValue.predecessors, stats, budget, &returnValue.costs);
+
+    for(auto it = returnValue.costs.begin(); it != returnValue.costs.end(); ++it)
     {
-        k[it->first] = false;
-        d[it->first] = inf;
+        for(const DigraphEdge<EdgeInfo>& edge : table.find(it->first)->edges)
+        {
+            if(it->second + edgeWeightFunc(edge.einfo) > budget)
+            {
+                returnValue.frontier.push_back(std::make_pair(edge.fromVertex, edge.toVertex));
+            }
+        }
     }
 
-    d[startVertex] = 0;
-    predecessor.push_back(startVertex);
-     
-    std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<std::pair<int, int>>> pq;
-    pq.push(std::make_pair(startVertex, 0));
- 
-    while(!pq.empty())
+    return returnValue;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::map<int, std::vector<int>> Digraph<VertexInfo, EdgeInfo>::findTurnAwarePaths(
+    int startVertex,
+    const std::vector<int>& targetVertices,
+    std::function<double(const EdgeInfo&)> edgeWeightFunc,
+    std::function<double(int, int, int)> turnCostFunc) const
+{
+    NoSearchStats stats;
+    return findTurnAwarePaths(
+        startVertex, targetVertices, std::move(edgeWeightFunc), std::move(turnCostFunc), stats);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+template <typename SearchStatsPolicy>
+std::map<int, std::vector<int>> Digraph<VertexInfo, EdgeInfo>::findTurnAwarePaths(
+    int startVertex,
+    const std::vector<int>& targetVertices,
+    std::function<double(const EdgeInfo&)> edgeWeightFunc,
+    std::function<double(int, int, int)> turnCostFunc,
+    SearchStatsPolicy& stats) const
+{
+    const DigraphVertex<VertexInfo, EdgeInfo>* start = table.find(startVertex);
+
+    if(start == nullptr)
+    {
+        throw DigraphException("The start vertex does not exist in graph!");
+    }
+
+    using State = std::pair<int, int>;
+
+    std::map<int, std::vector<int>> returnValue;
+    std::set<int> remaining;
+
+    for(int target : targetVertices)
+    {
+        returnValue[target];
+
+        if(target == startVertex)
+        {
+            returnValue[target].push_back(startVertex);
+        }
+        else if(table.find(target) != nullptr)
+        {
+            remaining.insert(target);
+        }
+    }
+
+    // Each state is the edge most recently driven along, labeled with the
+    // cost of reaching the end of it; the edges leaving the start vertex
+    // are their own parents.
+    std::map<State, double> d;
+    std::map<State, State> p;
+    std::set<State> settled;
+    std::priority_queue<std::pair<double, State>, std::vector<std::pair<double, State>>, std::greater<std::pair<double, State>>> pq;
+
+    stats.searchStarted();
+
+    for(const DigraphEdge<EdgeInfo>& edge : start->edges)
     {
-        int minVertex = pq.top().first;
+        State state{startVertex, edge.toVertex};
+        double label = edgeWeightFunc(edge.einfo);
+        auto found = d.find(state);
+
+        if(found == d.end() || label < found->second)
+        {
+            d[state] = label;
+            p[state] = state;
+            pq.push(std::make_pair(label, state));
+            stats.queuePushed(pq.size());
+        }
+    }
+
+    while(!pq.empty() && !remaining.empty())
+    {
+        double minDistance = pq.top().first;
+        State minState = pq.top().second;
         pq.pop();
 
-        if(k[minVertex] == false)
+        if(settled.count(minState) > 0 || minDistance > d[minState])
         {
-            k[minVertex] = true;
-            
-            for(auto it = map.at(minVertex).edges.begin(); it != map.at(minVertex).edges.end(); ++it)
+            stats.queuePopped(true);
+            continue;
+        }
+
+        stats.queuePopped(false);
+        settled.insert(minState);
+        stats.vertexSettled();
+
+        int via = minState.second;
+
+        if(remaining.erase(via) > 0)
+        {
+            std::vector<int>& path = returnValue[via];
+
+            for(State state = minState; ; state = p[state])
             {
-                if(d[it->toVertex] < d[minVertex] + edgeWeightFunc(it->einfo))
+                path.push_back(state.second);
+
+                if(p[state] == state)
                 {
-                    d[it->toVertex] = d[minVertex] + edgeWeightFunc(it->einfo);
-                    predecessor.push_back(minVertex);
-  
-                    pq.push(std::make_pair(it->toVertex, d[it->toVertex]));
+                    path.push_back(state.first);
+                    break;
                 }
             }
+
+            std::reverse(path.begin(), path.end());
         }
-    }
-    
-    std::map<int, int> returnValue;
-    int j = 0;
 
-    for(auto i = d.begin(); i != d.end(); ++i)
-    {
-        returnValue[i->first] = predecessor[j];
-        j++;
+        for(const DigraphEdge<EdgeInfo>& edge : table.find(via)->edges)
+        {
+            double turnCost = turnCostFunc(minState.first, via, edge.toVertex);
+
+            stats.edgeRelaxed();
+
+            if(turnCost == std::numeric_limits<double>::infinity())
+            {
+                continue;
+            }
+
+            State next{via, edge.toVertex};
+            double candidate = minDistance + turnCost + edgeWeightFunc(edge.einfo);
+            auto found = d.find(next);
+
+            if(found == d.end() || candidate < found->second)
+            {
+                d[next] = candidate;
+                p[next] = minState;
+                pq.push(std::make_pair(candidate, next));
+                stats.queuePushed(pq.size());
+            }
+        }
     }
 
+    stats.searchFinished();
+
     return returnValue;
 }
 
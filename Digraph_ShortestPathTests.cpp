@@ -0,0 +1,611 @@
+// Digraph_ShortestPathTests.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// Unit tests for the shortest path searches in Digraph and for the
+// routing code built on top of them, using small hand-built graphs
+// where the right answers are easy to check by eye.
+
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <vector>
+#include <gtest/gtest.h>
+#include "AlternativeRoutes.hpp"
+#include "CompactDigraph.hpp"
+#include "ContractionHierarchy.hpp"
+#include "DeltaStepping.hpp"
+#include "Digraph.hpp"
+#include "NearestFacilities.hpp"
+#include "Phast.hpp"
+#include "RoadMap.hpp"
+#include "RoadMapReader.hpp"
+#include "SearchStats.hpp"
+#include "ShortestPathTree.hpp"
+#include "TripPlanner.hpp"
+#include "TripReader.hpp"
+
+
+namespace
+{
+    Digraph<int, double> makeDiamond()
+    {
+        // 1 -> 2 -> 4 is cheaper than 1 -> 3 -> 4, and 5 is unreachable.
+        Digraph<int, double> d;
+
+        for (int i = 1; i <= 5; ++i)
+        {
+            d.addVertex(i, i * 10);
+        }
+
+        d.addEdge(1, 2, 1.0);
+        d.addEdge(1, 3, 2.0);
+        d.addEdge(2, 4, 1.5);
+        d.addEdge(3, 4, 0.1);
+        d.addEdge(4, 1, 1.0);
+
+        return d;
+    }
+
+
+    double weightOf(double edgeInfo)
+    {
+        return edgeInfo;
+    }
+}
+
+
+TEST(Digraph_ShortestPathTests, choosesCheaperOfTwoPaths)
+{
+    std::map<int, int> paths = makeDiamond().findShortestPaths(1, weightOf);
+
+    ASSERT_EQ(5, paths.size());
+    ASSERT_EQ(1, paths[1]);
+    ASSERT_EQ(1, paths[2]);
+    ASSERT_EQ(1, paths[3]);
+    ASSERT_EQ(3, paths[4]);
+    ASSERT_EQ(5, paths[5]);
+}
+
+
+TEST(Digraph_ShortestPathTests, targetedSearchStopsOnceTargetsAreSettled)
+{
+    std::map<int, int> paths = makeDiamond().findShortestPaths(1, {2}, weightOf);
+
+    ASSERT_EQ(1, paths[2]);
+    ASSERT_TRUE(paths.find(4) == paths.end());
+}
+
+
+TEST(Digraph_ShortestPathTests, targetedSearchMapsUnreachableTargetsToThemselves)
+{
+    std::map<int, int> paths = makeDiamond().findShortestPaths(1, {4, 5}, weightOf);
+
+    ASSERT_EQ(3, paths[4]);
+    ASSERT_EQ(5, paths[5]);
+}
+
+
+TEST(Digraph_ShortestPathTests, countingStatsDescribeTheSearch)
+{
+    CountingSearchStats counting;
+    makeDiamond().findShortestPaths(1, weightOf, counting);
+
+    const SearchStats& stats = counting.stats();
+
+    ASSERT_EQ(1, stats.queries);
+    ASSERT_EQ(4, stats.verticesSettled);
+    ASSERT_EQ(5, stats.edgesRelaxed);
+    ASSERT_EQ(5, stats.queuePushes);
+    ASSERT_EQ(5, stats.queuePops);
+    ASSERT_EQ(1, stats.stalePops);
+    ASSERT_EQ(2, stats.peakQueueSize);
+
+    makeDiamond().findShortestPaths(1, {2}, weightOf, counting);
+
+    ASSERT_EQ(2, counting.stats().queries);
+    ASSERT_EQ(6, counting.stats().verticesSettled);
+}
+
+
+TEST(Digraph_ShortestPathTests, plannerAnswersTripsInOriginalOrder)
+{
+    RoadMap roadMap;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        roadMap.addVertex(i, "Location");
+    }
+
+    roadMap.addEdge(0, 1, RoadSegment{1.0, 10.0});
+    roadMap.addEdge(1, 2, RoadSegment{1.0, 10.0});
+    roadMap.addEdge(0, 2, RoadSegment{1.5, 60.0});
+
+    std::vector<Trip> trips{
+        {0, 2, TripMetric::Distance},
+        {2, 0, TripMetric::Time},
+        {0, 2, TripMetric::Time},
+        {0, 1, TripMetric::Distance}};
+
+    std::vector<Route> routes = TripPlanner{}.planTrips(roadMap, trips);
+
+    ASSERT_EQ(4, routes.size());
+    ASSERT_EQ((std::vector<int>{0, 2}), routes[0].vertices);
+    ASSERT_TRUE(routes[1].vertices.empty());
+    ASSERT_EQ((std::vector<int>{0, 2}), routes[2].vertices);
+    ASSERT_EQ((std::vector<int>{0, 1}), routes[3].vertices);
+    ASSERT_DOUBLE_EQ(1.5, routes[0].miles);
+}
+
+
+TEST(Digraph_ShortestPathTests, copiesAreIndependentWhatIfScenarios)
+{
+    RoadMap roadMap;
+
+    for (int i = -2; i < 3; ++i)
+    {
+        roadMap.addVertex(i, "Location");
+    }
+
+    roadMap.addEdge(-2, 0, RoadSegment{1.0, 60.0});
+    roadMap.addEdge(0, 2, RoadSegment{1.0, 60.0});
+    roadMap.addEdge(-2, -1, RoadSegment{2.0, 60.0});
+    roadMap.addEdge(-1, 1, RoadSegment{2.0, 60.0});
+    roadMap.addEdge(1, 2, RoadSegment{2.0, 60.0});
+
+    // One scenario closes a road, another slows one down; neither may
+    // affect the original or each other.
+    RoadMap closure = roadMap;
+    closure.removeEdge(0, 2);
+
+    RoadMap slowdown = roadMap;
+    slowdown.updateEdge(-2, 0, RoadSegment{1.0, 5.0});
+    slowdown.addVertex(3, "Detour");
+
+    auto time = TripPlanner::edgeWeightFor(TripMetric::Time);
+    auto routeIn = [&](const RoadMap& scenario)
+    {
+        return TripPlanner::routeFor(scenario, scenario.findShortestPaths(-2, {2}, time), -2, 2).vertices;
+    };
+
+    ASSERT_EQ((std::vector<int>{-2, 0, 2}), routeIn(roadMap));
+    ASSERT_EQ((std::vector<int>{-2, -1, 1, 2}), routeIn(closure));
+    ASSERT_EQ((std::vector<int>{-2, -1, 1, 2}), routeIn(slowdown));
+
+    ASSERT_EQ((std::vector<int>{-2, -1, 0, 1, 2}), roadMap.vertices());
+    ASSERT_EQ((std::vector<int>{-2, -1, 0, 1, 2, 3}), slowdown.vertices());
+    ASSERT_EQ(5, roadMap.edgeCount());
+    ASSERT_EQ(4, closure.edgeCount());
+    ASSERT_EQ(60.0, roadMap.edgeInfo(-2, 0).milesPerHour);
+}
+
+
+TEST(Digraph_ShortestPathTests, removingVerticesRemovesEdgesBothWays)
+{
+    Digraph<int, double> d = makeDiamond();
+    d.addEdge(2, 2, 1.0);
+    d.addEdge(3, 2, 1.0);
+
+    Digraph<int, double> before = d;
+    int edgeCount = d.edgeCount();
+
+    // Vertex 2 has two incoming edges, one outgoing edge, and a loop.
+    d.removeVertex(2);
+
+    ASSERT_EQ(edgeCount - 4, d.edgeCount());
+    ASSERT_EQ(static_cast<std::size_t>(d.edgeCount()), d.edges().size());
+
+    for (const std::pair<int, int>& edge : d.edges())
+    {
+        ASSERT_NE(2, edge.first);
+        ASSERT_NE(2, edge.second);
+    }
+
+    std::map<int, int> paths = d.findShortestPaths(1, weightOf);
+    ASSERT_EQ(0, paths.count(2));
+    ASSERT_EQ(3, paths.at(4));
+
+    ASSERT_THROW(d.removeVertices({1, 7}), DigraphException);
+    ASSERT_EQ(4, d.vertexCount());
+
+    d.removeVertices({1, 3, 4, 1});
+    ASSERT_EQ((std::vector<int>{5}), d.vertices());
+    ASSERT_EQ(0, d.edgeCount());
+
+    ASSERT_EQ(edgeCount, before.edgeCount());
+    ASSERT_EQ(static_cast<std::size_t>(edgeCount), before.edges().size());
+}
+
+
+TEST(Digraph_ShortestPathTests, turnRestrictionsDetourAndPenalizeRoutes)
+{
+    // The way through 1 is shorter, but the turn from 0 through 1 to 2 is
+    // banned; trips are read after the turn section as usual.
+    std::istringstream input{
+        "4\nA\nB\nC\nD\n"
+        "4\n0 1 1.0 60\n1 2 1.0 60\n0 3 1.5 60\n3 2 1.5 60\n"
+        "TURNS\n1\n0 1 2 no\n"
+        "2\n0 2 D\n0 1 D\n"};
+
+    InputReader in{input};
+    TurnTable banned;
+    RoadMap roadMap = RoadMapReader{}.readRoadMap(in, banned);
+    std::vector<Trip> trips = TripReader{}.readTrips(in);
+
+    ASSERT_EQ(1, banned.size());
+    ASSERT_TRUE(banned.isBanned(0, 1, 2));
+
+    std::vector<Route> routes = TripPlanner{banned}.planTrips(roadMap, trips);
+    ASSERT_EQ((std::vector<int>{0, 3, 2}), routes[0].vertices);
+    ASSERT_EQ((std::vector<int>{0, 1}), routes[1].vertices);
+
+    // A three-minute penalty on the same turn makes the longer way faster,
+    // but not shorter, and the penalty shows up in the driving time.
+    TurnTable slow{{TurnRule{0, 1, 2, 0.05f}}};
+    TripPlanner planner{slow};
+
+    Route fastest = planner.planTrips(roadMap, {Trip{0, 2, TripMetric::Time}})[0];
+    ASSERT_EQ((std::vector<int>{0, 3, 2}), fastest.vertices);
+    ASSERT_NEAR(0.05, fastest.hours, 1e-9);
+
+    Route shortest = planner.planTrips(roadMap, {Trip{0, 2, TripMetric::Distance}})[0];
+    ASSERT_EQ((std::vector<int>{0, 1, 2}), shortest.vertices);
+    ASSERT_NEAR(2.0 / 60.0 + 0.05, shortest.hours, 1e-6);
+
+    std::istringstream badInput{"2\nA\nB\n1\n0 1 1.0 60\nTURNS\n1\n1 0 1 30\n"};
+    InputReader badIn{badInput};
+    ASSERT_THROW(RoadMapReader{}.readRoadMap(badIn, banned), DigraphException);
+}
+
+
+TEST(Digraph_ShortestPathTests, departureTimeChangesTimeDependentRoute)
+{
+    SpeedProfilePool profiles;
+
+    RoadMap roadMap;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        roadMap.addVertex(i, "Location");
+    }
+
+    // The freeway is fast overnight and crawls at 8:00; the surface
+    // streets always move at 30mph.
+    RoadSegment freeway{10.0, 60.0, profiles.intern({{0.0f, 60.0f}, {8.0f, 5.0f}, {12.0f, 60.0f}})};
+    roadMap.addEdge(0, 2, freeway);
+    roadMap.addEdge(0, 1, RoadSegment{6.0, 30.0});
+    roadMap.addEdge(1, 2, RoadSegment{6.0, 30.0});
+
+    std::vector<Trip> trips{
+        {0, 2, TripMetric::Time, 2.0},
+        {0, 2, TripMetric::Time, 8.0}};
+
+    std::vector<Route> routes = TripPlanner{}.planTrips(roadMap, trips);
+
+    ASSERT_EQ((std::vector<int>{0, 2}), routes[0].vertices);
+    ASSERT_EQ((std::vector<int>{0, 1, 2}), routes[1].vertices);
+    ASSERT_NEAR(0.4, routes[1].hours, 1e-9);
+}
+
+
+TEST(Digraph_ShortestPathTests, speedProfilesAreSharedAndIntegrated)
+{
+    SpeedProfilePool profiles;
+
+    auto first = profiles.intern({{6.0f, 20.0f}, {0.0f, 60.0f}});
+    auto second = profiles.intern({{0.0f, 60.0f}, {6.0f, 20.0f}});
+
+    ASSERT_EQ(first, second);
+    ASSERT_EQ(1, profiles.size());
+
+    // Between 0:00 and 6:00 the speed falls linearly from 60 to 20, so
+    // the whole stretch covers (60 + 20) / 2 * 6 = 240 miles.
+    ASSERT_NEAR(6.0, first->travelHours(240.0, 0.0), 1e-9);
+    ASSERT_NEAR(40.0, first->speedAt(3.0), 1e-9);
+}
+
+TEST(Digraph_ShortestPathTests, repairedTreeMatchesFreshSearch)
+{
+    Digraph<int, double> d;
+
+    for (int i = 0; i < 40; ++i)
+    {
+        d.addVertex(i, i);
+    }
+
+    unsigned int seed = 12345;
+    auto next = [&]() { seed = seed * 1103515245 + 12345; return (seed >> 8) % 1000; };
+
+    for (int i = 0; i < 40; ++i)
+    {
+        for (int j = 0; j < 40; ++j)
+        {
+            if (i != j && next() < 120)
+            {
+                d.addEdge(i, j, 1.0 + next() / 100.0);
+            }
+        }
+    }
+
+    ShortestPathTree<int, double> tree{d, 0, weightOf};
+
+    for (int round = 0; round < 20; ++round)
+    {
+        std::vector<std::pair<int, int>> edges = d.edges();
+        std::vector<std::pair<int, int>> changed;
+
+        for (int k = 0; k < 5; ++k)
+        {
+            std::pair<int, int> edge = edges[next() % edges.size()];
+            d.updateEdge(edge.first, edge.second, 0.5 + next() / 50.0);
+            changed.push_back(edge);
+        }
+
+        tree.repair(changed);
+
+        ShortestPathTree<int, double> fresh{d, 0, weightOf};
+
+        for (int v = 0; v < 40; ++v)
+        {
+            ASSERT_DOUBLE_EQ(fresh.distanceTo(v), tree.distanceTo(v));
+        }
+    }
+}
+
+
+TEST(Digraph_ShortestPathTests, deltaSteppingMatchesDijkstra)
+{
+    Digraph<int, double> d;
+
+    for (int i = 0; i < 200; ++i)
+    {
+        d.addVertex(i * 3, i);
+    }
+
+    unsigned int seed = 777;
+    auto next = [&]() { seed = seed * 1103515245 + 12345; return (seed >> 8) % 1000; };
+
+    for (int i = 0; i < 200; ++i)
+    {
+        for (int k = 0; k < 4; ++k)
+        {
+            int j = next() % 200;
+
+            if (j != i && d.edgeCount(i * 3) < 4)
+            {
+                try
+                {
+                    d.addEdge(i * 3, j * 3, next() % 5 == 0 ? 0.0 : 0.25 + next() / 97.0);
+                }
+                catch (DigraphException&)
+                {
+                }
+            }
+        }
+    }
+
+    // Zero-mile roads both ways between neighbors tie their distances,
+    // which mustn't make them each other's parents.
+    for (int i = 1; i < 199; i += 7)
+    {
+        for (int j : {i + 1, i - 1})
+        {
+            try
+            {
+                d.addEdge(i * 3, j * 3, 0.0);
+            }
+            catch (DigraphException&)
+            {
+            }
+        }
+    }
+
+    CompactDigraph graph{d, std::function<double(const double&)>{weightOf}};
+    ShortestPathTree<int, double> tree{d, 0, weightOf};
+
+    // The buckets are reused in a ring, which a width of 2.0 wraps around
+    // several times; a tiny width leaves almost every bucket empty, and
+    // those have to be skipped over rather than stepped through.
+    for (double width : {2.0, 0.001})
+    {
+        for (unsigned int threads : {1u, 4u})
+        {
+            std::vector<double> distances;
+            std::vector<int> parents;
+            DeltaStepping{width, threads}.findDistances(graph, 0, distances, parents);
+
+            for (int i = 0; i < 200; ++i)
+            {
+                ASSERT_DOUBLE_EQ(tree.distanceTo(i * 3), distances[i]);
+
+                // Following parents from a reachable vertex has to reach the
+                // start without going around in circles.
+                if (parents[i] != -1)
+                {
+                    int steps = 0;
+
+                    for (int v = i; v != 0; v = parents[v])
+                    {
+                        ASSERT_GT(200, ++steps);
+                    }
+                }
+            }
+
+            std::map<int, int> paths = DeltaStepping{width, threads}.findShortestPaths(graph, 0);
+            ASSERT_EQ(200, paths.size());
+            ASSERT_EQ(tree.predecessors().size(), paths.size());
+        }
+    }
+}
+
+
+TEST(Digraph_ShortestPathTests, phastSweepsMatchDijkstra)
+{
+    Digraph<int, double> d;
+
+    for (int i = 0; i < 150; ++i)
+    {
+        d.addVertex(i, i);
+    }
+
+    unsigned int seed = 4242;
+    auto next = [&]() { seed = seed * 1103515245 + 12345; return (seed >> 8) % 1000; };
+
+    for (int i = 0; i < 150; ++i)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            int j = (i + 1 + next() % 20) % 150;
+
+            try
+            {
+                d.addEdge(i, j, 1.0 + next() / 100.0);
+            }
+            catch (DigraphException&)
+            {
+            }
+        }
+    }
+
+    CompactDigraph graph{d, std::function<double(const double&)>{weightOf}};
+    ContractionHierarchy hierarchy{graph};
+    Phast phast{hierarchy};
+
+    std::vector<int> sources;
+
+    for (int s = 0; s < 150; s += 7)
+    {
+        sources.push_back(s);
+    }
+
+    std::vector<std::vector<double>> all = phast.distancesFrom(sources);
+
+    for (std::size_t i = 0; i < sources.size(); ++i)
+    {
+        ShortestPathTree<int, double> tree{d, sources[i], weightOf};
+
+        for (int v = 0; v < 150; ++v)
+        {
+            if (tree.distanceTo(v) == all[i][v])
+            {
+                continue;
+            }
+
+            ASSERT_NEAR(tree.distanceTo(v), all[i][v], 1e-9);
+        }
+    }
+}
+
+
+TEST(Digraph_ShortestPathTests, alternativeRoutesAreDistinctAndBounded)
+{
+    // Three parallel corridors from 0 to 9 of increasing length, plus a
+    // long detour that's too much of a stretch to be offered.
+    RoadMap roadMap;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        roadMap.addVertex(i, "Location");
+    }
+
+    roadMap.addEdge(0, 1, RoadSegment{1.0, 60.0});
+    roadMap.addEdge(1, 9, RoadSegment{1.0, 60.0});
+    roadMap.addEdge(0, 2, RoadSegment{1.1, 60.0});
+    roadMap.addEdge(2, 9, RoadSegment{1.1, 60.0});
+    roadMap.addEdge(0, 3, RoadSegment{1.2, 60.0});
+    roadMap.addEdge(3, 9, RoadSegment{1.2, 60.0});
+    roadMap.addEdge(0, 4, RoadSegment{5.0, 60.0});
+    roadMap.addEdge(4, 9, RoadSegment{5.0, 60.0});
+
+    AlternativeRouteFinder finder{roadMap, TripMetric::Distance};
+    std::vector<Route> routes = finder.findRoutes(0, 9, 5);
+
+    ASSERT_EQ(3, routes.size());
+    ASSERT_EQ((std::vector<int>{0, 1, 9}), routes[0].vertices);
+    ASSERT_EQ((std::vector<int>{0, 2, 9}), routes[1].vertices);
+    ASSERT_EQ((std::vector<int>{0, 3, 9}), routes[2].vertices);
+    ASSERT_DOUBLE_EQ(2.4, routes[2].miles);
+
+    // The same finder answers later trips without being rebuilt.
+    ASSERT_EQ(1, finder.findRoutes(0, 1, 5).size());
+    ASSERT_TRUE(finder.findRoutes(9, 0, 5).empty());
+}
+
+
+TEST(Digraph_ShortestPathTests, reachableSetStopsAtBudget)
+{
+    DigraphReachableSet reachable = makeDiamond().findReachable(1, 2.0, weightOf);
+
+    ASSERT_EQ(3, reachable.costs.size());
+    ASSERT_DOUBLE_EQ(1.0, reachable.costs[2]);
+    ASSERT_DOUBLE_EQ(2.0, reachable.costs[3]);
+    ASSERT_EQ(1, reachable.predecessors[3]);
+
+    std::sort(reachable.frontier.begin(), reachable.frontier.end());
+    ASSERT_EQ((std::vector<std::pair<int, int>>{{2, 4}, {3, 4}}), reachable.frontier);
+}
+
+
+TEST(Digraph_ShortestPathTests, nearestFacilitiesComeOutInOrder)
+{
+    // A line 0 - 1 - 2 - 3 - 4 with two-way roads one mile apart.
+    RoadMap roadMap;
+
+    for (int i = 0; i < 5; ++i)
+    {
+        roadMap.addVertex(i, "Location");
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+        roadMap.addEdge(i, i + 1, RoadSegment{1.0, 30.0});
+        roadMap.addEdge(i + 1, i, RoadSegment{1.0, 30.0});
+    }
+
+    NearestFacilityFinder finder{roadMap, TripMetric::Distance};
+
+    std::vector<Route> nearest = finder.findNearest({0, 4, 3}, 1, 2);
+
+    ASSERT_EQ(2, nearest.size());
+    ASSERT_EQ((std::vector<int>{0, 1}), nearest[0].vertices);
+    ASSERT_EQ((std::vector<int>{3, 2, 1}), nearest[1].vertices);
+
+    std::map<int, int> coverage = finder.findCoverage({0, 4});
+
+    ASSERT_EQ(0, coverage[1]);
+    ASSERT_EQ(4, coverage[3]);
+    ASSERT_EQ(4, coverage[4]);
+}
+
+
+TEST(Digraph_ShortestPathTests, multiStopTripsCanReorderStops)
+{
+    // Locations along a two-way road at mile 0, 1, 2, 3 and 4.
+    RoadMap roadMap;
+
+    for (int i = 0; i < 5; ++i)
+    {
+        roadMap.addVertex(i, "Location");
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+        roadMap.addEdge(i, i + 1, RoadSegment{1.0, 30.0});
+        roadMap.addEdge(i + 1, i, RoadSegment{1.0, 30.0});
+    }
+
+    Trip inOrder{0, 4, TripMetric::Distance};
+    inOrder.stops = {3, 1, 2};
+
+    Trip reordered = inOrder;
+    reordered.reorderStops = true;
+
+    std::vector<Route> routes = TripPlanner{}.planTrips(roadMap, {inOrder, reordered});
+
+    ASSERT_EQ(4, routes[0].legs.size());
+    ASSERT_DOUBLE_EQ(8.0, routes[0].miles);
+    ASSERT_DOUBLE_EQ(4.0, routes[1].miles);
+    ASSERT_EQ((std::vector<int>{0, 1, 2, 3, 4}), routes[1].vertices);
+    ASSERT_EQ((std::vector<int>{0, 1}), routes[1].legs[0].vertices);
+}
@@ -0,0 +1,193 @@
+// HugePageAllocator.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A HugePageAllocator is an allocator for standard containers that can
+// back large arrays with huge pages (2 MiB on x86-64, rather than 4 KiB),
+// so that a search sweeping across them needs far fewer TLB entries.
+// When huge pages are enabled, an allocation of at least hugePageBytes
+// is mapped on its own, aligned to and rounded up to a whole number of
+// huge pages, and the kernel is asked to back it with transparent huge
+// pages; smaller allocations, and every allocation when huge pages are
+// disabled, come from the ordinary heap.  If the kernel has transparent
+// huge pages turned off, the mapping simply uses ordinary pages.
+//
+// Allocators compare equal only when both have huge pages enabled or
+// both have them disabled, so memory is always freed the way it was
+// allocated.
+
+#ifndef HUGEPAGEALLOCATOR_HPP
+#define HUGEPAGEALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include <sys/mman.h>
+#include "MemoryFootprint.hpp"
+
+
+
+constexpr std::size_t hugePageBytes = std::size_t{2} << 20;
+
+
+
+template <typename T>
+class HugePageAllocator
+{
+public:
+    using value_type = T;
+
+    // Whether huge pages are enabled travels with a container's contents
+    // when it's copied, moved, or swapped.
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    // Initializes a HugePageAllocator, with huge pages disabled unless
+    // enabled is true.
+    explicit HugePageAllocator(bool enabled = false) noexcept;
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>& other) noexcept;
+
+    bool hugePagesEnabled() const noexcept;
+
+    T* allocate(std::size_t n);
+    void deallocate(T* p, std::size_t n) noexcept;
+
+    // mappedBytes() returns the bytes occupied by an allocation of n
+    // elements: whole huge pages if it was mapped on its own, or a heap
+    // block otherwise.
+    std::size_t mappedBytes(std::size_t n) const noexcept;
+
+private:
+    // isMapped() returns true if an allocation of n elements is mapped
+    // on its own.
+    bool isMapped(std::size_t n) const noexcept;
+
+    bool enabled_;
+};
+
+
+template <typename T, typename U>
+bool operator==(const HugePageAllocator<T>& a, const HugePageAllocator<U>& b) noexcept
+{
+    return a.hugePagesEnabled() == b.hugePagesEnabled();
+}
+
+
+template <typename T, typename U>
+bool operator!=(const HugePageAllocator<T>& a, const HugePageAllocator<U>& b) noexcept
+{
+    return !(a == b);
+}
+
+
+// HugePageVector is a std::vector whose storage comes from a
+// HugePageAllocator.
+template <typename T>
+using HugePageVector = std::vector<T, HugePageAllocator<T>>;
+
+
+template <typename T>
+std::size_t heapBytes(const HugePageVector<T>& v) noexcept
+{
+    return v.get_allocator().mappedBytes(v.capacity());
+}
+
+
+
+template <typename T>
+HugePageAllocator<T>::HugePageAllocator(bool enabled) noexcept
+    : enabled_{enabled}
+{
+}
+
+
+template <typename T>
+template <typename U>
+HugePageAllocator<T>::HugePageAllocator(const HugePageAllocator<U>& other) noexcept
+    : enabled_{other.hugePagesEnabled()}
+{
+}
+
+
+template <typename T>
+bool HugePageAllocator<T>::hugePagesEnabled() const noexcept
+{
+    return enabled_;
+}
+
+
+template <typename T>
+T* HugePageAllocator<T>::allocate(std::size_t n)
+{
+    if (!isMapped(n))
+    {
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    // mmap() only promises ordinary page alignment, so an extra huge page
+    // is mapped and the unaligned ends are given back.
+    std::size_t bytes = mappedBytes(n);
+    void* mapped = mmap(nullptr, bytes + hugePageBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (mapped == MAP_FAILED)
+    {
+        throw std::bad_alloc{};
+    }
+
+    std::uintptr_t start = reinterpret_cast<std::uintptr_t>(mapped);
+    std::uintptr_t aligned = (start + hugePageBytes - 1) & ~(hugePageBytes - 1);
+
+    if (aligned > start)
+    {
+        munmap(mapped, aligned - start);
+    }
+
+    munmap(reinterpret_cast<void*>(aligned + bytes), start + hugePageBytes - aligned);
+
+    madvise(reinterpret_cast<void*>(aligned), bytes, MADV_HUGEPAGE);
+    return reinterpret_cast<T*>(aligned);
+}
+
+
+template <typename T>
+void HugePageAllocator<T>::deallocate(T* p, std::size_t n) noexcept
+{
+    if (isMapped(n))
+    {
+        munmap(p, mappedBytes(n));
+    }
+    else
+    {
+        ::operator delete(p);
+    }
+}
+
+
+template <typename T>
+std::size_t HugePageAllocator<T>::mappedBytes(std::size_t n) const noexcept
+{
+    if (!isMapped(n))
+    {
+        return heapBlockBytes(n * sizeof(T));
+    }
+
+    return (n * sizeof(T) + hugePageBytes - 1) & ~(hugePageBytes - 1);
+}
+
+
+template <typename T>
+bool HugePageAllocator<T>::isMapped(std::size_t n) const noexcept
+{
+    return enabled_ && n * sizeof(T) >= hugePageBytes;
+}
+
+
+
+#endif
+
@@ -0,0 +1,39 @@
+// HugePageAllocator_Tests.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// Unit tests for HugePageAllocator, through the HugePageVector it's used
+// in.  Whether the kernel actually backs a mapping with huge pages can't
+// be observed portably, so the tests check what the allocator controls:
+// which arrays are mapped, their alignment, and what they're counted as.
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include "HugePageAllocator.hpp"
+
+
+TEST(HugePageAllocator_Tests, largeArraysAreMappedOnHugePageBoundaries)
+{
+    HugePageVector<double> large(hugePageBytes, 1.0, HugePageAllocator<double>{true});
+
+    ASSERT_EQ(0u, reinterpret_cast<std::uintptr_t>(large.data()) % hugePageBytes);
+    ASSERT_EQ(sizeof(double) * hugePageBytes, heapBytes(large));
+    ASSERT_EQ(1.0, large.back());
+}
+
+
+TEST(HugePageAllocator_Tests, smallArraysComeFromTheHeap)
+{
+    HugePageVector<double> small(8, 1.0, HugePageAllocator<double>{true});
+
+    ASSERT_EQ(heapBlockBytes(8 * sizeof(double)), heapBytes(small));
+}
+
+
+TEST(HugePageAllocator_Tests, disabledAllocatorNeverMaps)
+{
+    HugePageVector<double> large(hugePageBytes, 1.0, HugePageAllocator<double>{false});
+
+    ASSERT_EQ(heapBlockBytes(sizeof(double) * hugePageBytes), heapBytes(large));
+}
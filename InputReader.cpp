@@ -3,6 +3,7 @@
 // ICS 46 Winter 2022
 // Project #5: Rock and Roll Stops the Traffic
 
+#include <utility>
 #include "InputReader.hpp"
 
 
@@ -29,6 +30,12 @@ namespace
 
 std::string InputReader::readLine()
 {
+    if (hasPeeked_)
+    {
+        hasPeeked_ = false;
+        return std::move(peeked_);
+    }
+
     std::string line;
 
     while (true)
@@ -44,6 +51,31 @@ std::string InputReader::readLine()
 }
 
 
+std::string InputReader::peekLine()
+{
+    if (hasPeeked_)
+    {
+        return peeked_;
+    }
+
+    std::string line;
+
+    while (std::getline(in_, line))
+    {
+        trimRight(line);
+
+        if (line.length() > 0 && line[0] != '#')
+        {
+            peeked_ = line;
+            hasPeeked_ = true;
+            return line;
+        }
+    }
+
+    return "";
+}
+
+
 int InputReader::readIntLine()
 {
     std::string line = readLine();
@@ -33,14 +33,22 @@ public:
     // integer value (e.g., "7").
     int readIntLine();
 
+    // peekLine() returns the line that the next call to readLine() will
+    // return, without consuming it, or an empty string if the input has
+    // no more meaningful lines.  This allows optional sections of the
+    // input to be recognized by their first line.
+    std::string peekLine();
+
 private:
     std::istream& in_;
+    std::string peeked_;
+    bool hasPeeked_;
 };
 
 
 
 inline InputReader::InputReader(std::istream& in)
-    : in_{in}
+    : in_{in}, hasPeeked_{false}
 {
 }
 
@@ -0,0 +1,141 @@
+// LatencyHistogram.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <cmath>
+#include "LatencyHistogram.hpp"
+
+
+namespace
+{
+    // Times below 2 * subBuckets are counted exactly, one bucket each;
+    // above that, each power of two gets subBuckets buckets.
+    constexpr unsigned int subBucketBits = 5;
+    constexpr std::uint64_t subBuckets = std::uint64_t{1} << subBucketBits;
+    constexpr std::size_t bucketCount = 2 * subBuckets + (64 - subBucketBits - 1) * subBuckets;
+
+
+    unsigned int highestBit(std::uint64_t value) noexcept
+    {
+        unsigned int bit = 0;
+
+        while (value >>= 1)
+        {
+            bit++;
+        }
+
+        return bit;
+    }
+}
+
+
+LatencyHistogram::LatencyHistogram()
+    : counts_(bucketCount, 0), count_{0}, totalNanoseconds_{0}, maxNanoseconds_{0}
+{
+}
+
+
+void LatencyHistogram::record(std::chrono::nanoseconds latency) noexcept
+{
+    std::uint64_t nanoseconds = latency.count() > 0 ? static_cast<std::uint64_t>(latency.count()) : 0;
+
+    counts_[bucketOf(nanoseconds)]++;
+    count_++;
+    totalNanoseconds_ += nanoseconds;
+    maxNanoseconds_ = std::max(maxNanoseconds_, nanoseconds);
+}
+
+
+void LatencyHistogram::merge(const LatencyHistogram& other) noexcept
+{
+    for (std::size_t i = 0; i < counts_.size(); ++i)
+    {
+        counts_[i] += other.counts_[i];
+    }
+
+    count_ += other.count_;
+    totalNanoseconds_ += other.totalNanoseconds_;
+    maxNanoseconds_ = std::max(maxNanoseconds_, other.maxNanoseconds_);
+}
+
+
+std::uint64_t LatencyHistogram::count() const noexcept
+{
+    return count_;
+}
+
+
+std::chrono::nanoseconds LatencyHistogram::percentile(double percentage) const noexcept
+{
+    if (count_ == 0)
+    {
+        return std::chrono::nanoseconds{0};
+    }
+
+    double clamped = std::min(100.0, std::max(0.0, percentage));
+    std::uint64_t rank = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(clamped / 100.0 * count_)));
+
+    std::uint64_t seen = 0;
+
+    for (std::size_t i = 0; i < counts_.size(); ++i)
+    {
+        seen += counts_[i];
+
+        if (seen >= rank)
+        {
+            // The bucket's limit can overshoot the largest time actually
+            // recorded, which is known exactly.
+            return std::chrono::nanoseconds{
+                static_cast<std::int64_t>(std::min(bucketLimit(i), maxNanoseconds_))};
+        }
+    }
+
+    return max();
+}
+
+
+std::chrono::nanoseconds LatencyHistogram::mean() const noexcept
+{
+    return std::chrono::nanoseconds{
+        count_ == 0 ? 0 : static_cast<std::int64_t>(totalNanoseconds_ / count_)};
+}
+
+
+std::chrono::nanoseconds LatencyHistogram::max() const noexcept
+{
+    return std::chrono::nanoseconds{static_cast<std::int64_t>(maxNanoseconds_)};
+}
+
+
+std::size_t LatencyHistogram::bucketOf(std::uint64_t nanoseconds) noexcept
+{
+    if (nanoseconds < 2 * subBuckets)
+    {
+        return static_cast<std::size_t>(nanoseconds);
+    }
+
+    // The value's top subBucketBits + 1 bits choose its bucket, with the
+    // bits below them discarded.
+    unsigned int shift = highestBit(nanoseconds) - subBucketBits;
+
+    return 2 * subBuckets + (shift - 1) * subBuckets
+        + static_cast<std::size_t>((nanoseconds >> shift) - subBuckets);
+}
+
+
+std::uint64_t LatencyHistogram::bucketLimit(std::size_t bucket) noexcept
+{
+    if (bucket < 2 * subBuckets)
+    {
+        return bucket;
+    }
+
+    unsigned int shift = static_cast<unsigned int>((bucket - 2 * subBuckets) / subBuckets) + 1;
+    std::uint64_t top = subBuckets + (bucket - 2 * subBuckets) % subBuckets;
+
+    return ((top + 1) << shift) - 1;
+}
+
@@ -0,0 +1,64 @@
+// LatencyHistogram.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A LatencyHistogram records how long a large number of operations took,
+// cheaply enough to be done for every one of them, and can then report
+// percentiles of those times.  Rather than keeping every time, it counts
+// them in buckets whose width grows with their size, in the style of an
+// HDR histogram: each power of two is split into 32 equal buckets, so a
+// reported time is never more than about 3% above the true one, across
+// the whole range from nanoseconds to centuries.
+//
+// Recording is not synchronized; when operations run on several threads,
+// give each thread its own LatencyHistogram and merge() them afterward.
+
+#ifndef LATENCYHISTOGRAM_HPP
+#define LATENCYHISTOGRAM_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    // record() adds one operation that took the given amount of time.
+    // Negative times are recorded as zero.
+    void record(std::chrono::nanoseconds latency) noexcept;
+
+    // merge() adds every operation recorded in another histogram.
+    void merge(const LatencyHistogram& other) noexcept;
+
+    std::uint64_t count() const noexcept;
+
+    // percentile() returns a time that at least the given percentage
+    // (between 0 and 100) of the recorded operations took no longer than.
+    // With nothing recorded, it returns zero.
+    std::chrono::nanoseconds percentile(double percentage) const noexcept;
+
+    std::chrono::nanoseconds mean() const noexcept;
+    std::chrono::nanoseconds max() const noexcept;
+
+private:
+    // bucketOf() returns the bucket in which the given time is counted,
+    // and bucketLimit() returns the largest time counted in a bucket.
+    static std::size_t bucketOf(std::uint64_t nanoseconds) noexcept;
+    static std::uint64_t bucketLimit(std::size_t bucket) noexcept;
+
+    std::vector<std::uint64_t> counts_;
+    std::uint64_t count_;
+    std::uint64_t totalNanoseconds_;
+    std::uint64_t maxNanoseconds_;
+};
+
+
+
+#endif
+
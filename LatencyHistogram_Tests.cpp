@@ -0,0 +1,129 @@
+// LatencyHistogram_Tests.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// Unit tests for LatencyHistogram, checking where its bucket boundaries
+// fall, how close its percentiles come to the times recorded, and that
+// merging histograms is the same as recording into one.
+
+#include <chrono>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include "LatencyHistogram.hpp"
+
+
+namespace
+{
+    std::chrono::nanoseconds ns(std::int64_t count)
+    {
+        return std::chrono::nanoseconds{count};
+    }
+}
+
+
+TEST(LatencyHistogram_Tests, emptyHistogramReportsZero)
+{
+    LatencyHistogram histogram;
+
+    ASSERT_EQ(0, histogram.count());
+    ASSERT_EQ(ns(0), histogram.percentile(50));
+    ASSERT_EQ(ns(0), histogram.mean());
+    ASSERT_EQ(ns(0), histogram.max());
+}
+
+
+TEST(LatencyHistogram_Tests, smallTimesAreCountedExactly)
+{
+    LatencyHistogram histogram;
+    histogram.record(ns(-5));
+
+    for (std::int64_t t = 1; t < 64; ++t)
+    {
+        histogram.record(ns(t));
+    }
+
+    ASSERT_EQ(64, histogram.count());
+    ASSERT_EQ(ns(0), histogram.percentile(0));
+    ASSERT_EQ(ns(31), histogram.percentile(50));
+    ASSERT_EQ(ns(63), histogram.percentile(100));
+}
+
+
+TEST(LatencyHistogram_Tests, largerTimesShareBucketsTwoUnitsWideAndUp)
+{
+    // From 64 on, each power of two is split into 32 buckets, so 64 and
+    // 65 share a bucket whose limit is 65, and 66 starts the next one.
+    for (std::int64_t t : {64, 65})
+    {
+        LatencyHistogram histogram;
+        histogram.record(ns(t));
+        histogram.record(ns(1000000));
+
+        ASSERT_EQ(ns(65), histogram.percentile(50));
+    }
+
+    LatencyHistogram histogram;
+    histogram.record(ns(66));
+    histogram.record(ns(1000000));
+    ASSERT_EQ(ns(67), histogram.percentile(50));
+
+    // 2^k - 1 is always the limit of its bucket.
+    histogram.record(ns((std::int64_t{1} << 40) - 1));
+    ASSERT_EQ(ns((std::int64_t{1} << 40) - 1), histogram.percentile(100));
+}
+
+
+TEST(LatencyHistogram_Tests, percentilesOvershootByAtMostThreePercent)
+{
+    for (std::int64_t t = 64; t < (std::int64_t{1} << 50); t = t * 17 / 16 + 1)
+    {
+        LatencyHistogram histogram;
+        histogram.record(ns(t));
+        histogram.record(ns(std::int64_t{1} << 62));
+
+        std::int64_t reported = histogram.percentile(50).count();
+        ASSERT_LE(t, reported);
+        ASSERT_LE(reported, t + t / 32);
+    }
+}
+
+
+TEST(LatencyHistogram_Tests, percentilesNeverExceedTheLargestTime)
+{
+    LatencyHistogram histogram;
+    histogram.record(ns(1000));
+    histogram.record(ns(5000));
+
+    // 1000 is counted in a bucket that runs up to 1007.
+    ASSERT_EQ(ns(1007), histogram.percentile(50));
+    ASSERT_EQ(ns(5000), histogram.percentile(51));
+    ASSERT_EQ(ns(5000), histogram.percentile(100));
+    ASSERT_EQ(ns(5000), histogram.max());
+    ASSERT_EQ(ns(3000), histogram.mean());
+}
+
+
+TEST(LatencyHistogram_Tests, mergingIsLikeRecordingIntoOne)
+{
+    LatencyHistogram first;
+    LatencyHistogram second;
+    LatencyHistogram both;
+
+    for (std::int64_t t = 1; t <= 1000; ++t)
+    {
+        (t % 3 == 0 ? first : second).record(ns(t * t));
+        both.record(ns(t * t));
+    }
+
+    first.merge(second);
+
+    ASSERT_EQ(both.count(), first.count());
+    ASSERT_EQ(both.mean(), first.mean());
+    ASSERT_EQ(both.max(), first.max());
+
+    for (double percentage : {0.0, 10.0, 50.0, 90.0, 99.0, 99.9, 100.0})
+    {
+        ASSERT_EQ(both.percentile(percentage), first.percentile(percentage));
+    }
+}
@@ -0,0 +1,291 @@
+// LocationIndex.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <limits>
+#include "LocationIndex.hpp"
+
+
+namespace
+{
+    // The FNV-1a hash, which is simple and spreads short strings well.
+    std::uint64_t hashOf(std::string_view name) noexcept
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+
+        for (char c : name)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+}
+
+
+LocationIndex::LocationIndex(const RoadMap& roadMap)
+    : pool_{roadMap.namePool()}, vertices_{roadMap.vertices()}
+{
+    std::sort(vertices_.begin(), vertices_.end());
+
+    if (vertices_.size() >= emptySlot)
+    {
+        throw DigraphException("Too many locations to index");
+    }
+
+    const std::uint32_t n = static_cast<std::uint32_t>(vertices_.size());
+    names_.reserve(n);
+
+    for (int vertex : vertices_)
+    {
+        names_.push_back(roadMap.vertexInfo(vertex));
+    }
+
+    // The table is kept at most half full, so probes stay short.
+    std::size_t slotCount = 1;
+
+    while (slotCount < 2 * static_cast<std::size_t>(n))
+    {
+        slotCount *= 2;
+    }
+
+    slots_.assign(slotCount, emptySlot);
+
+    for (std::uint32_t entry = 0; entry < n; ++entry)
+    {
+        std::size_t slot = slotFor(nameAt(entry));
+
+        while (slots_[slot] != emptySlot && nameAt(slots_[slot]) != nameAt(entry))
+        {
+            slot = (slot + 1) & (slots_.size() - 1);
+        }
+
+        // Entries are added in ascending vertex order, so an existing
+        // entry with the same name has the lower vertex number.
+        if (slots_[slot] == emptySlot)
+        {
+            slots_[slot] = entry;
+        }
+    }
+
+    sorted_.resize(n);
+
+    for (std::uint32_t entry = 0; entry < n; ++entry)
+    {
+        sorted_[entry] = entry;
+    }
+
+    std::stable_sort(
+        sorted_.begin(), sorted_.end(),
+        [this](std::uint32_t a, std::uint32_t b) { return nameAt(a) < nameAt(b); });
+}
+
+
+std::size_t LocationIndex::size() const noexcept
+{
+    return vertices_.size() - removed_.size() + added_.size();
+}
+
+
+std::optional<int> LocationIndex::findVertex(std::string_view name) const
+{
+    std::optional<int> found = findInPool(name);
+
+    if (!addedNames_.empty())
+    {
+        auto added = addedNames_.lower_bound({std::string{name}, std::numeric_limits<int>::min()});
+
+        if (added != addedNames_.end() && added->first == name && (!found || added->second < *found))
+        {
+            found = added->second;
+        }
+    }
+
+    return found;
+}
+
+
+std::string_view LocationIndex::nameOf(int vertex) const
+{
+    auto added = added_.find(vertex);
+
+    if (added != added_.end())
+    {
+        return added->second;
+    }
+
+    std::optional<std::uint32_t> entry = findEntry(vertex);
+
+    if (!entry)
+    {
+        throw DigraphException("No such vertex: " + std::to_string(vertex));
+    }
+
+    return nameAt(*entry);
+}
+
+
+std::vector<int> LocationIndex::completions(std::string_view prefix, std::size_t limit) const
+{
+    auto base = std::lower_bound(
+        sorted_.begin(), sorted_.end(), prefix,
+        [this](std::uint32_t entry, std::string_view prefix) { return nameAt(entry) < prefix; });
+
+    auto added = addedNames_.lower_bound({std::string{prefix}, std::numeric_limits<int>::min()});
+
+    auto matches = [&](std::string_view name)
+    {
+        return name.substr(0, prefix.size()) == prefix;
+    };
+
+    // Both the pool and the overlay are in order of (name, vertex), so
+    // the completions are the two merged, skipping removed locations.
+    std::vector<int> result;
+
+    while (result.size() < limit)
+    {
+        while (base != sorted_.end() && removed_.count(vertices_[*base]) > 0)
+        {
+            ++base;
+        }
+
+        bool baseMatches = base != sorted_.end() && matches(nameAt(*base));
+        bool addedMatches = added != addedNames_.end() && matches(added->first);
+
+        if (!baseMatches && !addedMatches)
+        {
+            break;
+        }
+
+        if (baseMatches && (!addedMatches
+            || std::make_pair(nameAt(*base), vertices_[*base]) < std::make_pair(std::string_view{added->first}, added->second)))
+        {
+            result.push_back(vertices_[*base]);
+            ++base;
+        }
+        else
+        {
+            result.push_back(added->second);
+            ++added;
+        }
+    }
+
+    return result;
+}
+
+
+void LocationIndex::addLocation(int vertex, std::string_view name)
+{
+    if (added_.count(vertex) > 0 || findEntry(vertex))
+    {
+        throw DigraphException("Vertex already exists: " + std::to_string(vertex));
+    }
+
+    added_.emplace(vertex, std::string{name});
+    addedNames_.emplace(std::string{name}, vertex);
+}
+
+
+void LocationIndex::removeLocation(int vertex)
+{
+    auto added = added_.find(vertex);
+
+    if (added != added_.end())
+    {
+        addedNames_.erase({added->second, vertex});
+        added_.erase(added);
+    }
+    else if (findEntry(vertex))
+    {
+        removed_.insert(vertex);
+    }
+    else
+    {
+        throw DigraphException("No such vertex: " + std::to_string(vertex));
+    }
+}
+
+
+MemoryFootprint LocationIndex::memoryFootprint() const
+{
+    MemoryFootprint footprint;
+    footprint.add("names", sizeof(*this) + heapBytes(vertices_) + heapBytes(names_));
+    footprint.add("hash table", heapBytes(slots_));
+    footprint.add("sorted names", heapBytes(sorted_));
+
+    std::size_t overlayBytes = removed_.size() * heapBlockBytes(treeNodeOverhead + sizeof(int));
+
+    for (const auto& added : added_)
+    {
+        overlayBytes += heapBlockBytes(treeNodeOverhead + sizeof(added)) + heapBytes(added.second);
+        overlayBytes += heapBlockBytes(treeNodeOverhead + sizeof(std::pair<std::string, int>)) + heapBytes(added.second);
+    }
+
+    footprint.add("overlay", overlayBytes);
+
+    return footprint;
+}
+
+
+std::string_view LocationIndex::nameAt(std::uint32_t entry) const noexcept
+{
+    return names_[entry];
+}
+
+
+std::size_t LocationIndex::slotFor(std::string_view name) const noexcept
+{
+    return static_cast<std::size_t>(hashOf(name)) & (slots_.size() - 1);
+}
+
+
+
+std::optional<std::uint32_t> LocationIndex::findEntry(int vertex) const noexcept
+{
+    auto found = std::lower_bound(vertices_.begin(), vertices_.end(), vertex);
+
+    if (found == vertices_.end() || *found != vertex || removed_.count(vertex) > 0)
+    {
+        return std::nullopt;
+    }
+
+    return static_cast<std::uint32_t>(found - vertices_.begin());
+}
+
+
+std::optional<int> LocationIndex::findInPool(std::string_view name) const noexcept
+{
+    for (std::size_t slot = slotFor(name); slots_[slot] != emptySlot; slot = (slot + 1) & (slots_.size() - 1))
+    {
+        if (nameAt(slots_[slot]) != name)
+        {
+            continue;
+        }
+
+        if (removed_.count(vertices_[slots_[slot]]) == 0)
+        {
+            return vertices_[slots_[slot]];
+        }
+
+        // The hash table only holds the lowest-numbered location with each
+        // name; if it's been removed, the others are found in name order.
+        auto first = std::lower_bound(
+            sorted_.begin(), sorted_.end(), name,
+            [this](std::uint32_t entry, std::string_view name) { return nameAt(entry) < name; });
+
+        for (auto i = first; i != sorted_.end() && nameAt(*i) == name; ++i)
+        {
+            if (removed_.count(vertices_[*i]) == 0)
+            {
+                return vertices_[*i];
+            }
+        }
+
+        break;
+    }
+
+    return std::nullopt;
+}
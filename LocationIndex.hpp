@@ -0,0 +1,130 @@
+// LocationIndex.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A LocationIndex finds locations in a RoadMap by name.  It's built once,
+// when the map is loaded, and isn't affected by later changes to the
+// RoadMap, except that locations can be added to and removed from it
+// one at a time as the RoadMap is edited (see MapDelta.hpp).
+//
+// The index doesn't copy any names.  It keeps hold of the RoadMap's pool
+// of names (see LocationNamePool.hpp), which never moves a name once it's
+// there, and refers to each location's name with a view into it, so the
+// index needs a few dozen bytes per location and nothing for the names
+// themselves.  Two indexes are built over the names: an open-addressing
+// hash table, which finds the location with an exact name in constant
+// time, and a list of locations sorted by name, which finds every name
+// beginning with a given prefix (e.g., for autocompletion) with a binary
+// search.
+//
+// The names and their indexes are never changed after they're built, since
+// inserting into them would take time proportional to the whole index.
+// Instead, locations added later are kept in a small ordered overlay and
+// locations removed later are only marked as gone; lookups consult both.
+// When the overlay grows large, building a new LocationIndex from the
+// RoadMap folds it back in.
+//
+// When several locations share a name, lookups by that name find the
+// lowest-numbered one.
+
+#ifndef LOCATIONINDEX_HPP
+#define LOCATIONINDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "LocationNamePool.hpp"
+#include "MemoryFootprint.hpp"
+#include "RoadMap.hpp"
+
+
+
+class LocationIndex
+{
+public:
+    // Initializes a LocationIndex of the names of every location in the
+    // given RoadMap.
+    explicit LocationIndex(const RoadMap& roadMap);
+
+    // size() returns the number of locations in the index.
+    std::size_t size() const noexcept;
+
+    // findVertex() returns the vertex number of the location with the
+    // given name, or std::nullopt if there is none.
+    std::optional<int> findVertex(std::string_view name) const;
+
+    // nameOf() returns the name of the given vertex, which remains valid
+    // for as long as the vertex stays in the LocationIndex.  If there is
+    // no such vertex, a DigraphException is thrown instead.
+    std::string_view nameOf(int vertex) const;
+
+    // completions() returns the vertex numbers of up to limit locations
+    // whose names begin with the given prefix, in order of their names.
+    std::vector<int> completions(std::string_view prefix, std::size_t limit) const;
+
+    // addLocation() adds a location with the given vertex number and name.
+    // If the vertex is already in the index, a DigraphException is thrown
+    // instead.
+    void addLocation(int vertex, std::string_view name);
+
+    // removeLocation() removes the location with the given vertex number.
+    // If there is no such vertex, a DigraphException is thrown instead.
+    void removeLocation(int vertex);
+
+    // memoryFootprint() returns the bytes that this LocationIndex occupies:
+    // its views of the names, its hash table, its sorted list, and its
+    // overlay.  The names themselves belong to the RoadMap's pool.
+    MemoryFootprint memoryFootprint() const;
+
+private:
+    // nameAt() returns the name of the location at the given position in
+    // vertices_.
+    std::string_view nameAt(std::uint32_t entry) const noexcept;
+
+    // slotFor() returns the position in slots_ at which a lookup of the
+    // given name starts probing.
+    std::size_t slotFor(std::string_view name) const noexcept;
+
+    // findEntry() returns the position in vertices_ of the given vertex,
+    // or std::nullopt if it isn't there or has been removed.
+    std::optional<std::uint32_t> findEntry(int vertex) const noexcept;
+
+    // findInPool() returns the lowest vertex number in the pool with the
+    // given name that hasn't been removed.
+    std::optional<int> findInPool(std::string_view name) const noexcept;
+
+    std::shared_ptr<const LocationNamePool> pool_;
+
+    // The name of the location vertices_[i] is names_[i], a view into the
+    // pool; vertices_ is in ascending order.
+    std::vector<int> vertices_;
+    std::vector<std::string_view> names_;
+
+    // The hash table holds positions in vertices_, with emptySlot marking
+    // the unused slots; its size is a power of two.
+    static constexpr std::uint32_t emptySlot = UINT32_MAX;
+    std::vector<std::uint32_t> slots_;
+
+    // Positions in vertices_, sorted by name (and, among equal names, in
+    // ascending order).
+    std::vector<std::uint32_t> sorted_;
+
+    // The overlay: locations added since the pool was built, keyed both
+    // by vertex and by (name, vertex), and the vertices of the pool that
+    // have been removed since.
+    std::map<int, std::string> added_;
+    std::set<std::pair<std::string, int>> addedNames_;
+    std::set<int> removed_;
+};
+
+
+
+#endif
+
@@ -0,0 +1,59 @@
+// LocationIndex_Tests.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// Unit tests for LocationIndex, and for TripReader's use of it to read
+// trips that name their locations.
+
+#include <optional>
+#include <stdexcept>
+#include <vector>
+#include <gtest/gtest.h>
+#include "LocationIndex.hpp"
+#include "TripReader.hpp"
+
+
+TEST(LocationIndex_Tests, namesResolveToVertices)
+{
+    RoadMap roadMap;
+    roadMap.addVertex(0, "Anteater Stadium");
+    roadMap.addVertex(1, "UCI Campus");
+    roadMap.addVertex(2, "Irvine Spectrum");
+    roadMap.addVertex(3, "Irvine Spectrum");
+    roadMap.addEdge(0, 1, RoadSegment{2.0, 25.0});
+    roadMap.addEdge(1, 2, RoadSegment{4.0, 60.0});
+
+    LocationIndex locations{roadMap};
+
+    ASSERT_EQ(std::optional<int>{1}, locations.findVertex("UCI Campus"));
+    ASSERT_EQ(std::optional<int>{2}, locations.findVertex("Irvine Spectrum"));
+    ASSERT_EQ(std::nullopt, locations.findVertex("Irvine"));
+    ASSERT_EQ("Anteater Stadium", locations.nameOf(0));
+    ASSERT_EQ((std::vector<int>{2, 3}), locations.completions("Irvine", 5));
+    ASSERT_EQ((std::vector<int>{0, 2}), locations.completions("", 2));
+
+    Trip trip = TripReader::parseTrip("\"Anteater Stadium\" 1 \"Irvine Spectrum\" D", &locations);
+    ASSERT_EQ(0, trip.startVertex);
+    ASSERT_EQ(std::vector<int>{1}, trip.stops);
+    ASSERT_EQ(2, trip.endVertex);
+
+    ASSERT_THROW(TripReader::parseTrip("\"Tustin\" 1 D", &locations), std::invalid_argument);
+    ASSERT_THROW(TripReader::parseTrip("\"UCI Campus\" 2 D"), std::invalid_argument);
+}
+
+
+TEST(LocationIndex_Tests, namesOutliveTheRoadMap)
+{
+    std::optional<LocationIndex> locations;
+
+    {
+        RoadMap roadMap;
+        roadMap.addVertex(0, "Anteater Stadium");
+        roadMap.addVertex(1, "UCI Campus");
+        locations.emplace(roadMap);
+    }
+
+    ASSERT_EQ("UCI Campus", locations->nameOf(1));
+    ASSERT_EQ(std::optional<int>{0}, locations->findVertex("Anteater Stadium"));
+}
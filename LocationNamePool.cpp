@@ -0,0 +1,40 @@
+// LocationNamePool.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include "LocationNamePool.hpp"
+#include "MemoryFootprint.hpp"
+
+
+std::string_view LocationNamePool::add(std::string_view name)
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+
+    if (name.size() > remaining_)
+    {
+        // Whatever is left of the last block is abandoned; a name is never
+        // split across blocks.
+        std::size_t size = std::max(blockSize, name.size());
+        blocks_.push_back(std::make_unique<char[]>(size));
+        next_ = blocks_.back().get();
+        remaining_ = size;
+        blockBytes_ += heapBlockBytes(size);
+    }
+
+    std::copy(name.begin(), name.end(), next_);
+    std::string_view added{next_, name.size()};
+    next_ += name.size();
+    remaining_ -= name.size();
+
+    return added;
+}
+
+
+std::size_t LocationNamePool::heapBytes() const
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    return blockBytes_ + ::heapBytes(blocks_);
+}
+
@@ -0,0 +1,56 @@
+// LocationNamePool.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A LocationNamePool holds the names of the locations in a RoadMap, one
+// after another in large blocks of characters, so that a location needs
+// only a std::string_view of its name rather than a std::string (which
+// takes 32 bytes, plus a heap block of its own for a long name).
+//
+// Names are only ever added, and the characters of a name never move once
+// it's been added, so a view of it stays valid for as long as the pool
+// does.  That's what lets copies of a RoadMap share one pool, even when
+// they're read and changed on different threads: adding a name takes a
+// lock, but reading one touches nothing but its own characters.
+
+#ifndef LOCATIONNAMEPOOL_HPP
+#define LOCATIONNAMEPOOL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+
+
+class LocationNamePool
+{
+public:
+    // add() copies the given name into the pool and returns a view of the
+    // copy.
+    std::string_view add(std::string_view name);
+
+    // heapBytes() returns the bytes that the pool's blocks occupy.
+    std::size_t heapBytes() const;
+
+private:
+    // Names are copied into blocks of this many characters; a name longer
+    // than that gets a block of its own.
+    static constexpr std::size_t blockSize = 4096;
+
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<char[]>> blocks_;
+
+    // The characters still unused at the end of the last block.
+    char* next_ = nullptr;
+    std::size_t remaining_ = 0;
+
+    std::size_t blockBytes_ = 0;
+};
+
+
+
+#endif
+
@@ -0,0 +1,111 @@
+// MapDelta.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <set>
+#include <utility>
+#include "MapDelta.hpp"
+
+
+MapDelta::MapDelta(std::vector<MapEdit> edits)
+    : edits_{std::move(edits)}
+{
+}
+
+
+const std::vector<MapEdit>& MapDelta::edits() const noexcept
+{
+    return edits_;
+}
+
+
+void MapDelta::applyTo(RoadMap& roadMap) const
+{
+    // The edits are made to a copy, which shares everything with the
+    // original except the vertices the edits touch, so a failure partway
+    // through can simply discard it.
+    RoadMap edited = roadMap;
+
+    for (const MapEdit& edit : edits_)
+    {
+        switch (edit.kind)
+        {
+        case MapEditKind::AddVertex:
+            edited.addVertex(edit.fromVertex, edit.name);
+            break;
+
+        case MapEditKind::RemoveVertex:
+            edited.removeVertex(edit.fromVertex);
+            break;
+
+        case MapEditKind::AddEdge:
+            edited.addEdge(edit.fromVertex, edit.toVertex, edit.segment);
+            break;
+
+        case MapEditKind::RemoveEdge:
+            edited.removeEdge(edit.fromVertex, edit.toVertex);
+            break;
+
+        case MapEditKind::SetSpeed:
+        {
+            RoadSegment segment = edited.edgeInfo(edit.fromVertex, edit.toVertex);
+            segment.milesPerHour = edit.segment.milesPerHour;
+            edited.updateEdge(edit.fromVertex, edit.toVertex, segment);
+            break;
+        }
+        }
+    }
+
+    roadMap = std::move(edited);
+}
+
+
+void MapDelta::applyTo(RoadMap& roadMap, LocationIndex& locations) const
+{
+    applyTo(roadMap);
+
+    // Every edit has been checked against the RoadMap by now, and the
+    // LocationIndex describes the same locations, so none of these can
+    // fail.
+    for (const MapEdit& edit : edits_)
+    {
+        if (edit.kind == MapEditKind::AddVertex)
+        {
+            locations.addLocation(edit.fromVertex, edit.name);
+        }
+        else if (edit.kind == MapEditKind::RemoveVertex)
+        {
+            locations.removeLocation(edit.fromVertex);
+        }
+    }
+}
+
+
+
+void MapDelta::applyTo(RoadMap& roadMap, LocationIndex& locations, TurnTable& turns) const
+{
+    applyTo(roadMap, locations);
+
+    // A removed location's road segments went with it, so its rules are
+    // found by the location alone.
+    std::set<std::pair<int, int>> segments;
+    std::set<int> vertices;
+
+    for (const MapEdit& edit : edits_)
+    {
+        if (edit.kind == MapEditKind::RemoveEdge)
+        {
+            segments.emplace(edit.fromVertex, edit.toVertex);
+        }
+        else if (edit.kind == MapEditKind::RemoveVertex)
+        {
+            vertices.insert(edit.fromVertex);
+        }
+    }
+
+    if (!turns.empty() && (!segments.empty() || !vertices.empty()))
+    {
+        turns.removeRulesOn(segments, vertices);
+    }
+}
@@ -0,0 +1,94 @@
+// MapDelta.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A MapDelta is a batch of edits to a RoadMap: locations and road segments
+// added or removed, and new speeds for existing segments.  Applying one
+// takes time proportional to the number of edits (and the degrees of the
+// vertices they touch), not to the size of the RoadMap, so a small daily
+// change never requires reloading the whole map.  Derived indexes that
+// depend on the edited parts of the map are brought up to date the same
+// way, rather than being rebuilt.
+//
+// Given the map's TurnTable, a road segment or location that's removed
+// takes the turn rules that mention it with it, so that they don't apply again to one added in its
+// place later on.
+//
+// Edits are applied in order, so a delta may, for example, add a location
+// and then road segments leading to it.  Deltas are read from text by a
+// MapDeltaReader.
+
+#ifndef MAPDELTA_HPP
+#define MAPDELTA_HPP
+
+#include <string>
+#include <vector>
+#include "LocationIndex.hpp"
+#include "RoadMap.hpp"
+#include "TurnTable.hpp"
+
+
+
+// A MapEdit describes one edit.  Which of its members matter depends on
+// its kind: AddVertex uses fromVertex and name; RemoveVertex uses only
+// fromVertex; AddEdge uses both vertices and the segment; RemoveEdge uses
+// both vertices; and SetSpeed uses both vertices and segment.milesPerHour.
+
+enum class MapEditKind
+{
+    AddVertex,
+    RemoveVertex,
+    AddEdge,
+    RemoveEdge,
+    SetSpeed
+};
+
+
+struct MapEdit
+{
+    MapEditKind kind;
+    int fromVertex;
+    int toVertex = 0;
+    std::string name = {};
+    RoadSegment segment = {0.0, 0.0};
+};
+
+
+
+class MapDelta
+{
+public:
+    // Initializes an empty MapDelta.
+    MapDelta() noexcept = default;
+
+    // Initializes a MapDelta made up of the given edits.
+    explicit MapDelta(std::vector<MapEdit> edits);
+
+    const std::vector<MapEdit>& edits() const noexcept;
+
+    // applyTo() applies every edit to the given RoadMap, in order.  If any
+    // of them can't be applied (e.g., it adds a vertex that already exists,
+    // or removes an edge that doesn't), a DigraphException is thrown and
+    // the RoadMap is left as it was.
+    void applyTo(RoadMap& roadMap) const;
+
+    // This overload of applyTo() also adds and removes the edited locations
+    // in the given LocationIndex, which must describe the same RoadMap.  If
+    // the edits can't be applied, neither is changed.
+    void applyTo(RoadMap& roadMap, LocationIndex& locations) const;
+
+    // This overload of applyTo() also removes, from the given TurnTable,
+    // every rule for a turn onto or off of a removed road segment, or from,
+    // at, or toward a removed location.  If the edits can't be applied,
+    // none of the three is changed.
+    void applyTo(RoadMap& roadMap, LocationIndex& locations, TurnTable& turns) const;
+
+private:
+    std::vector<MapEdit> edits_;
+};
+
+
+
+#endif
+
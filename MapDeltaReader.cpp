@@ -0,0 +1,95 @@
+// MapDeltaReader.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "MapDeltaReader.hpp"
+#include "RoadMapReader.hpp"
+
+
+MapDelta MapDeltaReader::readMapDelta(InputReader& in)
+{
+    SpeedProfilePool profiles;
+    std::vector<MapEdit> edits;
+
+    int numberOfEdits = in.readIntLine();
+    edits.reserve(numberOfEdits);
+
+    for (int i = 0; i < numberOfEdits; ++i)
+    {
+        edits.push_back(parseEdit(in.readLine(), profiles));
+    }
+
+    return MapDelta{std::move(edits)};
+}
+
+
+MapEdit MapDeltaReader::parseEdit(const std::string& line, SpeedProfilePool& profiles)
+{
+    std::istringstream editLine{line};
+
+    std::string action;
+    std::string target;
+    editLine >> action;
+
+    if (action == "add" || action == "remove")
+    {
+        editLine >> target;
+    }
+
+    MapEdit edit{MapEditKind::AddVertex, 0};
+
+    if (action == "add" && target == "vertex")
+    {
+        editLine >> edit.fromVertex >> std::ws;
+        std::getline(editLine, edit.name);
+    }
+    else if (action == "remove" && target == "vertex")
+    {
+        edit.kind = MapEditKind::RemoveVertex;
+        editLine >> edit.fromVertex;
+    }
+    else if (action == "add" && target == "edge")
+    {
+        edit.kind = MapEditKind::AddEdge;
+
+        if (editLine >> edit.fromVertex >> edit.toVertex)
+        {
+            edit.segment = RoadMapReader::readRoadSegment(editLine, profiles);
+            editLine.clear();
+        }
+    }
+    else if (action == "remove" && target == "edge")
+    {
+        edit.kind = MapEditKind::RemoveEdge;
+        editLine >> edit.fromVertex >> edit.toVertex;
+    }
+    else if (action == "speed")
+    {
+        edit.kind = MapEditKind::SetSpeed;
+        editLine >> edit.fromVertex >> edit.toVertex >> edit.segment.milesPerHour;
+    }
+    else
+    {
+        throw std::invalid_argument{"Not a map edit: " + line};
+    }
+
+    if (editLine.fail() || (edit.kind == MapEditKind::AddVertex && edit.name.empty()))
+    {
+        throw std::invalid_argument{"Incomplete map edit: " + line};
+    }
+
+    bool hasSpeed = edit.kind == MapEditKind::AddEdge || edit.kind == MapEditKind::SetSpeed;
+
+    if (hasSpeed && (!(edit.segment.miles >= 0.0) || !(edit.segment.milesPerHour > 0.0)))
+    {
+        throw std::invalid_argument{"Not a valid road segment: " + line};
+    }
+
+    return edit;
+}
+
@@ -0,0 +1,48 @@
+// MapDeltaReader.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A MapDeltaReader reads a MapDelta from the given input.  A delta is
+// written, like the sections of a map, as the number of edits followed by
+// one line per edit, with blank lines and lines beginning with '#' being
+// skipped:
+//
+//     add vertex 7 Irvine Spectrum
+//     remove vertex 7
+//     add edge 3 7 1.5 35
+//     remove edge 3 4
+//     speed 3 4 25
+//
+// An added road segment is written just as it would be in the map, and
+// so may end with a speed profile (e.g., "add edge 3 7 1.5 35 @ 0:00 65
+// 7:30 25"); a new speed replaces a segment's snapshot speed but leaves
+// its speed profile alone.
+
+#ifndef MAPDELTAREADER_HPP
+#define MAPDELTAREADER_HPP
+
+#include <string>
+#include "InputReader.hpp"
+#include "MapDelta.hpp"
+#include "SpeedProfile.hpp"
+
+
+
+class MapDeltaReader
+{
+public:
+    // readMapDelta() reads a MapDelta from the given input.  If an edit
+    // can't be parsed, a std::invalid_argument is thrown instead.
+    MapDelta readMapDelta(InputReader& in);
+
+    // parseEdit() converts one edit line into a MapEdit, interning any
+    // speed profile in the given SpeedProfilePool.  If the line isn't a
+    // valid edit, a std::invalid_argument is thrown instead.
+    static MapEdit parseEdit(const std::string& line, SpeedProfilePool& profiles);
+};
+
+
+
+#endif
+
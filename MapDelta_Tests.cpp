@@ -0,0 +1,123 @@
+// MapDelta_Tests.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// Unit tests for MapDelta and MapDeltaReader, checking that a day's
+// edits are read and applied to the map, its location index, and its
+// turn rules.
+
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include <gtest/gtest.h>
+#include "LocationIndex.hpp"
+#include "MapDeltaReader.hpp"
+
+
+TEST(MapDelta_Tests, editsMapAndLocationsInPlace)
+{
+    RoadMap roadMap;
+    roadMap.addVertex(0, "Anteater Stadium");
+    roadMap.addVertex(1, "Irvine Spectrum");
+    roadMap.addVertex(2, "Irvine Spectrum");
+    roadMap.addEdge(0, 1, RoadSegment{2.0, 25.0});
+    roadMap.addEdge(1, 2, RoadSegment{4.0, 60.0});
+    roadMap.addEdge(0, 2, RoadSegment{7.0, 60.0});
+
+    LocationIndex locations{roadMap};
+
+    std::istringstream input{
+        "# the day's edits\n"
+        "5\n"
+        "add vertex 3 Irvine Center\n"
+        "add edge 2 3 1.0 30 @ 0:00 30 7:30 10\n"
+        "remove vertex 1\n"
+        "remove edge 0 2\n"
+        "add edge 0 2 6.0 60\n"};
+
+    InputReader in{input};
+    MapDelta delta = MapDeltaReader{}.readMapDelta(in);
+    ASSERT_EQ(5, delta.edits().size());
+
+    delta.applyTo(roadMap, locations);
+
+    ASSERT_EQ((std::vector<int>{0, 2, 3}), roadMap.vertices());
+    ASSERT_EQ(2, roadMap.edgeCount());
+    ASSERT_DOUBLE_EQ(6.0, roadMap.edgeInfo(0, 2).miles);
+    ASSERT_NE(nullptr, roadMap.edgeInfo(2, 3).speedProfile);
+
+    // The removed location's name now finds the other location with it,
+    // and the new one is found by name and prefix.
+    ASSERT_EQ(3, locations.size());
+    ASSERT_EQ(std::optional<int>{2}, locations.findVertex("Irvine Spectrum"));
+    ASSERT_EQ(std::optional<int>{3}, locations.findVertex("Irvine Center"));
+    ASSERT_EQ("Irvine Center", locations.nameOf(3));
+    ASSERT_THROW(locations.nameOf(1), DigraphException);
+    ASSERT_EQ((std::vector<int>{3, 2}), locations.completions("Irvine", 5));
+
+    // A delta that can't be applied leaves everything as it was.
+    SpeedProfilePool profiles;
+    MapDelta bad{{
+        MapDeltaReader::parseEdit("speed 0 2 15", profiles),
+        MapDeltaReader::parseEdit("remove edge 2 0", profiles)}};
+
+    ASSERT_THROW(bad.applyTo(roadMap, locations), DigraphException);
+    ASSERT_DOUBLE_EQ(60.0, roadMap.edgeInfo(0, 2).milesPerHour);
+
+    ASSERT_THROW(MapDeltaReader::parseEdit("add edge 0 2", profiles), std::invalid_argument);
+    ASSERT_THROW(MapDeltaReader::parseEdit("close 0 2", profiles), std::invalid_argument);
+}
+
+
+TEST(MapDelta_Tests, removedSegmentsTakeTheirTurnRules)
+{
+    RoadMap roadMap;
+
+    for (int i = 0; i < 5; ++i)
+    {
+        roadMap.addVertex(i, "Location");
+    }
+
+    roadMap.addEdge(0, 1, RoadSegment{1.0, 30.0});
+    roadMap.addEdge(1, 2, RoadSegment{1.0, 30.0});
+    roadMap.addEdge(2, 3, RoadSegment{1.0, 30.0});
+    roadMap.addEdge(3, 1, RoadSegment{1.0, 30.0});
+    roadMap.addEdge(2, 4, RoadSegment{1.0, 30.0});
+
+    LocationIndex locations{roadMap};
+    TurnTable turns{{
+        TurnRule{0, 1, 2, std::numeric_limits<float>::infinity()},
+        TurnRule{1, 2, 3, 0.1f},
+        TurnRule{2, 3, 1, 0.1f},
+        TurnRule{3, 1, 2, 0.1f},
+        TurnRule{1, 2, 4, 0.1f}}};
+
+    std::istringstream input{
+        "3\n"
+        "remove edge 0 1\n"
+        "add edge 0 1 1.0 30\n"
+        "remove vertex 3\n"};
+
+    InputReader in{input};
+    MapDeltaReader{}.readMapDelta(in).applyTo(roadMap, locations, turns);
+
+    // The re-added segment is a new road, which the old ban doesn't cover;
+    // only the rule about neither the segment nor the location is left.
+    ASSERT_EQ(1, turns.size());
+    ASSERT_FALSE(turns.isBanned(0, 1, 2));
+    ASSERT_EQ(0.0, turns.penaltyHours(1, 2, 3));
+    ASSERT_DOUBLE_EQ(0.1f, turns.penaltyHours(1, 2, 4));
+
+    // A delta that can't be applied leaves the rules alone.
+    std::istringstream badInput{
+        "2\n"
+        "remove edge 1 2\n"
+        "remove edge 1 2\n"};
+
+    InputReader badIn{badInput};
+    ASSERT_THROW(MapDeltaReader{}.readMapDelta(badIn).applyTo(roadMap, locations, turns), DigraphException);
+    ASSERT_EQ(1, turns.size());
+}
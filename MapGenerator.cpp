@@ -0,0 +1,258 @@
+// MapGenerator.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+#include "MapGenerator.hpp"
+
+
+namespace
+{
+    // The standard library's random distributions may differ between
+    // implementations, so randomness comes from a fixed hash (SplitMix64)
+    // of the seed and whatever is being decided, which also means every
+    // edge's values can be recomputed in any order.
+    std::uint64_t mix(std::uint64_t x)
+    {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+
+    // uniform() returns a number in [low, high) determined by the given
+    // seed and key.
+    double uniform(std::uint64_t seed, std::uint64_t key, double low, double high)
+    {
+        double unit = (mix(seed ^ mix(key)) >> 11) * (1.0 / 9007199254740992.0);
+        return low + (high - low) * unit;
+    }
+
+
+    std::uint64_t edgeKey(int from, int to)
+    {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(from)) << 32)
+            | static_cast<std::uint32_t>(to);
+    }
+
+
+    // Block length (in miles) of the grid shapes, and how many blocks apart
+    // the highways of a HighwayGrid run and have their interchanges.
+    constexpr double blockMiles = 0.125;
+    constexpr int highwaySpacing = 16;
+    constexpr int interchangeSpacing = 4;
+
+    // Target average number of neighbors of a location in RandomGeometric
+    // maps, which are scattered at this many locations per square mile.
+    constexpr double geometricDegree = 6.0;
+    constexpr double geometricDensity = 10.0;
+}
+
+
+MapGenerator::MapGenerator(MapShape shape, int vertexCount, std::uint64_t seed)
+    : shape_{shape}, vertexCount_{vertexCount}, side_{0}, seed_{seed}
+{
+    if (shape_ == MapShape::RandomGeometric)
+    {
+        double sideMiles = std::sqrt(vertexCount_ / geometricDensity);
+
+        positions_.reserve(vertexCount_);
+
+        for (int i = 0; i < vertexCount_; ++i)
+        {
+            positions_.emplace_back(
+                uniform(seed_, 2 * static_cast<std::uint64_t>(i), 0.0, sideMiles),
+                uniform(seed_, 2 * static_cast<std::uint64_t>(i) + 1, 0.0, sideMiles));
+        }
+    }
+    else
+    {
+        side_ = std::max(2, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(vertexCount_)))));
+        vertexCount_ = side_ * side_;
+    }
+}
+
+
+int MapGenerator::vertexCount() const noexcept
+{
+    return vertexCount_;
+}
+
+
+void MapGenerator::writeRoadMap(std::ostream& out) const
+{
+    std::size_t edgeCount = 0;
+    forEachEdge([&](int, int, double, double) { edgeCount++; });
+
+    out << vertexCount_ << '\n';
+
+    for (int i = 0; i < vertexCount_; ++i)
+    {
+        out << "Location " << i << '\n';
+    }
+
+    out << edgeCount << '\n';
+
+    forEachEdge(
+        [&](int from, int to, double miles, double milesPerHour)
+        {
+            out << from << ' ' << to << ' ' << miles << ' ' << milesPerHour << '\n';
+        });
+}
+
+
+RoadMap MapGenerator::buildRoadMap() const
+{
+    RoadMap roadMap;
+
+    for (int i = 0; i < vertexCount_; ++i)
+    {
+        roadMap.addVertex(i, "Location " + std::to_string(i));
+    }
+
+    forEachEdge(
+        [&](int from, int to, double miles, double milesPerHour)
+        {
+            roadMap.addEdge(from, to, RoadSegment{miles, milesPerHour});
+        });
+
+    return roadMap;
+}
+
+
+std::vector<Trip> MapGenerator::randomTrips(int tripCount) const
+{
+    std::vector<Trip> trips;
+
+    for (int i = 0; i < tripCount; ++i)
+    {
+        std::uint64_t key = 0x7472697000000000ULL + 2 * static_cast<std::uint64_t>(i);
+
+        trips.push_back(Trip{
+            static_cast<int>(uniform(seed_, key, 0.0, vertexCount_)),
+            static_cast<int>(uniform(seed_, key + 1, 0.0, vertexCount_)),
+            i % 2 == 0 ? TripMetric::Distance : TripMetric::Time});
+    }
+
+    return trips;
+}
+
+
+MapShape MapGenerator::parseShape(const std::string& name)
+{
+    if (name == "grid")
+    {
+        return MapShape::Grid;
+    }
+    else if (name == "geometric")
+    {
+        return MapShape::RandomGeometric;
+    }
+    else if (name == "highway")
+    {
+        return MapShape::HighwayGrid;
+    }
+
+    throw std::invalid_argument{"Unknown map shape: " + name};
+}
+
+
+template <typename EdgeFunc>
+void MapGenerator::forEachEdge(EdgeFunc edgeFunc) const
+{
+    // Each two-way road is emitted as a pair of segments with the same
+    // length, but with independently chosen speeds.
+    auto road = [&](int a, int b, double miles, double lowSpeed, double highSpeed)
+    {
+        edgeFunc(a, b, miles, std::round(uniform(seed_, edgeKey(a, b), lowSpeed, highSpeed)));
+        edgeFunc(b, a, miles, std::round(uniform(seed_, edgeKey(b, a), lowSpeed, highSpeed)));
+    };
+
+    if (shape_ == MapShape::RandomGeometric)
+    {
+        double sideMiles = std::sqrt(vertexCount_ / geometricDensity);
+        double radius = std::sqrt(geometricDegree / (3.14159265358979 * geometricDensity));
+        int cells = std::max(1, static_cast<int>(sideMiles / radius));
+        double cellMiles = sideMiles / cells;
+
+        // Locations are bucketed into cells at least one radius wide, so
+        // each one's neighbors are all in its own or an adjacent cell.
+        std::vector<std::vector<int>> buckets(static_cast<std::size_t>(cells) * cells);
+
+        auto cellOf = [&](double coordinate)
+        {
+            return std::min(cells - 1, static_cast<int>(coordinate / cellMiles));
+        };
+
+        for (int i = 0; i < vertexCount_; ++i)
+        {
+            buckets[cellOf(positions_[i].second) * cells + cellOf(positions_[i].first)].push_back(i);
+        }
+
+        for (int i = 0; i < vertexCount_; ++i)
+        {
+            int cx = cellOf(positions_[i].first);
+            int cy = cellOf(positions_[i].second);
+
+            for (int y = std::max(0, cy - 1); y <= std::min(cells - 1, cy + 1); ++y)
+            {
+                for (int x = std::max(0, cx - 1); x <= std::min(cells - 1, cx + 1); ++x)
+                {
+                    for (int j : buckets[y * cells + x])
+                    {
+                        double dx = positions_[i].first - positions_[j].first;
+                        double dy = positions_[i].second - positions_[j].second;
+                        double miles = std::sqrt(dx * dx + dy * dy);
+
+                        if (j > i && miles <= radius)
+                        {
+                            // Roads wind a little, so they're somewhat longer
+                            // than the straight line between their ends.
+                            road(i, j, std::max(0.01, miles * 1.2), 25.0, 55.0);
+                        }
+                    }
+                }
+            }
+        }
+
+        return;
+    }
+
+    for (int row = 0; row < side_; ++row)
+    {
+        for (int column = 0; column < side_; ++column)
+        {
+            int v = row * side_ + column;
+
+            if (column + 1 < side_)
+            {
+                road(v, v + 1, blockMiles, 20.0, 40.0);
+            }
+
+            if (row + 1 < side_)
+            {
+                road(v, v + side_, blockMiles, 20.0, 40.0);
+            }
+        }
+    }
+
+    if (shape_ == MapShape::HighwayGrid)
+    {
+        for (int line = 0; line < side_; line += highwaySpacing)
+        {
+            for (int along = 0; along + interchangeSpacing < side_; along += interchangeSpacing)
+            {
+                double miles = blockMiles * interchangeSpacing;
+
+                road(line * side_ + along, line * side_ + along + interchangeSpacing, miles, 55.0, 70.0);
+                road(along * side_ + line, (along + interchangeSpacing) * side_ + line, miles, 55.0, 70.0);
+            }
+        }
+    }
+}
+
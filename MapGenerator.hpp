@@ -0,0 +1,91 @@
+// MapGenerator.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A MapGenerator produces synthetic road maps for benchmarking, either as
+// text in the format read by RoadMapReader or directly as a RoadMap.  The
+// same shape, size, and seed always produce exactly the same map, on any
+// platform, so benchmark results can be compared from run to run.
+//
+// There are three shapes of map:
+//
+// * Grid: a square grid of city blocks with two-way streets.
+// * RandomGeometric: locations scattered at random, with two-way roads
+//   between locations that are close together, like a rural road network.
+// * HighwayGrid: a Grid overlaid with fast two-way highways running along
+//   every few rows and columns, with interchanges only where the highways
+//   meet the streets every few blocks.
+//
+// Text is written as it's generated, without ever building a RoadMap.
+// Grid and HighwayGrid maps need no memory per location, so text for maps
+// of many millions of locations takes only constant memory; RandomGeometric
+// maps have to remember where every location is (and which cell of the
+// map it falls in) to find nearby pairs, which takes a few dozen bytes per
+// location.
+
+#ifndef MAPGENERATOR_HPP
+#define MAPGENERATOR_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "RoadMap.hpp"
+#include "Trip.hpp"
+
+
+
+enum class MapShape
+{
+    Grid,
+    RandomGeometric,
+    HighwayGrid
+};
+
+
+
+class MapGenerator
+{
+public:
+    // Initializes a MapGenerator for a map of the given shape with about
+    // the given number of locations (grids are rounded to a square).
+    MapGenerator(MapShape shape, int vertexCount, std::uint64_t seed);
+
+    int vertexCount() const noexcept;
+
+    // writeRoadMap() writes the map to the given output stream in the
+    // format read by RoadMapReader.
+    void writeRoadMap(std::ostream& out) const;
+
+    // buildRoadMap() builds the map directly as a RoadMap.
+    RoadMap buildRoadMap() const;
+
+    // randomTrips() returns the given number of trips between random
+    // locations of the map, alternating between the two metrics.
+    std::vector<Trip> randomTrips(int tripCount) const;
+
+    // parseShape() converts "grid", "geometric", or "highway" into a
+    // MapShape, throwing a std::invalid_argument for anything else.
+    static MapShape parseShape(const std::string& name);
+
+private:
+    // forEachEdge() calls edgeFunc(from, to, miles, milesPerHour) for each
+    // road segment of the map, always in the same order.
+    template <typename EdgeFunc>
+    void forEachEdge(EdgeFunc edgeFunc) const;
+
+    MapShape shape_;
+    int vertexCount_;
+    int side_;
+    std::uint64_t seed_;
+
+    // For RandomGeometric maps, the position of each location on a square
+    // of side side_ miles.
+    std::vector<std::pair<double, double>> positions_;
+};
+
+
+
+#endif
+
@@ -0,0 +1,127 @@
+// MemoryFootprint.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A MemoryFootprint reports how many bytes a data structure occupies,
+// broken down into named components (the vertex table, the adjacency
+// lists, and so on), so that hosts can be sized for large maps and
+// different layouts can be compared.
+//
+// Node-based containers don't say how much memory they use, so the
+// figures are computed from the layout of the standard library's nodes
+// and of the heap blocks that hold them.  The constants below describe
+// libstdc++ and glibc's malloc on a 64-bit platform; elsewhere they are
+// estimates.  AllocationTracker.hpp measures actual allocations instead,
+// which is how these estimates can be checked.
+
+#ifndef MEMORYFOOTPRINT_HPP
+#define MEMORYFOOTPRINT_HPP
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+
+struct MemoryFootprint
+{
+    // Each component is a name and a number of bytes, in the order they
+    // were added.
+    std::vector<std::pair<std::string, std::size_t>> components;
+
+    void add(const std::string& name, std::size_t bytes);
+
+    // add() with another MemoryFootprint adds each of its components,
+    // with the given prefix on its name.
+    void add(const std::string& prefix, const MemoryFootprint& other);
+
+    std::size_t total() const noexcept;
+};
+
+
+
+// The bytes of overhead in a std::map or std::set node (a color and three
+// pointers) and in a std::list node (two pointers), beyond the element.
+constexpr std::size_t treeNodeOverhead = 4 * sizeof(void*);
+constexpr std::size_t listNodeOverhead = 2 * sizeof(void*);
+
+// The bytes that std::make_shared() allocates alongside the object: the
+// control block's virtual table pointer and its two reference counts.
+constexpr std::size_t sharedControlBlockOverhead = sizeof(void*) + 2 * sizeof(int);
+
+// The largest string that std::string stores without a heap block.
+constexpr std::size_t shortStringCapacity = 15;
+
+
+// heapBlockBytes() returns the bytes that the heap actually sets aside
+// for an allocation of the given size: its size plus a header, rounded
+// up to a 16-byte boundary, and never less than 32 bytes.
+inline std::size_t heapBlockBytes(std::size_t requested) noexcept
+{
+    if (requested == 0)
+    {
+        return 0;
+    }
+
+    std::size_t bytes = (requested + sizeof(std::size_t) + 15) & ~std::size_t{15};
+    return bytes < 32 ? 32 : bytes;
+}
+
+
+// heapBytes() returns the bytes a value owns on the heap, apart from the
+// object itself.  The general version is for values that own nothing;
+// types that do own memory have overloads of their own.
+template <typename T>
+std::size_t heapBytes(const T&) noexcept
+{
+    return 0;
+}
+
+
+inline std::size_t heapBytes(const std::string& s) noexcept
+{
+    return s.capacity() > shortStringCapacity ? heapBlockBytes(s.capacity() + 1) : 0;
+}
+
+
+template <typename T>
+std::size_t heapBytes(const std::vector<T>& v) noexcept
+{
+    return heapBlockBytes(v.capacity() * sizeof(T));
+}
+
+
+
+inline void MemoryFootprint::add(const std::string& name, std::size_t bytes)
+{
+    components.emplace_back(name, bytes);
+}
+
+
+inline void MemoryFootprint::add(const std::string& prefix, const MemoryFootprint& other)
+{
+    for (const auto& component : other.components)
+    {
+        components.emplace_back(prefix + component.first, component.second);
+    }
+}
+
+
+inline std::size_t MemoryFootprint::total() const noexcept
+{
+    std::size_t bytes = 0;
+
+    for (const auto& component : components)
+    {
+        bytes += component.second;
+    }
+
+    return bytes;
+}
+
+
+
+#endif
+
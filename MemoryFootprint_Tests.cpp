@@ -0,0 +1,159 @@
+// MemoryFootprint_Tests.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// Unit tests for MemoryFootprint's estimates and for the AllocationTracker
+// that checks them, building the same kinds of nodes and blocks a RoadMap
+// is made of through a TrackingAllocator and comparing the bytes counted
+// against what the estimates say they take.
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "AllocationTracker.hpp"
+#include "MemoryFootprint.hpp"
+#include "RoadMap.hpp"
+
+
+namespace
+{
+    // trackedBytes() returns how many more bytes the AllocationTracker
+    // counts as allocated after running the given function than before.
+    std::size_t trackedBytes(const std::function<void()>& build)
+    {
+        std::size_t before = AllocationTracker::counts().currentBytes;
+        build();
+        return AllocationTracker::counts().currentBytes - before;
+    }
+
+
+    std::size_t componentOf(const MemoryFootprint& footprint, const std::string& name)
+    {
+        for (const auto& component : footprint.components)
+        {
+            if (component.first == name)
+            {
+                return component.second;
+            }
+        }
+
+        return 0;
+    }
+
+
+    using TrackedEdges = std::list<DigraphEdge<RoadSegment>, TrackingAllocator<DigraphEdge<RoadSegment>>>;
+}
+
+
+TEST(MemoryFootprint_Tests, heapBlocksAreRoundedUpWithHeader)
+{
+    ASSERT_EQ(0, heapBlockBytes(0));
+    ASSERT_EQ(32, heapBlockBytes(1));
+    ASSERT_EQ(32, heapBlockBytes(24));
+    ASSERT_EQ(48, heapBlockBytes(25));
+    ASSERT_EQ(112, heapBlockBytes(100));
+}
+
+
+TEST(MemoryFootprint_Tests, trackerCountsAllocationsAndPeak)
+{
+    AllocationCounts before = AllocationTracker::counts();
+
+    {
+        std::vector<int, TrackingAllocator<int>> numbers;
+        numbers.reserve(100);
+
+        AllocationCounts during = AllocationTracker::counts();
+        ASSERT_EQ(before.currentBytes + heapBlockBytes(100 * sizeof(int)), during.currentBytes);
+        ASSERT_EQ(before.allocations + 1, during.allocations);
+        ASSERT_LE(during.currentBytes, during.peakBytes);
+    }
+
+    AllocationCounts after = AllocationTracker::counts();
+    ASSERT_EQ(before.currentBytes, after.currentBytes);
+    ASSERT_LE(before.currentBytes + heapBlockBytes(100 * sizeof(int)), after.peakBytes);
+
+    AllocationTracker::resetPeak();
+    ASSERT_EQ(after.currentBytes, AllocationTracker::counts().peakBytes);
+}
+
+
+TEST(MemoryFootprint_Tests, nodeEstimatesMatchTrackedAllocations)
+{
+    TrackedEdges edges;
+
+    std::size_t edgeBytes = trackedBytes(
+        [&]() { edges.push_back(DigraphEdge<RoadSegment>{0, 1, RoadSegment{1.0, 30.0}}); });
+
+    ASSERT_EQ(heapBlockBytes(listNodeOverhead + sizeof(DigraphEdge<RoadSegment>)), edgeBytes);
+
+    std::map<int, int, std::less<int>, TrackingAllocator<std::pair<const int, int>>> costs;
+
+    std::size_t mapBytes = trackedBytes(
+        [&]()
+        {
+            for (int i = 0; i < 10; ++i)
+            {
+                costs.emplace(i, i);
+            }
+        });
+
+    ASSERT_EQ(10 * heapBlockBytes(treeNodeOverhead + sizeof(std::pair<const int, int>)), mapBytes);
+
+    std::shared_ptr<SpeedProfile> profile;
+
+    std::size_t profileBytes = trackedBytes(
+        [&]()
+        {
+            profile = std::allocate_shared<SpeedProfile>(
+                TrackingAllocator<SpeedProfile>{},
+                SpeedProfile::Breakpoints{{0.0f, 60.0f}, {8.0f, 20.0f}});
+        });
+
+    ASSERT_EQ(heapBlockBytes(sharedControlBlockOverhead + sizeof(SpeedProfile)), profileBytes);
+}
+
+
+TEST(MemoryFootprint_Tests, roadMapFootprintCountsTrackedNodes)
+{
+    // One adjacency list node, measured on its own, is what every edge
+    // of a RoadMap costs in its adjacency lists.
+    TrackedEdges edges;
+
+    std::size_t nodeBytes = trackedBytes(
+        [&]() { edges.push_back(DigraphEdge<RoadSegment>{0, 1, RoadSegment{1.0, 30.0}}); });
+
+    SpeedProfilePool profiles;
+    std::shared_ptr<const SpeedProfile> profile = profiles.intern({{0.0f, 60.0f}, {8.0f, 20.0f}});
+
+    std::shared_ptr<SpeedProfile> copy;
+
+    std::size_t profileBytes = trackedBytes(
+        [&]()
+        {
+            copy = std::allocate_shared<SpeedProfile>(TrackingAllocator<SpeedProfile>{}, profile->breakpoints());
+        });
+
+    RoadMap roadMap;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        roadMap.addVertex(i, "Location");
+    }
+
+    roadMap.addEdge(0, 1, RoadSegment{1.0, 30.0, profile});
+    roadMap.addEdge(1, 2, RoadSegment{1.0, 30.0, profile});
+    roadMap.addEdge(2, 3, RoadSegment{1.0, 30.0});
+
+    MemoryFootprint footprint = roadMapFootprint(roadMap);
+
+    ASSERT_EQ(3 * nodeBytes, componentOf(footprint, "adjacency lists"));
+
+    // The profile is shared by two segments, but is counted only once.
+    ASSERT_EQ(profileBytes + heapBytes(profile->breakpoints()), componentOf(footprint, "speed profiles"));
+}
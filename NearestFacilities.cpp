@@ -0,0 +1,124 @@
+// NearestFacilities.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <utility>
+#include "NearestFacilities.hpp"
+#include "TripPlanner.hpp"
+
+
+NearestFacilityFinder::NearestFacilityFinder(const RoadMap& roadMap, TripMetric metric)
+    : roadMap_{roadMap}, forward_{roadMap, TripPlanner::edgeWeightFor(metric)}
+{
+    backward_ = forward_.reversed();
+}
+
+
+std::vector<Route> NearestFacilityFinder::findNearest(
+    const std::vector<int>& facilities, int location, int k) const
+{
+    std::vector<int> facilityIndexes = indexesOf(facilities);
+    std::vector<bool> isFacility(backward_.vertexCount(), false);
+
+    for (int index : facilityIndexes)
+    {
+        isFacility[index] = true;
+    }
+
+    std::vector<int> found;
+    std::vector<double> distances;
+    std::vector<int> parents;
+
+    if (k > 0)
+    {
+        backward_.findDistances(
+            std::vector<int>{backward_.indexOf(location)}, distances, parents,
+            [&](int settled)
+            {
+                if (isFacility[settled])
+                {
+                    found.push_back(settled);
+                }
+
+                return static_cast<int>(found.size()) >= k;
+            });
+    }
+
+    // In the backward search, each vertex's parent is the next step on
+    // its way to the location, so following parents from a facility
+    // walks its route forward.
+    std::vector<Route> routes;
+
+    for (int index : found)
+    {
+        std::vector<int> vertices{forward_.vertexAt(index)};
+
+        for (int v = index; parents[v] != v; v = parents[v])
+        {
+            vertices.push_back(forward_.vertexAt(parents[v]));
+        }
+
+        routes.push_back(TripPlanner::routeAlong(roadMap_, std::move(vertices)));
+    }
+
+    return routes;
+}
+
+
+std::map<int, int> NearestFacilityFinder::findCoverage(const std::vector<int>& facilities) const
+{
+    std::vector<double> distances;
+    std::vector<int> parents;
+
+    forward_.findDistances(indexesOf(facilities), distances, parents, [](int) { return false; });
+
+    // Vertices are settled in order of distance, so walking parents up to
+    // a root (a facility, whose parent is itself) finds the facility that
+    // got there first; remembering each answer keeps this linear.
+    std::vector<int> owners(forward_.vertexCount(), -1);
+    std::map<int, int> coverage;
+
+    for (int index = 0; index < forward_.vertexCount(); ++index)
+    {
+        if (parents[index] < 0)
+        {
+            continue;
+        }
+
+        std::vector<int> chain;
+        int v = index;
+
+        while (owners[v] < 0 && parents[v] != v)
+        {
+            chain.push_back(v);
+            v = parents[v];
+        }
+
+        int owner = owners[v] >= 0 ? owners[v] : v;
+        owners[v] = owner;
+
+        for (int w : chain)
+        {
+            owners[w] = owner;
+        }
+
+        coverage.emplace_hint(coverage.end(), forward_.vertexAt(index), forward_.vertexAt(owner));
+    }
+
+    return coverage;
+}
+
+
+std::vector<int> NearestFacilityFinder::indexesOf(const std::vector<int>& vertices) const
+{
+    std::vector<int> indexes;
+
+    for (int vertex : vertices)
+    {
+        indexes.push_back(forward_.indexOf(vertex));
+    }
+
+    return indexes;
+}
+
@@ -0,0 +1,62 @@
+// NearestFacilities.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A NearestFacilityFinder answers questions of the form "which of these
+// facilities (depots, stations, and so on) are closest to a location?",
+// each with a single search rather than one search per facility.
+//
+// * findNearest() searches backward from the location, over the reversed
+//   road map, and stops as soon as k facilities have been reached, so the
+//   k closest facilities come out in order with their routes.
+// * findCoverage() goes the other way, seeding one forward search with
+//   every facility at once, and reports, for every location, which
+//   facility reaches it first.
+//
+// The finder builds compact forward and reversed copies of the RoadMap
+// once, so it should be kept around and reused for many queries.
+
+#ifndef NEARESTFACILITIES_HPP
+#define NEARESTFACILITIES_HPP
+
+#include <map>
+#include <vector>
+#include "CompactDigraph.hpp"
+#include "RoadMap.hpp"
+#include "Route.hpp"
+#include "TripMetric.hpp"
+
+
+
+class NearestFacilityFinder
+{
+public:
+    // Initializes a NearestFacilityFinder for the given RoadMap, which
+    // must outlive it, measuring routes by the given metric.
+    NearestFacilityFinder(const RoadMap& roadMap, TripMetric metric);
+
+    // findNearest() returns routes from up to k of the given facilities
+    // to the given location, nearest first; each route starts at its
+    // facility.  Facilities that can't reach the location are left out.
+    // If the location or any facility does not exist, a DigraphException
+    // is thrown instead.
+    std::vector<Route> findNearest(const std::vector<int>& facilities, int location, int k) const;
+
+    // findCoverage() returns a std::map in which each location reachable
+    // from at least one of the given facilities is mapped to the facility
+    // that reaches it soonest.
+    std::map<int, int> findCoverage(const std::vector<int>& facilities) const;
+
+private:
+    std::vector<int> indexesOf(const std::vector<int>& vertices) const;
+
+    const RoadMap& roadMap_;
+    CompactDigraph forward_;
+    CompactDigraph backward_;
+};
+
+
+
+#endif
+
@@ -0,0 +1,130 @@
+// NumaReplicas.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A NumaReplicas holds one copy of a read-only structure (a RoadMap, a
+// CompactDigraph, and so on) per NUMA node.  Each copy is built by a
+// thread pinned to its node, so its memory is allocated there, and a
+// thread that's itself pinned to a node can then ask for the local copy,
+// never reading memory on another node while it searches.  This trades
+// memory (one copy per node) for latency, and only pays off on machines
+// with more than one node; with one node, there's just the one copy.
+//
+// The copies must not be changed once built; they're only handed out as
+// const references.
+
+#ifndef NUMAREPLICAS_HPP
+#define NUMAREPLICAS_HPP
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "NumaTopology.hpp"
+
+
+
+template <typename T>
+class NumaReplicas
+{
+public:
+    // Initializes a NumaReplicas by calling build once on each node of
+    // the given topology, from a thread pinned to that node.  A copy whose
+    // thread can't be pinned (e.g., because the process isn't allowed to
+    // run on that node's CPUs) is still built, just wherever its thread
+    // happens to run.  If building any copy throws an exception, it is
+    // rethrown here.
+    NumaReplicas(NumaTopology topology, std::function<T()> build);
+
+    NumaReplicas(const NumaReplicas&) = delete;
+    NumaReplicas& operator=(const NumaReplicas&) = delete;
+
+    const NumaTopology& topology() const noexcept;
+
+    // onNode() returns the copy on the given node.
+    const T& onNode(int node) const;
+
+    // local() returns the copy on the node the calling thread is running
+    // on, which stays the same for a thread pinned to a node.
+    const T& local() const;
+
+private:
+    NumaTopology topology_;
+    std::vector<std::unique_ptr<T>> replicas_;
+};
+
+
+
+template <typename T>
+NumaReplicas<T>::NumaReplicas(NumaTopology topology, std::function<T()> build)
+    : topology_{std::move(topology)}, replicas_(topology_.nodeCount())
+{
+    std::vector<std::exception_ptr> errors(replicas_.size());
+    std::vector<std::thread> builders;
+
+    for (int node = 0; node < topology_.nodeCount(); ++node)
+    {
+        builders.emplace_back(
+            [&, node]()
+            {
+                try
+                {
+                    try
+                    {
+                        topology_.pinCurrentThread(node);
+                    }
+                    catch (const std::system_error&)
+                    {
+                    }
+
+                    replicas_[node] = std::make_unique<T>(build());
+                }
+                catch (...)
+                {
+                    errors[node] = std::current_exception();
+                }
+            });
+    }
+
+    for (std::thread& builder : builders)
+    {
+        builder.join();
+    }
+
+    for (const std::exception_ptr& error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+
+template <typename T>
+const NumaTopology& NumaReplicas<T>::topology() const noexcept
+{
+    return topology_;
+}
+
+
+template <typename T>
+const T& NumaReplicas<T>::onNode(int node) const
+{
+    return *replicas_.at(node);
+}
+
+
+template <typename T>
+const T& NumaReplicas<T>::local() const
+{
+    return *replicas_[topology_.currentNode()];
+}
+
+
+
+#endif
+
@@ -0,0 +1,83 @@
+// NumaReplicas_Tests.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// Unit tests for NumaReplicas.  So that they work on any machine, they
+// use a made-up topology of two nodes that share one CPU the process is
+// allowed to run on.
+
+#include <system_error>
+#include <sched.h>
+#include <gtest/gtest.h>
+#include "NumaReplicas.hpp"
+#include "RoadMap.hpp"
+
+
+namespace
+{
+    NumaTopology makeTwoNodes()
+    {
+        int cpu = NumaTopology::detect().cpusOf(0).front();
+        return NumaTopology{{{cpu}, {cpu}}};
+    }
+
+
+    RoadMap makeRoadMap()
+    {
+        RoadMap roadMap;
+        roadMap.addVertex(0, "Location");
+        roadMap.addVertex(1, "Location");
+        roadMap.addVertex(2, "Location");
+        roadMap.addEdge(0, 1, RoadSegment{1.0, 10.0});
+        roadMap.addEdge(1, 2, RoadSegment{1.0, 10.0});
+        roadMap.addEdge(0, 2, RoadSegment{2.5, 60.0});
+
+        return roadMap;
+    }
+}
+
+
+TEST(NumaReplicas_Tests, buildsOneCopyPerNode)
+{
+    int builds = 0;
+    NumaReplicas<int> replicas{makeTwoNodes(), [&]() { return ++builds; }};
+
+    ASSERT_EQ(2, replicas.topology().nodeCount());
+    ASSERT_EQ(2, builds);
+    ASSERT_EQ(3, replicas.onNode(0) + replicas.onNode(1));
+}
+
+
+TEST(NumaReplicas_Tests, detachedCopiesShareNoStorage)
+{
+    RoadMap roadMap = makeRoadMap();
+    NumaReplicas<RoadMap> replicas{makeTwoNodes(), [&]() { return roadMap.detachedCopy(); }};
+
+    ASSERT_NE(replicas.onNode(0).findEdgeInfo(0, 1), replicas.onNode(1).findEdgeInfo(0, 1));
+    ASSERT_NE(roadMap.findEdgeInfo(0, 1), replicas.onNode(0).findEdgeInfo(0, 1));
+    ASSERT_EQ(roadMap.edges(), replicas.onNode(1).edges());
+    ASSERT_EQ(roadMap.edgeCount(), replicas.onNode(1).edgeCount());
+}
+
+
+TEST(NumaReplicas_Tests, buildsUnpinnedWhenNodeCantBePinned)
+{
+    // No process gets to run on a CPU numbered this high on any machine
+    // these tests run on, so pinning to the second node fails.
+    int cpu = NumaTopology::detect().cpusOf(0).front();
+    NumaTopology topology{{{cpu}, {CPU_SETSIZE - 1}}};
+    ASSERT_THROW(topology.pinCurrentThread(1), std::system_error);
+
+    NumaReplicas<int> replicas{topology, []() { return 7; }};
+    ASSERT_EQ(7, replicas.onNode(0));
+    ASSERT_EQ(7, replicas.onNode(1));
+}
+
+
+TEST(NumaReplicas_Tests, rethrowsWhatBuildingThrows)
+{
+    ASSERT_THROW(
+        NumaReplicas<int>(makeTwoNodes(), []() -> int { throw DigraphException("No appropriate vertex found!"); }),
+        DigraphException);
+}
@@ -0,0 +1,229 @@
+// NumaTopology.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <cerrno>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <sched.h>
+#include "NumaTopology.hpp"
+
+
+namespace
+{
+    const char* const nodeDirectory = "/sys/devices/system/node";
+
+
+    // allowedCpus() returns the CPUs this process may run on.
+    std::vector<int> allowedCpus()
+    {
+        std::vector<int> cpus;
+        cpu_set_t set;
+
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            {
+                if (CPU_ISSET(cpu, &set))
+                {
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+
+        if (cpus.empty())
+        {
+            cpus.push_back(0);
+        }
+
+        return cpus;
+    }
+}
+
+
+NumaTopology NumaTopology::detect()
+{
+    // Node directories are named "node0", "node1", and so on, but the
+    // numbers needn't be contiguous, so they're collected and sorted.
+    std::vector<std::pair<int, std::vector<int>>> nodes;
+    std::error_code error;
+
+    for (const auto& entry : std::filesystem::directory_iterator{nodeDirectory, error})
+    {
+        std::string name = entry.path().filename().string();
+
+        if (name.size() <= 4 || name.compare(0, 4, "node") != 0
+            || name.find_first_not_of("0123456789", 4) != std::string::npos)
+        {
+            continue;
+        }
+
+        std::ifstream cpulist{entry.path() / "cpulist"};
+        std::string list;
+
+        if (std::getline(cpulist, list))
+        {
+            std::vector<int> cpus = parseCpuList(list);
+
+            // Memory-only nodes have no CPUs to run queries on.
+            if (!cpus.empty())
+            {
+                nodes.emplace_back(std::stoi(name.substr(4)), std::move(cpus));
+            }
+        }
+    }
+
+    std::sort(nodes.begin(), nodes.end());
+
+    std::vector<std::vector<int>> nodeCpus;
+
+    for (auto& node : nodes)
+    {
+        nodeCpus.push_back(std::move(node.second));
+    }
+
+    if (nodeCpus.empty())
+    {
+        nodeCpus.push_back(allowedCpus());
+    }
+
+    return NumaTopology{std::move(nodeCpus)};
+}
+
+
+NumaTopology::NumaTopology(std::vector<std::vector<int>> nodeCpus)
+    : nodeCpus_{std::move(nodeCpus)}
+{
+    if (nodeCpus_.empty())
+    {
+        throw std::invalid_argument{"A NUMA topology needs at least one node"};
+    }
+
+    for (std::size_t node = 0; node < nodeCpus_.size(); ++node)
+    {
+        if (nodeCpus_[node].empty())
+        {
+            throw std::invalid_argument{"NUMA node " + std::to_string(node) + " has no CPUs"};
+        }
+
+        for (int cpu : nodeCpus_[node])
+        {
+            if (cpu < 0)
+            {
+                throw std::invalid_argument{"Not a CPU number: " + std::to_string(cpu)};
+            }
+
+            if (static_cast<std::size_t>(cpu) >= cpuNodes_.size())
+            {
+                cpuNodes_.resize(cpu + 1, 0);
+            }
+
+            cpuNodes_[cpu] = static_cast<int>(node);
+        }
+    }
+}
+
+
+int NumaTopology::nodeCount() const noexcept
+{
+    return static_cast<int>(nodeCpus_.size());
+}
+
+
+const std::vector<int>& NumaTopology::cpusOf(int node) const
+{
+    return nodeCpus_.at(node);
+}
+
+
+int NumaTopology::nodeOfCpu(int cpu) const noexcept
+{
+    if (cpu < 0 || static_cast<std::size_t>(cpu) >= cpuNodes_.size())
+    {
+        return 0;
+    }
+
+    return cpuNodes_[cpu];
+}
+
+
+int NumaTopology::currentNode() const noexcept
+{
+    return nodeOfCpu(sched_getcpu());
+}
+
+
+void NumaTopology::pinCurrentThread(int node) const
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+
+    for (int cpu : cpusOf(node))
+    {
+        if (cpu < CPU_SETSIZE)
+        {
+            CPU_SET(cpu, &set);
+        }
+    }
+
+    if (sched_setaffinity(0, sizeof(set), &set) != 0)
+    {
+        throw std::system_error{errno, std::system_category(), "sched_setaffinity"};
+    }
+}
+
+
+std::vector<int> NumaTopology::parseCpuList(const std::string& list)
+{
+    std::vector<int> cpus;
+    std::size_t position = 0;
+
+    auto readNumber = [&]()
+    {
+        std::size_t end = list.find_first_not_of("0123456789", position);
+
+        if (end == position)
+        {
+            throw std::invalid_argument{"Not a CPU list: " + list};
+        }
+
+        int number = std::stoi(list.substr(position, end - position));
+        position = end == std::string::npos ? list.size() : end;
+        return number;
+    };
+
+    while (position < list.size() && list[position] != '\n')
+    {
+        int first = readNumber();
+        int last = first;
+
+        if (position < list.size() && list[position] == '-')
+        {
+            position++;
+            last = readNumber();
+        }
+
+        if (last < first)
+        {
+            throw std::invalid_argument{"Not a CPU list: " + list};
+        }
+
+        for (int cpu = first; cpu <= last; ++cpu)
+        {
+            cpus.push_back(cpu);
+        }
+
+        if (position < list.size() && list[position] == ',')
+        {
+            position++;
+        }
+    }
+
+    return cpus;
+}
+
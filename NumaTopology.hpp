@@ -0,0 +1,66 @@
+// NumaTopology.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A NumaTopology describes how a machine's CPUs are grouped into NUMA
+// nodes: sets of cores that share a bank of memory, reaching the other
+// nodes' memory only more slowly.  Nodes are numbered densely from 0, in
+// the order the kernel lists them.  A thread can be pinned to a node, so
+// that it only runs on that node's CPUs, and memory that a pinned thread
+// touches first is, under Linux's default policy, placed on its node.
+//
+// On a machine (or in a container) that doesn't describe its NUMA nodes,
+// detect() reports a single node holding every CPU the process may use.
+
+#ifndef NUMATOPOLOGY_HPP
+#define NUMATOPOLOGY_HPP
+
+#include <string>
+#include <vector>
+
+
+
+class NumaTopology
+{
+public:
+    // detect() reads the topology of this machine from sysfs.
+    static NumaTopology detect();
+
+    // Initializes a NumaTopology with the given CPUs on each node.  A
+    // topology without nodes, or with a node without CPUs, causes a
+    // std::invalid_argument to be thrown instead.
+    explicit NumaTopology(std::vector<std::vector<int>> nodeCpus);
+
+    int nodeCount() const noexcept;
+
+    // cpusOf() returns the CPUs belonging to the given node.
+    const std::vector<int>& cpusOf(int node) const;
+
+    // nodeOfCpu() returns the node that the given CPU belongs to, or 0 if
+    // it's not part of any.
+    int nodeOfCpu(int cpu) const noexcept;
+
+    // currentNode() returns the node of the CPU that the calling thread
+    // is running on right now.
+    int currentNode() const noexcept;
+
+    // pinCurrentThread() restricts the calling thread to the CPUs of the
+    // given node.  If the kernel refuses (e.g., because none of them is
+    // available to this process), a std::system_error is thrown instead.
+    void pinCurrentThread(int node) const;
+
+    // parseCpuList() parses a list of CPUs in the kernel's format, such as
+    // "0-3,8-11".  A malformed list causes a std::invalid_argument to be
+    // thrown instead.
+    static std::vector<int> parseCpuList(const std::string& list);
+
+private:
+    std::vector<std::vector<int>> nodeCpus_;
+    std::vector<int> cpuNodes_;
+};
+
+
+
+#endif
+
@@ -0,0 +1,48 @@
+// NumaTopology_Tests.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// Unit tests for NumaTopology.  They can't assume anything about the
+// machine they run on beyond its having at least one node.
+
+#include <stdexcept>
+#include <vector>
+#include <gtest/gtest.h>
+#include "NumaTopology.hpp"
+
+
+TEST(NumaTopology_Tests, parsesCpuLists)
+{
+    ASSERT_EQ((std::vector<int>{0, 1, 2, 3, 8, 10, 11}), NumaTopology::parseCpuList("0-3,8,10-11\n"));
+    ASSERT_EQ(std::vector<int>{5}, NumaTopology::parseCpuList("5"));
+}
+
+
+TEST(NumaTopology_Tests, rejectsMalformedCpuLists)
+{
+    ASSERT_THROW(NumaTopology::parseCpuList("0-"), std::invalid_argument);
+    ASSERT_THROW(NumaTopology::parseCpuList("a"), std::invalid_argument);
+}
+
+
+TEST(NumaTopology_Tests, needsAtLeastOneNodeWithCpus)
+{
+    ASSERT_THROW(NumaTopology{{}}, std::invalid_argument);
+    ASSERT_THROW((NumaTopology{{{0}, {}}}), std::invalid_argument);
+}
+
+
+TEST(NumaTopology_Tests, detectsEveryNodeWithItsCpus)
+{
+    NumaTopology detected = NumaTopology::detect();
+    ASSERT_LE(1, detected.nodeCount());
+
+    for (int node = 0; node < detected.nodeCount(); ++node)
+    {
+        ASSERT_FALSE(detected.cpusOf(node).empty());
+    }
+
+    int last = detected.nodeCount() - 1;
+    ASSERT_EQ(last, detected.nodeOfCpu(detected.cpusOf(last).front()));
+}
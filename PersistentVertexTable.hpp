@@ -0,0 +1,332 @@
+// PersistentVertexTable.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A PersistentVertexTable is the table of vertices inside a Digraph: a map
+// from vertex numbers to vertices, kept in order of vertex number.  It is
+// persistent in the sense that copying one takes constant time, and the
+// copy and the original then share everything they have in common.
+//
+// The table is a trie with 16 children per node, 8 levels deep, with each
+// level picking its child using 4 bits of the vertex number, most
+// significant first; the vertices themselves hang off the bottom level.
+// Nodes and vertices are reference-counted, and anything referred to by
+// more than one table is never changed in place: a change first copies
+// the path of (at most 8) nodes leading to the vertex being changed, and
+// the vertex itself, leaving the other tables' views alone.  Anything a
+// table refers to alone is simply changed in place, so building a table
+// up one vertex at a time copies nothing.
+//
+// Different tables may be used by different threads at the same time,
+// even if they share nodes, as long as each individual table is only
+// changed while no other thread is using it.
+
+#ifndef PERSISTENTVERTEXTABLE_HPP
+#define PERSISTENTVERTEXTABLE_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include "MemoryFootprint.hpp"
+
+
+
+template <typename Vertex>
+class PersistentVertexTable
+{
+public:
+    // Initializes an empty PersistentVertexTable.
+    PersistentVertexTable() noexcept;
+
+    // size() returns the number of vertices in the table.
+    std::size_t size() const noexcept;
+
+    // find() returns the vertex with the given number, or nullptr if there
+    // is none.  The pointer is good until the table is next changed.
+    const Vertex* find(int vertexNumber) const noexcept;
+
+    // findForUpdate() is like find(), except that the vertex it returns
+    // may be changed; if it's shared with another table, it's copied
+    // first, so the change only affects this one.
+    Vertex* findForUpdate(int vertexNumber);
+
+    // insert() adds the given vertex with the given number, returning
+    // false (and changing nothing) if there's already one with that number.
+    bool insert(int vertexNumber, Vertex vertex);
+
+    // erase() removes the vertex with the given number, returning false
+    // (and changing nothing) if there's no such vertex.
+    bool erase(int vertexNumber);
+
+    // forEach() calls the given function with each vertex number and the
+    // corresponding vertex, in ascending order of vertex number.
+    template <typename VertexFunc>
+    void forEach(VertexFunc vertexFunc) const;
+
+    // heapBytes() returns the bytes this table's nodes and vertices occupy
+    // on the heap (not counting what the vertices themselves own).  Nodes
+    // and vertices shared with other tables are counted in full.
+    std::size_t heapBytes() const noexcept;
+
+private:
+    static constexpr unsigned int bitsPerLevel = 4;
+    static constexpr unsigned int fanout = 1u << bitsPerLevel;
+    static constexpr unsigned int levels = 32 / bitsPerLevel;
+
+    // A Node's children are Nodes, except on the bottom level, where
+    // they're Vertex objects.
+    struct Node
+    {
+        std::array<std::shared_ptr<void>, fanout> children;
+    };
+
+    // keyOf() turns a vertex number into the unsigned key the trie is
+    // indexed by, flipping the sign bit so that keys sort in the same
+    // order as vertex numbers.
+    static std::uint32_t keyOf(int vertexNumber) noexcept;
+    static unsigned int childIndex(std::uint32_t key, unsigned int level) noexcept;
+
+    // own() returns the object in the given slot, first replacing it with
+    // a copy of its own if it's shared with another table.
+    template <typename T>
+    static T* own(std::shared_ptr<void>& slot);
+
+    // eraseBelow() removes the given key from below the given slot (which
+    // is on the given level and already owned by this table), freeing any
+    // nodes that are left empty.
+    static void eraseBelow(std::shared_ptr<void>& slot, unsigned int level, std::uint32_t key);
+
+    template <typename VertexFunc>
+    static void forEachBelow(const std::shared_ptr<void>& slot, unsigned int level, std::uint32_t prefix, VertexFunc& vertexFunc);
+
+    static std::size_t bytesBelow(const std::shared_ptr<void>& slot, unsigned int level) noexcept;
+
+    std::shared_ptr<void> root_;
+    std::size_t size_;
+};
+
+
+
+template <typename Vertex>
+PersistentVertexTable<Vertex>::PersistentVertexTable() noexcept
+    : size_{0}
+{
+}
+
+
+template <typename Vertex>
+std::size_t PersistentVertexTable<Vertex>::size() const noexcept
+{
+    return size_;
+}
+
+
+template <typename Vertex>
+const Vertex* PersistentVertexTable<Vertex>::find(int vertexNumber) const noexcept
+{
+    std::uint32_t key = keyOf(vertexNumber);
+    const void* current = root_.get();
+
+    for (unsigned int level = 0; level < levels && current != nullptr; ++level)
+    {
+        current = static_cast<const Node*>(current)->children[childIndex(key, level)].get();
+    }
+
+    return static_cast<const Vertex*>(current);
+}
+
+
+template <typename Vertex>
+Vertex* PersistentVertexTable<Vertex>::findForUpdate(int vertexNumber)
+{
+    // Nothing is copied on the way down unless the vertex is really there.
+    if (find(vertexNumber) == nullptr)
+    {
+        return nullptr;
+    }
+
+    std::uint32_t key = keyOf(vertexNumber);
+    std::shared_ptr<void>* slot = &root_;
+
+    for (unsigned int level = 0; level < levels; ++level)
+    {
+        slot = &own<Node>(*slot)->children[childIndex(key, level)];
+    }
+
+    return own<Vertex>(*slot);
+}
+
+
+template <typename Vertex>
+bool PersistentVertexTable<Vertex>::insert(int vertexNumber, Vertex vertex)
+{
+    if (find(vertexNumber) != nullptr)
+    {
+        return false;
+    }
+
+    std::uint32_t key = keyOf(vertexNumber);
+    std::shared_ptr<void>* slot = &root_;
+
+    for (unsigned int level = 0; level < levels; ++level)
+    {
+        if (*slot == nullptr)
+        {
+            *slot = std::make_shared<Node>();
+        }
+
+        slot = &own<Node>(*slot)->children[childIndex(key, level)];
+    }
+
+    *slot = std::make_shared<Vertex>(std::move(vertex));
+    size_++;
+
+    return true;
+}
+
+
+template <typename Vertex>
+bool PersistentVertexTable<Vertex>::erase(int vertexNumber)
+{
+    if (find(vertexNumber) == nullptr)
+    {
+        return false;
+    }
+
+    eraseBelow(root_, 0, keyOf(vertexNumber));
+    size_--;
+
+    return true;
+}
+
+
+template <typename Vertex>
+template <typename VertexFunc>
+void PersistentVertexTable<Vertex>::forEach(VertexFunc vertexFunc) const
+{
+    forEachBelow(root_, 0, 0, vertexFunc);
+}
+
+
+template <typename Vertex>
+std::size_t PersistentVertexTable<Vertex>::heapBytes() const noexcept
+{
+    return bytesBelow(root_, 0);
+}
+
+
+template <typename Vertex>
+std::uint32_t PersistentVertexTable<Vertex>::keyOf(int vertexNumber) noexcept
+{
+    return static_cast<std::uint32_t>(vertexNumber) ^ 0x80000000u;
+}
+
+
+template <typename Vertex>
+unsigned int PersistentVertexTable<Vertex>::childIndex(std::uint32_t key, unsigned int level) noexcept
+{
+    return (key >> (bitsPerLevel * (levels - 1 - level))) & (fanout - 1);
+}
+
+
+template <typename Vertex>
+template <typename T>
+T* PersistentVertexTable<Vertex>::own(std::shared_ptr<void>& slot)
+{
+    if (slot.use_count() > 1)
+    {
+        slot = std::make_shared<T>(*static_cast<const T*>(slot.get()));
+    }
+    else
+    {
+        // Seeing a count of one means every other table has let go, but
+        // their reads of the object must be finished before it changes.
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+
+    return static_cast<T*>(slot.get());
+}
+
+
+template <typename Vertex>
+void PersistentVertexTable<Vertex>::eraseBelow(std::shared_ptr<void>& slot, unsigned int level, std::uint32_t key)
+{
+    std::shared_ptr<void>& child = own<Node>(slot)->children[childIndex(key, level)];
+
+    if (level + 1 == levels)
+    {
+        child.reset();
+    }
+    else
+    {
+        eraseBelow(child, level + 1, key);
+    }
+
+    for (const std::shared_ptr<void>& remaining : static_cast<const Node*>(slot.get())->children)
+    {
+        if (remaining != nullptr)
+        {
+            return;
+        }
+    }
+
+    slot.reset();
+}
+
+
+template <typename Vertex>
+template <typename VertexFunc>
+void PersistentVertexTable<Vertex>::forEachBelow(
+    const std::shared_ptr<void>& slot, unsigned int level, std::uint32_t prefix, VertexFunc& vertexFunc)
+{
+    if (slot == nullptr)
+    {
+        return;
+    }
+
+    if (level == levels)
+    {
+        vertexFunc(static_cast<int>(prefix ^ 0x80000000u), *static_cast<const Vertex*>(slot.get()));
+        return;
+    }
+
+    const Node* node = static_cast<const Node*>(slot.get());
+
+    for (unsigned int i = 0; i < fanout; ++i)
+    {
+        forEachBelow(node->children[i], level + 1, (prefix << bitsPerLevel) | i, vertexFunc);
+    }
+}
+
+
+template <typename Vertex>
+std::size_t PersistentVertexTable<Vertex>::bytesBelow(const std::shared_ptr<void>& slot, unsigned int level) noexcept
+{
+    if (slot == nullptr)
+    {
+        return 0;
+    }
+
+    if (level == levels)
+    {
+        return heapBlockBytes(sharedControlBlockOverhead + sizeof(Vertex));
+    }
+
+    std::size_t bytes = heapBlockBytes(sharedControlBlockOverhead + sizeof(Node));
+
+    for (const std::shared_ptr<void>& child : static_cast<const Node*>(slot.get())->children)
+    {
+        bytes += bytesBelow(child, level + 1);
+    }
+
+    return bytes;
+}
+
+
+
+#endif
+
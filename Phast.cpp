@@ -0,0 +1,151 @@
+// Phast.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif
+#include "Phast.hpp"
+
+
+namespace
+{
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+
+
+    // relaxLanes() lowers each of the lanes distances in best to the
+    // matching distance in source plus weight, when that's smaller.
+    // Compilers don't reliably vectorize this once the loop is unrolled,
+    // so it's spelled out for AVX-512 and AVX when they're enabled.
+    inline void relaxLanes(double* best, const double* source, double weight)
+    {
+#if defined(__AVX512F__)
+        static_assert(Phast::lanes == 8, "relaxLanes() assumes 8 lanes");
+        __m512d candidate = _mm512_add_pd(_mm512_loadu_pd(source), _mm512_set1_pd(weight));
+        _mm512_storeu_pd(best, _mm512_min_pd(candidate, _mm512_loadu_pd(best)));
+#elif defined(__AVX__)
+        static_assert(Phast::lanes == 8, "relaxLanes() assumes 8 lanes");
+        __m256d w = _mm256_set1_pd(weight);
+        __m256d low = _mm256_add_pd(_mm256_loadu_pd(source), w);
+        __m256d high = _mm256_add_pd(_mm256_loadu_pd(source + 4), w);
+        _mm256_storeu_pd(best, _mm256_min_pd(low, _mm256_loadu_pd(best)));
+        _mm256_storeu_pd(best + 4, _mm256_min_pd(high, _mm256_loadu_pd(best + 4)));
+#else
+        for (int lane = 0; lane < Phast::lanes; ++lane)
+        {
+            double candidate = source[lane] + weight;
+            best[lane] = candidate < best[lane] ? candidate : best[lane];
+        }
+#endif
+    }
+}
+
+
+Phast::Phast(const ContractionHierarchy& hierarchy)
+    : hierarchy_{hierarchy}
+{
+}
+
+
+std::vector<double> Phast::distancesFrom(int startIndex) const
+{
+    return distancesFrom(std::vector<int>{startIndex}).front();
+}
+
+
+std::vector<std::vector<double>> Phast::distancesFrom(const std::vector<int>& startIndexes) const
+{
+    const int n = hierarchy_.vertexCount();
+
+    std::vector<std::vector<double>> result(startIndexes.size(), std::vector<double>(n));
+    std::vector<double> distances;
+
+    for (std::size_t first = 0; first < startIndexes.size(); first += lanes)
+    {
+        int count = static_cast<int>(std::min<std::size_t>(lanes, startIndexes.size() - first));
+        sweep(startIndexes.data() + first, count, distances);
+
+        for (int lane = 0; lane < count; ++lane)
+        {
+            for (int index = 0; index < n; ++index)
+            {
+                result[first + lane][index] = distances[hierarchy_.positionOf(index) * lanes + lane];
+            }
+        }
+    }
+
+    return result;
+}
+
+
+void Phast::sweep(const int* startIndexes, int count, std::vector<double>& distances) const
+{
+    const int n = hierarchy_.vertexCount();
+
+    distances.assign(static_cast<std::size_t>(n) * lanes, infinity);
+
+    // The upward searches are ordinary Dijkstra searches, one per lane,
+    // but they only ever climb the hierarchy, so they stay small.
+    using Entry = std::pair<double, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> pq;
+
+    for (int lane = 0; lane < count; ++lane)
+    {
+        int start = hierarchy_.positionOf(startIndexes[lane]);
+        distances[start * lanes + lane] = 0.0;
+        pq.push({0.0, start});
+
+        while (!pq.empty())
+        {
+            Entry top = pq.top();
+            pq.pop();
+
+            if (top.first > distances[top.second * lanes + lane])
+            {
+                continue;
+            }
+
+            for (std::size_t e = hierarchy_.firstUpEdge(top.second); e < hierarchy_.firstUpEdge(top.second + 1); ++e)
+            {
+                int to = hierarchy_.upEdgeTarget(e);
+                double candidate = top.first + hierarchy_.upEdgeWeight(e);
+
+                if (candidate < distances[to * lanes + lane])
+                {
+                    distances[to * lanes + lane] = candidate;
+                    pq.push({candidate, to});
+                }
+            }
+        }
+    }
+
+    // The downward sweep visits positions in increasing order, which is
+    // decreasing rank, so every downward edge's source is already final
+    // by the time its target is reached.
+    double* d = distances.data();
+
+    for (int position = 0; position < n; ++position)
+    {
+        // Working on a local copy of the target's lanes means they stay in
+        // cache (or registers) while its incoming edges are scanned.
+        double* target = d + static_cast<std::size_t>(position) * lanes;
+        double best[lanes];
+
+        std::copy(target, target + lanes, best);
+
+        for (std::size_t e = hierarchy_.firstDownEdge(position); e < hierarchy_.firstDownEdge(position + 1); ++e)
+        {
+            const double* source = d + static_cast<std::size_t>(hierarchy_.downEdgeSource(e)) * lanes;
+            relaxLanes(best, source, hierarchy_.downEdgeWeight(e));
+        }
+
+        std::copy(best, best + lanes, target);
+    }
+}
+
@@ -0,0 +1,63 @@
+// Phast.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// Phast answers one-to-all distance queries over a ContractionHierarchy
+// using the PHAST technique.  A query first runs a small Dijkstra search
+// from the source using only upward edges, then makes one linear sweep
+// over every vertex in decreasing rank order, where each vertex takes the
+// best of its own distance and the distances offered by its incoming
+// downward edges.  The sweep touches memory strictly in order and never
+// uses a priority queue.
+//
+// distancesFrom() with several sources runs them together in groups of
+// Phast::lanes, keeping that many distances per vertex side by side, so
+// that the inner loop of the sweep is a fixed-width element-wise minimum
+// the compiler turns into SIMD instructions.  One pass over the hierarchy
+// then serves a whole group of sources.
+//
+// Phast only computes distances.  Shortest paths in the hierarchy run
+// through shortcuts, so predecessors would have to be unpacked; callers
+// needing paths should use Digraph::findShortestPaths() or DeltaStepping.
+
+#ifndef PHAST_HPP
+#define PHAST_HPP
+
+#include <vector>
+#include "ContractionHierarchy.hpp"
+
+
+
+class Phast
+{
+public:
+    // The number of sources processed together by each sweep.
+    static constexpr int lanes = 8;
+
+    // Initializes a Phast engine over the given hierarchy, which must
+    // outlive it.
+    explicit Phast(const ContractionHierarchy& hierarchy);
+
+    // distancesFrom() returns the distance from the given dense index of
+    // the original CompactDigraph to every dense index, with unreachable
+    // ones at infinity.
+    std::vector<double> distancesFrom(int startIndex) const;
+
+    // This overload of distancesFrom() answers many sources at once,
+    // returning one vector of distances (indexed like the one above) per
+    // source, in the same order as the sources.
+    std::vector<std::vector<double>> distancesFrom(const std::vector<int>& startIndexes) const;
+
+private:
+    // sweep() fills in distances, laid out as lanes values per sweep
+    // position, for up to lanes sources at once.
+    void sweep(const int* startIndexes, int count, std::vector<double>& distances) const;
+
+    const ContractionHierarchy& hierarchy_;
+};
+
+
+
+#endif
+
@@ -0,0 +1,72 @@
+// RoadMap.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include "RoadMap.hpp"
+
+
+RoadMap RoadMap::detachedCopy() const
+{
+    RoadMap copy;
+    std::vector<int> locations = vertices();
+
+    for (int vertex : locations)
+    {
+        copy.addVertex(vertex, vertexInfo(vertex));
+    }
+
+    for (int vertex : locations)
+    {
+        forEachEdge(
+            vertex,
+            [&](const DigraphEdge<RoadSegment>& edge)
+            {
+                copy.addEdge(edge.fromVertex, edge.toVertex, edge.einfo);
+            });
+    }
+
+    return copy;
+}
+
+
+void RoadMap::addVertex(int vertex, std::string_view name)
+{
+    // A vertex that's already there is turned away before its name takes
+    // up room in the pool.
+    if (findVertexInfo(vertex) != nullptr)
+    {
+        throw DigraphException("This vertex is already in the graph!");
+    }
+
+    if (names_ == nullptr)
+    {
+        names_ = std::make_shared<LocationNamePool>();
+    }
+
+    Digraph::addVertex(vertex, names_->add(name));
+}
+
+
+std::shared_ptr<const LocationNamePool> RoadMap::namePool() const noexcept
+{
+    return names_;
+}
+
+
+MemoryFootprint RoadMap::memoryFootprint() const
+{
+    MemoryFootprint footprint = Digraph::memoryFootprint();
+
+    if (names_ != nullptr)
+    {
+        // std::make_shared puts the pool in the same block as the
+        // shared_ptr's control block.
+        footprint.add(
+            "location names",
+            heapBlockBytes(sharedControlBlockOverhead + sizeof(LocationNamePool)) + names_->heapBytes());
+    }
+
+    return footprint;
+}
+
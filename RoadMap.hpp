@@ -3,20 +3,88 @@
 // ICS 46 Winter 2022
 // Project #5: Rock and Roll Stops the Traffic
 //
-// This header defines a type RoadMap, which is simply a shorthand name for a
-// particular instantiation of the Digraph template, where each vertex has a
-// string for its information and each edge has a RoadSegment for its information.
+// This header defines a class RoadMap, which is the instantiation of the
+// Digraph template used for maps, where each edge has a RoadSegment for its
+// information and each vertex has the name of a location.
+//
+// The names aren't kept in the vertices themselves.  They're copied into
+// a LocationNamePool, which a RoadMap shares with its copies, and each
+// vertex holds only a std::string_view of its name in the pool, so that
+// vertexInfo() and findVertexInfo() hand back views that remain valid for
+// as long as any copy of the RoadMap does.  A removed location's name
+// stays in the pool, unused, until the pool goes away.
 
 #ifndef ROADMAP_HPP
 #define ROADMAP_HPP
 
-#include <string>
+#include <memory>
+#include <set>
+#include <string_view>
 #include "Digraph.hpp"
+#include "LocationNamePool.hpp"
+#include "MemoryFootprint.hpp"
 #include "RoadSegment.hpp"
 
 
 
-using RoadMap = Digraph<std::string, RoadSegment>;
+class RoadMap : public Digraph<std::string_view, RoadSegment>
+{
+public:
+    // detachedCopy() returns a copy of this RoadMap that shares none of
+    // its storage, not even its names (see Digraph::detachedCopy()).
+    RoadMap detachedCopy() const;
+
+    // addVertex() adds a location with the given vertex number and name,
+    // which is copied into the RoadMap's pool of names.  If there is
+    // already a vertex with the given vertex number, a DigraphException
+    // is thrown instead.
+    void addVertex(int vertex, std::string_view name);
+
+    // namePool() returns the pool holding the names of the locations in
+    // this RoadMap, or nullptr if no location has been added to it yet.
+    // Holding onto it keeps the views of those names valid.
+    std::shared_ptr<const LocationNamePool> namePool() const noexcept;
+
+    // memoryFootprint() returns Digraph::memoryFootprint(), plus the pool
+    // of names.
+    MemoryFootprint memoryFootprint() const;
+
+private:
+    std::shared_ptr<LocationNamePool> names_;
+};
+
+
+
+// roadMapFootprint() returns RoadMap::memoryFootprint(), plus the speed
+// profiles its road segments refer to.  Those are shared between segments,
+// so each one is counted only once, however many segments use it.
+inline MemoryFootprint roadMapFootprint(const RoadMap& roadMap)
+{
+    MemoryFootprint footprint = roadMap.memoryFootprint();
+    std::set<const SpeedProfile*> profiles;
+    std::size_t profileBytes = 0;
+
+    for (int vertex : roadMap.vertices())
+    {
+        roadMap.forEachEdge(
+            vertex,
+            [&](const DigraphEdge<RoadSegment>& edge)
+            {
+                const SpeedProfile* profile = edge.einfo.speedProfile.get();
+
+                if (profile != nullptr && profiles.insert(profile).second)
+                {
+                    // std::make_shared puts the SpeedProfile in the same
+                    // block as the shared_ptr's control block.
+                    profileBytes += heapBlockBytes(sharedControlBlockOverhead + sizeof(SpeedProfile))
+                        + heapBytes(profile->breakpoints());
+                }
+            });
+    }
+
+    footprint.add("speed profiles", profileBytes);
+    return footprint;
+}
 
 
 
@@ -0,0 +1,360 @@
+// RoadMapPartition.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <queue>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include "RoadMapPartition.hpp"
+#include "RoadMapReader.hpp"
+#include "RoadMapWriter.hpp"
+
+
+namespace
+{
+    // hopsFrom() returns the number of road segments (in either direction)
+    // between each vertex and the nearest of the given sources, or -1 for
+    // vertices that can't be reached.
+    std::vector<int> hopsFrom(const std::vector<std::vector<int>>& neighbors, const std::vector<int>& sources)
+    {
+        std::vector<int> hops(neighbors.size(), -1);
+        std::queue<int> queue;
+
+        for (int source : sources)
+        {
+            hops[source] = 0;
+            queue.push(source);
+        }
+
+        while (!queue.empty())
+        {
+            int u = queue.front();
+            queue.pop();
+
+            for (int v : neighbors[u])
+            {
+                if (hops[v] < 0)
+                {
+                    hops[v] = hops[u] + 1;
+                    queue.push(v);
+                }
+            }
+        }
+
+        return hops;
+    }
+}
+
+
+RoadMapPartition::RoadMapPartition(const RoadMap& roadMap, int shardCount)
+{
+    std::vector<int> vertices = roadMap.vertices();
+    std::sort(vertices.begin(), vertices.end());
+
+    if (shardCount < 1 || static_cast<std::size_t>(shardCount) > vertices.size())
+    {
+        throw DigraphException("The number of shards must be between 1 and the number of vertices");
+    }
+
+    // The partitioning is done on dense indexes into the sorted vertices,
+    // ignoring the direction of the road segments.
+    auto indexOf = [&](int vertex)
+    {
+        return static_cast<int>(std::lower_bound(vertices.begin(), vertices.end(), vertex) - vertices.begin());
+    };
+
+    std::vector<std::vector<int>> neighbors(vertices.size());
+
+    for (const std::pair<int, int>& edge : roadMap.edges())
+    {
+        int from = indexOf(edge.first);
+        int to = indexOf(edge.second);
+
+        neighbors[from].push_back(to);
+        neighbors[to].push_back(from);
+    }
+
+    // Seeds are chosen farthest-first: each one is the vertex the most
+    // road segments away from all of the seeds chosen before it.  Parts
+    // of the map that can't be reached from any seed are only seeded once
+    // everything reachable is, since they're usually small islands that
+    // are better off joining whichever shard is smallest.
+    std::vector<int> seeds{0};
+
+    while (seeds.size() < static_cast<std::size_t>(shardCount))
+    {
+        std::vector<int> hops = hopsFrom(neighbors, seeds);
+        int farthest = -1;
+        int unreachable = -1;
+
+        for (std::size_t v = 0; v < hops.size(); ++v)
+        {
+            if (hops[v] < 0)
+            {
+                unreachable = unreachable < 0 ? static_cast<int>(v) : unreachable;
+            }
+            else if (hops[v] > 0 && (farthest < 0 || hops[v] > hops[farthest]))
+            {
+                farthest = static_cast<int>(v);
+            }
+        }
+
+        seeds.push_back(farthest >= 0 ? farthest : unreachable);
+    }
+
+    std::vector<int> shardOfIndex(vertices.size(), -1);
+    std::vector<std::queue<int>> frontiers(shardCount);
+    shardSizes_.assign(shardCount, 0);
+
+    for (int shard = 0; shard < shardCount; ++shard)
+    {
+        shardOfIndex[seeds[shard]] = shard;
+        shardSizes_[shard] = 1;
+        frontiers[shard].push(seeds[shard]);
+    }
+
+    std::size_t assigned = seeds.size();
+    std::size_t nextUnassigned = 0;
+
+    while (assigned < vertices.size())
+    {
+        // The smallest shard that can still grow grows by one vertex's
+        // neighbors.
+        int smallest = -1;
+
+        for (int shard = 0; shard < shardCount; ++shard)
+        {
+            if (!frontiers[shard].empty() && (smallest < 0 || shardSizes_[shard] < shardSizes_[smallest]))
+            {
+                smallest = shard;
+            }
+        }
+
+        // If no shard can grow, what's left is disconnected from all of
+        // them, so the smallest shard takes a foothold there.
+        if (smallest < 0)
+        {
+            smallest = static_cast<int>(std::min_element(shardSizes_.begin(), shardSizes_.end()) - shardSizes_.begin());
+
+            while (shardOfIndex[nextUnassigned] >= 0)
+            {
+                nextUnassigned++;
+            }
+
+            shardOfIndex[nextUnassigned] = smallest;
+            shardSizes_[smallest]++;
+            frontiers[smallest].push(static_cast<int>(nextUnassigned));
+            assigned++;
+            continue;
+        }
+
+        int u = frontiers[smallest].front();
+        frontiers[smallest].pop();
+
+        for (int v : neighbors[u])
+        {
+            if (shardOfIndex[v] < 0)
+            {
+                shardOfIndex[v] = smallest;
+                shardSizes_[smallest]++;
+                frontiers[smallest].push(v);
+                assigned++;
+            }
+        }
+    }
+
+    for (std::size_t i = 0; i < vertices.size(); ++i)
+    {
+        shards_.emplace_hint(shards_.end(), vertices[i], shardOfIndex[i]);
+    }
+
+    for (int vertex : vertices)
+    {
+        roadMap.forEachEdge(
+            vertex,
+            [&](const DigraphEdge<RoadSegment>& edge)
+            {
+                if (shards_.at(edge.fromVertex) != shards_.at(edge.toVertex))
+                {
+                    cutEdges_.emplace(std::make_pair(edge.fromVertex, edge.toVertex), edge.einfo);
+                }
+            });
+    }
+
+    findBoundaryVertices();
+}
+
+
+int RoadMapPartition::shardCount() const noexcept
+{
+    return static_cast<int>(shardSizes_.size());
+}
+
+
+int RoadMapPartition::shardOf(int vertex) const
+{
+    auto found = shards_.find(vertex);
+
+    if (found == shards_.end())
+    {
+        throw DigraphException("No such vertex: " + std::to_string(vertex));
+    }
+
+    return found->second;
+}
+
+
+int RoadMapPartition::shardSize(int shard) const
+{
+    return shardSizes_.at(shard);
+}
+
+
+const std::vector<int>& RoadMapPartition::boundaryVertices(int shard) const
+{
+    return boundaryVertices_.at(shard);
+}
+
+
+const std::map<std::pair<int, int>, RoadSegment>& RoadMapPartition::cutEdges() const noexcept
+{
+    return cutEdges_;
+}
+
+
+RoadMap RoadMapPartition::shardRoadMap(const RoadMap& roadMap, int shard) const
+{
+    RoadMap result;
+
+    for (const auto& entry : shards_)
+    {
+        if (entry.second == shard)
+        {
+            result.addVertex(entry.first, *roadMap.findVertexInfo(entry.first));
+        }
+    }
+
+    for (const auto& entry : shards_)
+    {
+        if (entry.second != shard)
+        {
+            continue;
+        }
+
+        roadMap.forEachEdge(
+            entry.first,
+            [&](const DigraphEdge<RoadSegment>& edge)
+            {
+                if (shards_.at(edge.toVertex) == shard)
+                {
+                    result.addEdge(edge.fromVertex, edge.toVertex, edge.einfo);
+                }
+            });
+    }
+
+    return result;
+}
+
+
+
+void RoadMapPartition::write(std::ostream& out) const
+{
+    out << shardCount() << '\n' << shards_.size() << '\n';
+
+    for (const auto& entry : shards_)
+    {
+        out << entry.first << ' ' << entry.second << '\n';
+    }
+
+    out << cutEdges_.size() << '\n';
+
+    for (const auto& cut : cutEdges_)
+    {
+        out << cut.first.first << ' ' << cut.first.second << ' ';
+        RoadMapWriter::writeRoadSegment(out, cut.second);
+        out << '\n';
+    }
+}
+
+
+RoadMapPartition RoadMapPartition::read(InputReader& in)
+{
+    RoadMapPartition partition;
+
+    int shardCount = in.readIntLine();
+
+    if (shardCount < 1)
+    {
+        throw std::invalid_argument{"A partition needs at least one shard"};
+    }
+
+    partition.shardSizes_.assign(shardCount, 0);
+
+    int vertexCount = in.readIntLine();
+
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        std::string line = in.readLine();
+        std::istringstream vertexLine{line};
+
+        int vertex;
+        int shard;
+
+        if (!(vertexLine >> vertex >> shard) || shard < 0 || shard >= shardCount)
+        {
+            throw std::invalid_argument{"Not a vertex and its shard: " + line};
+        }
+
+        partition.shards_[vertex] = shard;
+        partition.shardSizes_[shard]++;
+    }
+
+    SpeedProfilePool profiles;
+    int cutEdgeCount = in.readIntLine();
+
+    for (int i = 0; i < cutEdgeCount; ++i)
+    {
+        std::string line = in.readLine();
+        std::istringstream cutLine{line};
+
+        int from;
+        int to;
+
+        if (!(cutLine >> from >> to))
+        {
+            throw std::invalid_argument{"Not a cut edge: " + line};
+        }
+
+        if (partition.shardOf(from) == partition.shardOf(to))
+        {
+            throw std::invalid_argument{"Not a cut edge, since both ends are in one shard: " + line};
+        }
+
+        partition.cutEdges_.emplace(std::make_pair(from, to), RoadMapReader::readRoadSegment(cutLine, profiles));
+    }
+
+    partition.findBoundaryVertices();
+    return partition;
+}
+
+
+void RoadMapPartition::findBoundaryVertices()
+{
+    std::vector<std::set<int>> boundary(shardCount());
+
+    for (const auto& cut : cutEdges_)
+    {
+        boundary[shards_.at(cut.first.first)].insert(cut.first.first);
+        boundary[shards_.at(cut.first.second)].insert(cut.first.second);
+    }
+
+    boundaryVertices_.clear();
+
+    for (const std::set<int>& vertices : boundary)
+    {
+        boundaryVertices_.emplace_back(vertices.begin(), vertices.end());
+    }
+}
@@ -0,0 +1,95 @@
+// RoadMapPartition.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A RoadMapPartition splits the locations of a RoadMap into a number of
+// regional shards of roughly equal size, each of which can be searched
+// on its own (e.g., by a separate process; see ShardedRouter.hpp).
+//
+// Shards are grown outward from seed locations spread across the map,
+// one road at a time, always growing the smallest shard next, so they
+// come out compact and balanced without needing coordinates.  A road
+// segment whose ends are in different shards is a cut edge, and the
+// locations at the ends of cut edges are the boundary vertices: every
+// route that leaves a shard does so through one of them.
+//
+// The partition only records which shard each vertex is in, its boundary
+// vertices, and its cut edges; it doesn't keep a reference to the RoadMap.
+// It can be written out and read back without the RoadMap, so that a
+// coordinator can route across shards without ever loading the whole map
+// (see shardmain.cpp).
+
+#ifndef ROADMAPPARTITION_HPP
+#define ROADMAPPARTITION_HPP
+
+#include <map>
+#include <ostream>
+#include <utility>
+#include <vector>
+#include "InputReader.hpp"
+#include "RoadMap.hpp"
+
+
+
+class RoadMapPartition
+{
+public:
+    // Initializes a RoadMapPartition of the given RoadMap into the given
+    // number of shards (at least one, and no more than there are
+    // locations).
+    RoadMapPartition(const RoadMap& roadMap, int shardCount);
+
+    int shardCount() const noexcept;
+
+    // shardOf() returns the shard that the given vertex is in.  If there
+    // is no such vertex, a DigraphException is thrown instead.
+    int shardOf(int vertex) const;
+
+    // shardSize() returns the number of vertices in the given shard.
+    int shardSize(int shard) const;
+
+    // boundaryVertices() returns, in ascending order, the vertices of the
+    // given shard that are at one end of a cut edge.
+    const std::vector<int>& boundaryVertices(int shard) const;
+
+    // cutEdges() returns every road segment whose ends are in different
+    // shards, keyed by its (from, to) vertices.
+    const std::map<std::pair<int, int>, RoadSegment>& cutEdges() const noexcept;
+
+    // shardRoadMap() returns the part of the given RoadMap (which must be
+    // the one this partition was made from) that's in the given shard:
+    // its vertices, with their original vertex numbers, and the road
+    // segments between them.
+    RoadMap shardRoadMap(const RoadMap& roadMap, int shard) const;
+
+    // write() writes the partition to the given output stream: the number
+    // of shards, the number of vertices followed by a line giving each
+    // vertex and its shard, and the number of cut edges followed by a
+    // line giving each one's vertices and road segment.  The boundary
+    // vertices follow from the cut edges, so they aren't written.
+    void write(std::ostream& out) const;
+
+    // read() reads a partition written by write().  A shard number out of
+    // range, or a cut edge within one shard, causes a std::invalid_argument
+    // to be thrown, and a cut edge whose ends aren't in the partition
+    // causes a DigraphException to be thrown.
+    static RoadMapPartition read(InputReader& in);
+
+private:
+    RoadMapPartition() = default;
+
+    // findBoundaryVertices() fills in the boundary vertices of each shard
+    // from the cut edges.
+    void findBoundaryVertices();
+
+    std::map<int, int> shards_;
+    std::vector<int> shardSizes_;
+    std::vector<std::vector<int>> boundaryVertices_;
+    std::map<std::pair<int, int>, RoadSegment> cutEdges_;
+};
+
+
+
+#endif
+
@@ -0,0 +1,130 @@
+// RoadMapPartition_Tests.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// Unit tests for RoadMapPartition, checking that a partition and its
+// shards' RoadMaps are read back from files exactly as they were written.
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "RoadMapPartition.hpp"
+#include "RoadMapReader.hpp"
+#include "RoadMapWriter.hpp"
+
+
+namespace
+{
+    // A line of six locations, each road twice as long as the one before
+    // and with a speed profile on every other one.
+    RoadMap makeLine(SpeedProfilePool& profiles)
+    {
+        RoadMap roadMap;
+
+        for (int i = 0; i < 6; ++i)
+        {
+            roadMap.addVertex(i * 10, "Location " + std::to_string(i));
+        }
+
+        for (int i = 0; i + 1 < 6; ++i)
+        {
+            RoadSegment segment{0.1 * (1 << i), 30.0 + i / 3.0};
+
+            if (i % 2 == 0)
+            {
+                segment.speedProfile = profiles.intern({{0.0f, 60.0f}, {7.5f, 17.3f}});
+            }
+
+            roadMap.addEdge(i * 10, (i + 1) * 10, segment);
+            roadMap.addEdge((i + 1) * 10, i * 10, segment);
+        }
+
+        return roadMap;
+    }
+}
+
+
+TEST(RoadMapPartition_Tests, partitionReadsBackAsWritten)
+{
+    SpeedProfilePool profiles;
+    RoadMap roadMap = makeLine(profiles);
+    RoadMapPartition partition{roadMap, 2};
+
+    std::stringstream text;
+    partition.write(text);
+
+    InputReader in{text};
+    RoadMapPartition read = RoadMapPartition::read(in);
+
+    ASSERT_EQ(partition.shardCount(), read.shardCount());
+
+    for (int vertex : roadMap.vertices())
+    {
+        ASSERT_EQ(partition.shardOf(vertex), read.shardOf(vertex));
+    }
+
+    for (int shard = 0; shard < partition.shardCount(); ++shard)
+    {
+        ASSERT_EQ(partition.shardSize(shard), read.shardSize(shard));
+        ASSERT_EQ(partition.boundaryVertices(shard), read.boundaryVertices(shard));
+    }
+
+    ASSERT_EQ(partition.cutEdges().size(), read.cutEdges().size());
+
+    for (const auto& cut : partition.cutEdges())
+    {
+        const RoadSegment& segment = read.cutEdges().at(cut.first);
+        ASSERT_EQ(cut.second.miles, segment.miles);
+        ASSERT_EQ(cut.second.milesPerHour, segment.milesPerHour);
+    }
+
+    std::istringstream badText{"2\n1\n0 2\n0\n"};
+    InputReader badIn{badText};
+    ASSERT_THROW(RoadMapPartition::read(badIn), std::invalid_argument);
+}
+
+
+TEST(RoadMapPartition_Tests, shardRoadMapsReadBackAsWritten)
+{
+    SpeedProfilePool profiles;
+    RoadMap roadMap = makeLine(profiles);
+    RoadMapPartition partition{roadMap, 2};
+
+    for (int shard = 0; shard < partition.shardCount(); ++shard)
+    {
+        RoadMap written = partition.shardRoadMap(roadMap, shard);
+
+        std::stringstream text;
+        RoadMapWriter{}.writeNumberedRoadMap(text, written);
+
+        InputReader in{text};
+        RoadMap read = RoadMapReader{}.readNumberedRoadMap(in);
+
+        ASSERT_EQ(written.vertices(), read.vertices());
+        ASSERT_EQ(written.edges(), read.edges());
+
+        for (int vertex : written.vertices())
+        {
+            ASSERT_EQ(written.vertexInfo(vertex), read.vertexInfo(vertex));
+        }
+
+        // Numbers come back exactly, not just to a few decimal places.
+        for (const std::pair<int, int>& edge : written.edges())
+        {
+            RoadSegment before = written.edgeInfo(edge.first, edge.second);
+            RoadSegment after = read.edgeInfo(edge.first, edge.second);
+
+            ASSERT_EQ(before.miles, after.miles);
+            ASSERT_EQ(before.milesPerHour, after.milesPerHour);
+            ASSERT_EQ(before.speedProfile == nullptr, after.speedProfile == nullptr);
+
+            if (before.speedProfile != nullptr)
+            {
+                ASSERT_EQ(before.speedProfile->breakpoints(), after.speedProfile->breakpoints());
+            }
+        }
+    }
+}
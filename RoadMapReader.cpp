@@ -4,13 +4,117 @@
 // Project #5: Rock and Roll Stops the Traffic
 
 #include <algorithm>
+#include <limits>
 #include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 #include "RoadMapReader.hpp"
 
 
+namespace
+{
+    // readTurnRule() parses one line of the turn restriction section,
+    // checking that both of the turn's road segments exist.
+    TurnRule readTurnRule(const RoadMap& roadMap, const std::string& line)
+    {
+        std::istringstream turnLine{line};
+
+        TurnRule rule;
+        std::string penalty;
+
+        if (!(turnLine >> rule.fromVertex >> rule.viaVertex >> rule.toVertex >> penalty))
+        {
+            throw std::invalid_argument{"A turn needs three vertices and a penalty: " + line};
+        }
+
+        if (penalty == "no")
+        {
+            rule.penaltyHours = std::numeric_limits<float>::infinity();
+        }
+        else
+        {
+            std::size_t parsed = 0;
+            double seconds = std::stod(penalty, &parsed);
+
+            if (parsed != penalty.size() || !(seconds >= 0.0))
+            {
+                throw std::invalid_argument{"Not a turn penalty: " + penalty};
+            }
+
+            rule.penaltyHours = static_cast<float>(seconds / 3600.0);
+        }
+
+        if (roadMap.findEdgeInfo(rule.fromVertex, rule.viaVertex) == nullptr
+            || roadMap.findEdgeInfo(rule.viaVertex, rule.toVertex) == nullptr)
+        {
+            throw DigraphException("No such turn: " + line);
+        }
+
+        return rule;
+    }
+}
+
+
+RoadSegment RoadMapReader::readRoadSegment(std::istream& in, SpeedProfilePool& profiles)
+{
+    double miles = 0.0;
+    double milesPerHour = 0.0;
+
+    in >> miles >> milesPerHour;
+
+    RoadSegment segment{miles, milesPerHour};
+
+    // In the extended format, the snapshot speed can be followed by
+    // an '@' and a speed profile, written as pairs of a time of day
+    // and a speed (e.g., "@ 0:00 65 7:30 25 9:00 55").
+    std::string marker;
+
+    if (!(in >> marker))
+    {
+        return segment;
+    }
+
+    if (marker != "@")
+    {
+        throw std::invalid_argument{"Expected '@' and a speed profile: " + marker};
+    }
+
+    SpeedProfile::Breakpoints breakpoints;
+    std::string hour;
+
+    // Every time of day has to be followed by a speed; anything that
+    // doesn't read as one (including a time left without a speed at the
+    // end of the line) makes the whole segment invalid.
+    while (in >> hour)
+    {
+        double speed;
+
+        if (!(in >> speed))
+        {
+            throw std::invalid_argument{"A speed profile time needs a speed: " + hour};
+        }
+
+        breakpoints.emplace_back(SpeedProfile::parseHour(hour), speed);
+    }
+
+    segment.speedProfile = profiles.intern(std::move(breakpoints));
+    return segment;
+}
+
+
 RoadMap RoadMapReader::readRoadMap(InputReader& in)
+{
+    TurnTable turns;
+    return readRoadMap(in, turns);
+}
+
+
+RoadMap RoadMapReader::readRoadMap(InputReader& in, TurnTable& turns)
 {
     RoadMap roadMap;
+    SpeedProfilePool profiles;
 
     int numberOfLocations = in.readIntLine();
 
@@ -27,14 +131,70 @@ RoadMap RoadMapReader::readRoadMap(InputReader& in)
 
         int fromLocation;
         int toLocation;
-        double miles;
-        double milesPerHour;
 
-        roadSegmentLine >> fromLocation >> toLocation >> miles >> milesPerHour;
+        roadSegmentLine >> fromLocation >> toLocation;
 
-        roadMap.addEdge(fromLocation, toLocation, RoadSegment{miles, milesPerHour});
+        roadMap.addEdge(fromLocation, toLocation, readRoadSegment(roadSegmentLine, profiles));
+    }
+
+    if (in.peekLine() == "TURNS")
+    {
+        in.readLine();
+
+        int numberOfTurns = in.readIntLine();
+        std::vector<TurnRule> rules;
+        rules.reserve(numberOfTurns);
+
+        for (int i = 0; i < numberOfTurns; ++i)
+        {
+            rules.push_back(readTurnRule(roadMap, in.readLine()));
+        }
+
+        turns = TurnTable{std::move(rules)};
     }
 
     return roadMap;
 }
 
+
+
+RoadMap RoadMapReader::readNumberedRoadMap(InputReader& in)
+{
+    RoadMap roadMap;
+    SpeedProfilePool profiles;
+
+    int numberOfLocations = in.readIntLine();
+
+    for (int i = 0; i < numberOfLocations; ++i)
+    {
+        std::string line = in.readLine();
+        std::istringstream locationLine{line};
+
+        int vertex;
+        std::string name;
+
+        if (!(locationLine >> vertex))
+        {
+            throw std::invalid_argument{"A location needs a vertex number: " + line};
+        }
+
+        locationLine >> std::ws;
+        std::getline(locationLine, name);
+        roadMap.addVertex(vertex, name);
+    }
+
+    int numberOfRoadSegments = in.readIntLine();
+
+    for (int i = 0; i < numberOfRoadSegments; ++i)
+    {
+        std::istringstream roadSegmentLine{in.readLine()};
+
+        int fromLocation;
+        int toLocation;
+
+        roadSegmentLine >> fromLocation >> toLocation;
+        roadMap.addEdge(fromLocation, toLocation, readRoadSegment(roadSegmentLine, profiles));
+    }
+
+    return roadMap;
+}
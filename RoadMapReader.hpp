@@ -6,12 +6,26 @@
 // The RoadMapReader class provides an object that knows how to read a
 // RoadMap from the standard input, using the format given in the
 // project write-up.
+//
+// That format is extended so that each road segment line may end with an
+// '@' followed by a speed profile for the segment, written as pairs of a
+// time of day and a speed in miles per hour.  Segments with identical
+// profiles share a single SpeedProfile object.
+//
+// The road segments may also be followed by an optional turn restriction
+// section: a line containing "TURNS", then the number of rules, then one
+// line per rule giving the vertex a turn comes from, the vertex it's made
+// at, and the vertex it goes to, followed by either "no" (the turn is
+// banned) or the extra time the turn takes, in seconds.  For example,
+// "3 4 5 no" bans the turn from 3 through 4 to 5.
 
 #ifndef ROADMAPREADER_HPP
 #define ROADMAPREADER_HPP
 
+#include <istream>
 #include "RoadMap.hpp"
 #include "InputReader.hpp"
+#include "TurnTable.hpp"
 
 
 
@@ -20,8 +34,29 @@ class RoadMapReader
 public:
     // readRoadMap() reads a RoadMap from the given InputReader.  The
     // RoadMap is expected to be described in the format given in the
-    // project write-up.
+    // project write-up.  A turn restriction section, if present, is
+    // read and ignored.
     RoadMap readRoadMap(InputReader& in);
+
+    // This overload of readRoadMap() also stores the rules of the turn
+    // restriction section, if there is one, into the given TurnTable.
+    // A rule describing a turn that the road segments don't allow causes
+    // a DigraphException to be thrown, and a rule that can't be parsed
+    // causes a std::invalid_argument to be thrown.
+    RoadMap readRoadMap(InputReader& in, TurnTable& turns);
+
+    // readNumberedRoadMap() reads a RoadMap written by
+    // RoadMapWriter::writeNumberedRoadMap(), whose location lines each
+    // begin with the location's vertex number.  A line that doesn't
+    // causes a std::invalid_argument to be thrown.
+    RoadMap readNumberedRoadMap(InputReader& in);
+
+    // readRoadSegment() reads the part of a road segment line that follows
+    // its two vertex numbers: its miles, its speed, and optionally its
+    // speed profile, which is interned in the given SpeedProfilePool.
+    // A profile that isn't made up of complete pairs of a valid time of
+    // day and a speed causes a std::invalid_argument to be thrown.
+    static RoadSegment readRoadSegment(std::istream& in, SpeedProfilePool& profiles);
 };
 
 
@@ -3,9 +3,25 @@
 // ICS 46 Winter 2022
 // Project #5: Rock and Roll Stops the Traffic
 
+#include <algorithm>
+#include <charconv>
+#include <vector>
 #include "RoadMapWriter.hpp"
 
 
+namespace
+{
+    template <typename Number>
+    void writeNumber(std::ostream& out, Number value)
+    {
+        char digits[32];
+        std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+
+        out.write(digits, result.ptr - digits);
+    }
+}
+
+
 void RoadMapWriter::writeRoadMap(std::ostream& out, const RoadMap& roadMap)
 {
     out << "LOCATIONS" << std::endl;
@@ -31,3 +47,54 @@ void RoadMapWriter::writeRoadMap(std::ostream& out, const RoadMap& roadMap)
     out << std::endl;
 }
 
+
+
+void RoadMapWriter::writeNumberedRoadMap(std::ostream& out, const RoadMap& roadMap)
+{
+    std::vector<int> vertices = roadMap.vertices();
+    std::sort(vertices.begin(), vertices.end());
+
+    out << vertices.size() << '\n';
+
+    for (int vertex : vertices)
+    {
+        out << vertex << ' ' << roadMap.vertexInfo(vertex) << '\n';
+    }
+
+    out << roadMap.edgeCount() << '\n';
+
+    for (int vertex : vertices)
+    {
+        roadMap.forEachEdge(
+            vertex,
+            [&](const DigraphEdge<RoadSegment>& edge)
+            {
+                out << edge.fromVertex << ' ' << edge.toVertex << ' ';
+                writeRoadSegment(out, edge.einfo);
+                out << '\n';
+            });
+    }
+}
+
+
+void RoadMapWriter::writeRoadSegment(std::ostream& out, const RoadSegment& segment)
+{
+    writeNumber(out, segment.miles);
+    out << ' ';
+    writeNumber(out, segment.milesPerHour);
+
+    if (segment.speedProfile != nullptr)
+    {
+        // Times of day are written as decimal hours, which parseHour()
+        // reads as exactly as it reads "H:MM".
+        out << " @";
+
+        for (const auto& breakpoint : segment.speedProfile->breakpoints())
+        {
+            out << ' ';
+            writeNumber(out, breakpoint.first);
+            out << ' ';
+            writeNumber(out, breakpoint.second);
+        }
+    }
+}
@@ -7,6 +7,10 @@
 // stream in a format that allows you to see information about it.  This
 // is provided purely as a debugging aid; you don't actually need it to
 // solve the problem at hand.
+//
+// It can also write a RoadMap in a form that RoadMapReader reads back,
+// which is how shardmain saves each shard of a partitioned map to a file
+// of its own.
 
 #ifndef ROADMAPWRITER_HPP
 #define ROADMAPWRITER_HPP
@@ -23,6 +27,20 @@ public:
     // you could pass std::cout to write it to the console) in a format
     // that's designed to assist in debugging.
     void writeRoadMap(std::ostream& out, const RoadMap& roadMap);
+
+    // writeNumberedRoadMap() writes a RoadMap in the format read by
+    // RoadMapReader::readNumberedRoadMap(): the input format, except that
+    // each location's line begins with its vertex number, so that a map
+    // whose vertices aren't numbered 0 through N - 1 (such as one shard
+    // of a larger map) is read back with the same numbers.  Turn rules
+    // aren't part of a RoadMap, so none are written.
+    void writeNumberedRoadMap(std::ostream& out, const RoadMap& roadMap);
+
+    // writeRoadSegment() writes the part of a road segment line that
+    // RoadMapReader::readRoadSegment() reads: its miles, its speed, and
+    // its speed profile, if it has one.  Numbers are written with just
+    // enough digits to be read back exactly.
+    static void writeRoadSegment(std::ostream& out, const RoadSegment& segment);
 };
 
 
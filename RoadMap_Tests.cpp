@@ -0,0 +1,61 @@
+// RoadMap_Tests.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// Unit tests for RoadMap's pool of location names, which is shared by the
+// copies of a RoadMap and never moves a name once it's there.
+
+#include <string>
+#include <string_view>
+#include <gtest/gtest.h>
+#include "RoadMap.hpp"
+
+
+TEST(RoadMap_Tests, namesStayPutAsLocationsAreAdded)
+{
+    RoadMap roadMap;
+    roadMap.addVertex(0, "Anteater Stadium");
+    std::string_view name = roadMap.vertexInfo(0);
+
+    // Enough names to fill several of the pool's blocks, and one that is
+    // longer than a block on its own.
+    for (int i = 1; i < 1000; ++i)
+    {
+        roadMap.addVertex(i, "Location " + std::to_string(i));
+    }
+
+    std::string longName(10000, 'x');
+    roadMap.addVertex(1000, longName);
+
+    ASSERT_EQ(roadMap.vertexInfo(0).data(), name.data());
+    ASSERT_EQ("Anteater Stadium", name);
+    ASSERT_EQ("Location 999", roadMap.vertexInfo(999));
+    ASSERT_EQ(longName, roadMap.vertexInfo(1000));
+    ASSERT_EQ(nullptr, roadMap.findVertexInfo(1001));
+    ASSERT_THROW(roadMap.addVertex(0, "Again"), DigraphException);
+}
+
+
+TEST(RoadMap_Tests, copiesShareNamesUntilDetached)
+{
+    RoadMap roadMap;
+    roadMap.addVertex(0, "UCI Campus");
+    roadMap.addVertex(1, "Newport Beach");
+    roadMap.addEdge(0, 1, RoadSegment{6.5, 40.0});
+
+    RoadMap copy = roadMap;
+    copy.addVertex(2, "Irvine Spectrum");
+
+    ASSERT_EQ(roadMap.namePool(), copy.namePool());
+    ASSERT_EQ(roadMap.vertexInfo(1).data(), copy.vertexInfo(1).data());
+    ASSERT_EQ(nullptr, roadMap.findVertexInfo(2));
+
+    RoadMap detached = copy.detachedCopy();
+
+    ASSERT_NE(copy.namePool(), detached.namePool());
+    ASSERT_NE(copy.vertexInfo(2).data(), detached.vertexInfo(2).data());
+    ASSERT_EQ("Irvine Spectrum", detached.vertexInfo(2));
+    ASSERT_EQ(copy.edges(), detached.edges());
+    ASSERT_EQ(6.5, detached.edgeInfo(0, 1).miles);
+}
@@ -7,19 +7,48 @@
 // about a segment of road, namely the distance (in miles) that the
 // segment spans and the speed (in miles per hour) that traffic is
 // currently travelling on that road.
+//
+// A segment can optionally carry a SpeedProfile describing how its speed
+// varies through the day.  milesPerHour is still the current snapshot
+// speed; the profile is only consulted by time-dependent queries, which
+// ask travelHours() how long the segment takes when entered at a given
+// hour.
 
 #ifndef ROADSEGMENT_HPP
 #define ROADSEGMENT_HPP
 
+#include <memory>
+#include "SpeedProfile.hpp"
+
 
 
 struct RoadSegment
 {
     double miles;
     double milesPerHour;
+
+    // Shared with every other segment that has the same profile; null
+    // when the segment has no profile.
+    std::shared_ptr<const SpeedProfile> speedProfile = nullptr;
 };
 
 
 
+// travelHours() returns the hours needed to drive the given segment when
+// entering it at the given hour, using its speed profile when it has one
+// and its snapshot speed otherwise.
+
+inline double travelHours(const RoadSegment& segment, double enteringHour)
+{
+    if (segment.speedProfile)
+    {
+        return segment.speedProfile->travelHours(segment.miles, enteringHour);
+    }
+
+    return segment.miles / segment.milesPerHour;
+}
+
+
+
 #endif
 
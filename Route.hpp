@@ -0,0 +1,38 @@
+// Route.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A Route describes the answer to one trip: the sequence of vertex numbers
+// visited on the way from the trip's start vertex to its end vertex, along
+// with the total distance (in miles) and driving time (in hours) of that
+// sequence of road segments.  For a trip with intermediate stops, the
+// Route also lists the legs between consecutive stops, each of which is
+// a Route of its own.
+
+#ifndef ROUTE_HPP
+#define ROUTE_HPP
+
+#include <vector>
+
+
+
+struct Route
+{
+    // The vertices visited, in order, starting with the trip's start
+    // vertex and ending with its end vertex.  If the end vertex could
+    // not be reached, this is empty.
+    std::vector<int> vertices;
+
+    double miles;
+    double hours;
+
+    // The legs between consecutive stops of a multi-stop trip, in the
+    // order they're driven; empty for a trip without intermediate stops.
+    std::vector<Route> legs = {};
+};
+
+
+
+#endif
+
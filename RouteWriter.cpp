@@ -0,0 +1,500 @@
+// RouteWriter.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include "RouteWriter.hpp"
+
+
+RouteWriter::RouteWriter(std::ostream& out, RouteFormat format, std::size_t flushThreshold)
+    : out_{out}, format_{format}, flushThreshold_{flushThreshold}, tripIndex_{0}, turns_{nullptr}
+{
+    buffer_.reserve(flushThreshold_ + 1024);
+
+    if (format_ == RouteFormat::Binary)
+    {
+        buffer_ += "RTE1";
+    }
+}
+
+
+RouteWriter::RouteWriter(
+    std::ostream& out, const TurnTable& turns, RouteFormat format, std::size_t flushThreshold)
+    : RouteWriter{out, format, flushThreshold}
+{
+    turns_ = &turns;
+}
+
+
+RouteWriter::~RouteWriter() noexcept
+{
+    try
+    {
+        flush();
+    }
+    catch (...)
+    {
+    }
+}
+
+
+void RouteWriter::writeRoute(
+    const RoadMap& roadMap, std::uint32_t tripIndex, const Trip& trip, const Route& route)
+{
+    tripIndex_ = tripIndex;
+    writeRoute(roadMap, trip, route);
+}
+
+
+void RouteWriter::writeRoute(const RoadMap& roadMap, const Trip& trip, const Route& route)
+{
+    switch (format_)
+    {
+    case RouteFormat::Text:
+        appendText(roadMap, trip, route);
+        break;
+
+    case RouteFormat::JsonLines:
+        appendJson(roadMap, trip, route);
+        break;
+
+    case RouteFormat::Binary:
+        appendBinary(roadMap, trip, route);
+        break;
+    }
+
+    tripIndex_++;
+
+    if (buffer_.size() >= flushThreshold_)
+    {
+        flush();
+    }
+}
+
+
+void RouteWriter::writeError(std::uint32_t tripIndex, TripMetric metric, const std::string& message)
+{
+    tripIndex_ = tripIndex;
+
+    switch (format_)
+    {
+    case RouteFormat::Text:
+        buffer_ += "Trip ";
+        appendInteger(tripIndex_);
+        buffer_ += ": ";
+        buffer_ += message;
+        buffer_ += "\n\n";
+        break;
+
+    case RouteFormat::JsonLines:
+        buffer_ += "{\"trip\":";
+        appendInteger(tripIndex_);
+        buffer_ += ",\"error\":\"";
+
+        for (char c : message)
+        {
+            if (c == '"' || c == '\\')
+            {
+                buffer_ += '\\';
+                buffer_ += c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                buffer_ += ' ';
+            }
+            else
+            {
+                buffer_ += c;
+            }
+        }
+
+        buffer_ += "\"}\n";
+        break;
+
+    case RouteFormat::Binary:
+        appendBytes(tripIndex_, 4);
+        appendBytes(metric == TripMetric::Time ? 1 : 0, 1);
+        appendBytes(0, 7);
+        appendBytes(0.0);
+        appendBytes(0.0);
+        appendBytes(0, 4);
+        break;
+    }
+
+    tripIndex_++;
+}
+
+
+void RouteWriter::flush()
+{
+    out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    out_.flush();
+    buffer_.clear();
+}
+
+
+RouteFormat RouteWriter::parseFormat(const std::string& name)
+{
+    if (name == "text")
+    {
+        return RouteFormat::Text;
+    }
+    else if (name == "json")
+    {
+        return RouteFormat::JsonLines;
+    }
+    else if (name == "binary")
+    {
+        return RouteFormat::Binary;
+    }
+
+    throw std::invalid_argument{"Unknown output format: " + name};
+}
+
+
+void RouteWriter::appendText(const RoadMap& roadMap, const Trip& trip, const Route& route)
+{
+    bool byTime = trip.metric == TripMetric::Time;
+
+    buffer_ += byTime ? "Shortest driving time from " : "Shortest distance from ";
+    appendName(roadMap, trip.startVertex);
+    buffer_ += " to ";
+    appendName(roadMap, trip.endVertex);
+    buffer_ += '\n';
+
+    if (route.vertices.empty())
+    {
+        buffer_ += "  No route\n";
+    }
+    else
+    {
+        findSegmentHours(roadMap, trip, route);
+
+        buffer_ += "  Begin at ";
+        appendName(roadMap, route.vertices.front());
+        buffer_ += '\n';
+
+        for (std::size_t i = 1; i < route.vertices.size(); ++i)
+        {
+            const RoadSegment& segment = *roadMap.findEdgeInfo(route.vertices[i - 1], route.vertices[i]);
+
+            if (byTime && turnHours_[i - 1] > 0.0)
+            {
+                buffer_ += "  Turn at ";
+                appendName(roadMap, route.vertices[i - 1]);
+                buffer_ += " (";
+                appendDuration(turnHours_[i - 1]);
+                buffer_ += ")\n";
+            }
+
+            buffer_ += "  Continue to ";
+            appendName(roadMap, route.vertices[i]);
+            buffer_ += " (";
+            appendDecimal(segment.miles);
+            buffer_ += " miles";
+
+            if (byTime)
+            {
+                double hours = segmentHours_[i - 1];
+
+                buffer_ += " @ ";
+                appendDecimal(hours > 0.0 ? segment.miles / hours : segment.milesPerHour);
+                buffer_ += "mph = ";
+                appendDuration(hours);
+            }
+
+            buffer_ += ")\n";
+        }
+
+        if (!route.legs.empty())
+        {
+            buffer_ += "  Legs:\n";
+
+            for (std::size_t i = 0; i < route.legs.size(); ++i)
+            {
+                const Route& leg = route.legs[i];
+
+                buffer_ += "    ";
+                appendInteger(i + 1);
+                buffer_ += ". ";
+                appendName(roadMap, leg.vertices.front());
+                buffer_ += " to ";
+                appendName(roadMap, leg.vertices.back());
+                buffer_ += " (";
+                appendDecimal(leg.miles);
+                buffer_ += " miles";
+
+                if (byTime)
+                {
+                    buffer_ += ", ";
+                    appendDuration(leg.hours);
+                }
+
+                buffer_ += ")\n";
+            }
+        }
+    }
+
+    if (byTime)
+    {
+        buffer_ += "Total time: ";
+        appendDuration(route.hours);
+    }
+    else
+    {
+        buffer_ += "Total distance: ";
+        appendDecimal(route.miles);
+        buffer_ += " miles";
+    }
+
+    buffer_ += "\n\n";
+}
+
+
+void RouteWriter::appendJson(const RoadMap& roadMap, const Trip& trip, const Route& route)
+{
+    findSegmentHours(roadMap, trip, route);
+
+    buffer_ += "{\"trip\":";
+    appendInteger(tripIndex_);
+    buffer_ += trip.metric == TripMetric::Time ? ",\"metric\":\"time\"" : ",\"metric\":\"distance\"";
+    buffer_ += route.vertices.empty() ? ",\"found\":false" : ",\"found\":true";
+
+    buffer_ += ",\"vertices\":[";
+
+    for (std::size_t i = 0; i < route.vertices.size(); ++i)
+    {
+        if (i > 0)
+        {
+            buffer_ += ',';
+        }
+
+        appendInteger(route.vertices[i]);
+    }
+
+    buffer_ += "],\"miles\":[";
+
+    for (std::size_t i = 1; i < route.vertices.size(); ++i)
+    {
+        if (i > 1)
+        {
+            buffer_ += ',';
+        }
+
+        appendExact(roadMap.findEdgeInfo(route.vertices[i - 1], route.vertices[i])->miles);
+    }
+
+    buffer_ += "],\"hours\":[";
+
+    for (std::size_t i = 0; i < segmentHours_.size(); ++i)
+    {
+        if (i > 0)
+        {
+            buffer_ += ',';
+        }
+
+        appendExact(segmentHours_[i] + turnHours_[i]);
+    }
+
+    buffer_ += "],\"totalMiles\":";
+    appendExact(route.miles);
+    buffer_ += ",\"totalHours\":";
+    appendExact(route.hours);
+    buffer_ += ",\"legs\":[";
+
+    for (std::size_t i = 0; i < route.legs.size(); ++i)
+    {
+        const Route& leg = route.legs[i];
+
+        buffer_ += i > 0 ? ",{\"from\":" : "{\"from\":";
+        appendInteger(leg.vertices.front());
+        buffer_ += ",\"to\":";
+        appendInteger(leg.vertices.back());
+        buffer_ += ",\"miles\":";
+        appendExact(leg.miles);
+        buffer_ += ",\"hours\":";
+        appendExact(leg.hours);
+        buffer_ += '}';
+    }
+
+    buffer_ += "]}\n";
+}
+
+
+void RouteWriter::appendBinary(const RoadMap& roadMap, const Trip& trip, const Route& route)
+{
+    findSegmentHours(roadMap, trip, route);
+
+    appendBytes(tripIndex_, 4);
+    appendBytes(trip.metric == TripMetric::Time ? 1 : 0, 1);
+    appendBytes(route.vertices.empty() ? 0 : 1, 1);
+    appendBytes(0, 2);
+    appendBytes(route.vertices.size(), 4);
+    appendBytes(route.miles);
+    appendBytes(route.hours);
+
+    for (int vertex : route.vertices)
+    {
+        appendBytes(static_cast<std::uint32_t>(vertex), 4);
+    }
+
+    for (std::size_t i = 1; i < route.vertices.size(); ++i)
+    {
+        appendBytes(roadMap.findEdgeInfo(route.vertices[i - 1], route.vertices[i])->miles);
+        appendBytes(segmentHours_[i - 1] + turnHours_[i - 1]);
+    }
+
+    appendBytes(route.legs.size(), 4);
+
+    for (const Route& leg : route.legs)
+    {
+        appendBytes(static_cast<std::uint32_t>(leg.vertices.front()), 4);
+        appendBytes(static_cast<std::uint32_t>(leg.vertices.back()), 4);
+        appendBytes(leg.miles);
+        appendBytes(leg.hours);
+    }
+}
+
+
+void RouteWriter::findSegmentHours(const RoadMap& roadMap, const Trip& trip, const Route& route)
+{
+    segmentHours_.clear();
+    turnHours_.clear();
+
+    // Driving times with a departure time depend on when each segment
+    // is entered, which is when the one before it was finished.
+    double hour = trip.departureTime.value_or(0.0);
+
+    // The planner doesn't charge for turns made at a stop, where the trip
+    // ends one leg and starts the next, so neither is anything here.
+    std::size_t nextStop = route.vertices.size();
+    auto leg = route.legs.begin();
+
+    if (leg != route.legs.end())
+    {
+        nextStop = leg->vertices.size() - 1;
+    }
+
+    for (std::size_t i = 1; i < route.vertices.size(); ++i)
+    {
+        const RoadSegment& segment = *roadMap.findEdgeInfo(route.vertices[i - 1], route.vertices[i]);
+
+        double hours = trip.departureTime && trip.metric == TripMetric::Time
+            ? travelHours(segment, hour)
+            : segment.miles / segment.milesPerHour;
+
+        double turnHours = 0.0;
+
+        if (i - 1 == nextStop)
+        {
+            // A stop repeated in a row makes a leg with no segments, so
+            // more than one leg can end here.
+            while (leg != route.legs.end() && i - 1 == nextStop)
+            {
+                ++leg;
+
+                if (leg != route.legs.end())
+                {
+                    nextStop += leg->vertices.size() - 1;
+                }
+            }
+        }
+        else if (i >= 2 && turns_ != nullptr)
+        {
+            turnHours = turns_->penaltyHours(route.vertices[i - 2], route.vertices[i - 1], route.vertices[i]);
+        }
+
+        hour += hours;
+        segmentHours_.push_back(hours);
+        turnHours_.push_back(turnHours);
+    }
+}
+
+
+void RouteWriter::appendName(const RoadMap& roadMap, int vertex)
+{
+    const std::string_view* name = roadMap.findVertexInfo(vertex);
+
+    if (name == nullptr)
+    {
+        throw DigraphException("No appropriate vertex found!");
+    }
+
+    buffer_ += *name;
+}
+
+
+void RouteWriter::appendDecimal(double value)
+{
+    char digits[32];
+    std::to_chars_result result = std::to_chars(
+        digits, digits + sizeof(digits), value, std::chars_format::fixed, 1);
+
+    buffer_.append(digits, result.ptr);
+}
+
+
+void RouteWriter::appendInteger(std::int64_t value)
+{
+    char digits[24];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+
+    buffer_.append(digits, result.ptr);
+}
+
+
+void RouteWriter::appendExact(double value)
+{
+    char digits[32];
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+
+    buffer_.append(digits, result.ptr);
+}
+
+
+void RouteWriter::appendBytes(std::uint64_t value, unsigned int byteCount)
+{
+    for (unsigned int i = 0; i < byteCount; ++i)
+    {
+        buffer_ += static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+
+void RouteWriter::appendBytes(double value)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    appendBytes(bits, 8);
+}
+
+
+void RouteWriter::appendDuration(double hours)
+{
+    // Rounding to tenths of a second first keeps, say, 59.96 seconds from
+    // being written as "60.0 secs" rather than as another minute.
+    std::int64_t tenths = std::llround(hours * 36000.0);
+
+    if (tenths >= 36000)
+    {
+        appendInteger(tenths / 36000);
+        buffer_ += " hrs ";
+    }
+
+    if (tenths >= 600)
+    {
+        appendInteger(tenths % 36000 / 600);
+        buffer_ += " mins ";
+    }
+
+    appendInteger(tenths % 600 / 10);
+    buffer_ += '.';
+    appendInteger(tenths % 10);
+    buffer_ += " secs";
+}
+
@@ -0,0 +1,174 @@
+// RouteWriter.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A RouteWriter writes the program's report for each trip: the route,
+// one road segment per line, followed by its total distance or driving
+// time.  For example:
+//
+//     Shortest driving time from Anteater Stadium to Newport Beach
+//       Begin at Anteater Stadium
+//       Continue to UCI Campus (2.1 miles @ 25.0mph = 5 mins 2.4 secs)
+//       Continue to Newport Beach (3.5 miles @ 50.0mph = 4 mins 12.0 secs)
+//     Total time: 9 mins 14.4 secs
+//
+// When the routes were planned obeying a TurnTable, each turn that costs
+// extra time gets a line of its own, just before the segment it turns
+// onto, so the times listed always add up to the total:
+//
+//       Turn at UCI Campus (2 mins 0.0 secs)
+//
+// A trip with intermediate stops also gets a list of its legs, one line
+// per leg, just before the total:
+//
+//       Legs:
+//         1. Anteater Stadium to UCI Campus (2.1 miles, 5 mins 2.4 secs)
+//         2. UCI Campus to Newport Beach (3.5 miles, 4 mins 12.0 secs)
+//
+// For other programs to read, a RouteWriter can instead write each trip
+// as one record in a machine-readable format, chosen when it's created:
+//
+// * JsonLines: one JSON object per line, such as
+//
+//       {"trip":1,"metric":"time","found":true,"vertices":[0,2,3],
+//        "miles":[7.5,6],"hours":[0.10714285714285714,0.15],
+//        "totalMiles":13.5,"totalHours":0.2571428571428571,
+//        "legs":[{"from":0,"to":2,"miles":7.5,"hours":0.10714285714285714},
+//                {"from":2,"to":3,"miles":6,"hours":0.15}]}
+//
+//   where "miles" and "hours" have one entry per road segment (each
+//   segment's hours including the penalty for turning onto it), "legs"
+//   has one entry per leg of a trip with intermediate stops (and is
+//   empty otherwise), and numbers are written with as many digits as
+//   needed to read them back exactly.
+//
+// * Binary: the four bytes "RTE1", then one record per trip, made up of
+//   little-endian fields: the trip index (u32), the metric (u8: 0 for
+//   distance, 1 for time), whether a route was found (u8), two bytes of
+//   padding, the number of vertices n (u32), the total miles and total
+//   hours (f64 each), the n vertex numbers (i32 each), the miles and
+//   hours (f64 each, the hours including the penalty for turning onto the
+//   segment) of each of the n - 1 road segments in turn, and then
+//   the number of legs (u32) followed by each leg's start and end vertex
+//   numbers (i32 each), miles, and hours (f64 each).
+//
+// In every format, a trip's index is its position among the trips the
+// RouteWriter has written, starting at 0, and an unreachable trip has an
+// empty route with zero totals.
+//
+// Output is formatted into a buffer that's reused from trip to trip and
+// only written to the output stream when it fills up (or on flush()), so
+// writing a large batch of routes makes few, large writes and no memory
+// allocations once the buffer has grown to size.
+
+#ifndef ROUTEWRITER_HPP
+#define ROUTEWRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "RoadMap.hpp"
+#include "Route.hpp"
+#include "Trip.hpp"
+#include "TurnTable.hpp"
+
+
+
+enum class RouteFormat
+{
+    Text,
+    JsonLines,
+    Binary
+};
+
+
+
+class RouteWriter
+{
+public:
+    // Initializes a RouteWriter that writes in the given format to the
+    // given output stream, once at least flushThreshold bytes are waiting.
+    explicit RouteWriter(
+        std::ostream& out, RouteFormat format = RouteFormat::Text,
+        std::size_t flushThreshold = 1 << 16);
+
+    // Initializes a RouteWriter like the one above, for routes that were
+    // planned obeying the given TurnTable, which must outlive it.
+    RouteWriter(
+        std::ostream& out, const TurnTable& turns, RouteFormat format = RouteFormat::Text,
+        std::size_t flushThreshold = 1 << 16);
+
+    // Anything still in the buffer is written when the RouteWriter is
+    // destroyed.
+    ~RouteWriter() noexcept;
+
+    RouteWriter(const RouteWriter&) = delete;
+    RouteWriter& operator=(const RouteWriter&) = delete;
+
+    // writeRoute() writes the report (or record) for the given trip, whose
+    // route was planned on the given RoadMap.
+    void writeRoute(const RoadMap& roadMap, const Trip& trip, const Route& route);
+
+    // This overload of writeRoute() gives the trip the given index, with
+    // later trips numbered onward from there.
+    void writeRoute(const RoadMap& roadMap, std::uint32_t tripIndex, const Trip& trip, const Route& route);
+
+    // writeError() writes, in place of a route, a message saying why the
+    // trip with the given index couldn't be planned: as a line of text, or
+    // as a JSON object with "trip" and "error" fields.  Binary records
+    // have no room for a message, so a binary writer writes the record of
+    // a trip with no route.
+    void writeError(std::uint32_t tripIndex, TripMetric metric, const std::string& message);
+
+    // flush() writes everything in the buffer to the output stream.
+    void flush();
+
+    // parseFormat() converts "text", "json", or "binary" into a
+    // RouteFormat, throwing a std::invalid_argument for anything else.
+    static RouteFormat parseFormat(const std::string& name);
+
+private:
+    // Each format has its own function to append one trip's record.
+    void appendText(const RoadMap& roadMap, const Trip& trip, const Route& route);
+    void appendJson(const RoadMap& roadMap, const Trip& trip, const Route& route);
+    void appendBinary(const RoadMap& roadMap, const Trip& trip, const Route& route);
+
+    // findSegmentHours() works out the driving time of each road segment
+    // of the route, in order, leaving them in segmentHours_, and the
+    // penalty for the turn onto each one in turnHours_.
+    void findSegmentHours(const RoadMap& roadMap, const Trip& trip, const Route& route);
+
+    void appendName(const RoadMap& roadMap, int vertex);
+    void appendDecimal(double value);
+    void appendInteger(std::int64_t value);
+
+    // appendExact() appends a number with as many digits as are needed to
+    // read it back exactly.
+    void appendExact(double value);
+
+    // appendBytes() appends the given number of low-order bytes of the
+    // given value, least significant first.
+    void appendBytes(std::uint64_t value, unsigned int byteCount);
+    void appendBytes(double value);
+
+    // appendDuration() appends a number of hours as hours, minutes, and
+    // seconds, leaving out hours and minutes when they're zero.
+    void appendDuration(double hours);
+
+    std::ostream& out_;
+    RouteFormat format_;
+    std::size_t flushThreshold_;
+    std::string buffer_;
+    std::uint32_t tripIndex_;
+    const TurnTable* turns_;
+    std::vector<double> segmentHours_;
+    std::vector<double> turnHours_;
+};
+
+
+
+#endif
+
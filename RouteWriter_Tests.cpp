@@ -0,0 +1,438 @@
+// RouteWriter_Tests.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// Unit tests for RouteWriter, checking each output format byte for byte
+// (or, for binary records, field by field) on a small named map.
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include "RouteWriter.hpp"
+#include "TripPlanner.hpp"
+
+
+namespace
+{
+    RoadMap makeRoadMap()
+    {
+        RoadMap roadMap;
+        roadMap.addVertex(0, "Anteater Stadium");
+        roadMap.addVertex(1, "UCI Campus");
+        roadMap.addVertex(2, "Newport Beach");
+        roadMap.addEdge(0, 1, RoadSegment{2.1, 25.0});
+        roadMap.addEdge(1, 2, RoadSegment{3.5, 50.0});
+
+        return roadMap;
+    }
+
+
+    Trip makeTrip(TripMetric metric, std::vector<int> stops = {})
+    {
+        Trip trip{0, 2, metric};
+        trip.stops = std::move(stops);
+
+        return trip;
+    }
+
+
+    std::string write(RouteFormat format, const RoadMap& roadMap, const Trip& trip)
+    {
+        std::ostringstream out;
+
+        {
+            RouteWriter writer{out, format};
+            writer.writeRoute(roadMap, trip, TripPlanner{}.planTrips(roadMap, {trip}).front());
+        }
+
+        return out.str();
+    }
+
+
+    // A BinaryRecords reads the little-endian fields of binary output back
+    // in order.
+    class BinaryRecords
+    {
+    public:
+        explicit BinaryRecords(std::string bytes)
+            : bytes_{std::move(bytes)}, position_{0}
+        {
+        }
+
+        std::uint64_t readUnsigned(unsigned int byteCount)
+        {
+            std::uint64_t value = 0;
+
+            for (unsigned int i = 0; i < byteCount; ++i)
+            {
+                value |= std::uint64_t{static_cast<unsigned char>(bytes_.at(position_++))} << (8 * i);
+            }
+
+            return value;
+        }
+
+        std::int32_t readInt()
+        {
+            return static_cast<std::int32_t>(readUnsigned(4));
+        }
+
+        double readDouble()
+        {
+            std::uint64_t bits = readUnsigned(8);
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+
+            return value;
+        }
+
+        std::string readString(std::size_t length)
+        {
+            position_ += length;
+            return bytes_.substr(position_ - length, length);
+        }
+
+        bool atEnd() const noexcept
+        {
+            return position_ == bytes_.size();
+        }
+
+    private:
+        std::string bytes_;
+        std::size_t position_;
+    };
+}
+
+
+TEST(RouteWriter_Tests, textReportsAreExact)
+{
+    RoadMap roadMap = makeRoadMap();
+    std::vector<Trip> trips{
+        makeTrip(TripMetric::Time),
+        makeTrip(TripMetric::Distance),
+        Trip{2, 0, TripMetric::Distance}};
+
+    std::vector<Route> routes = TripPlanner{}.planTrips(roadMap, trips);
+
+    // A threshold of one byte flushes after every trip, which mustn't
+    // change what's written.
+    for (std::size_t flushThreshold : {std::size_t{1}, std::size_t{1} << 16})
+    {
+        std::ostringstream out;
+
+        {
+            RouteWriter writer{out, RouteFormat::Text, flushThreshold};
+
+            for (std::size_t i = 0; i < trips.size(); ++i)
+            {
+                writer.writeRoute(roadMap, trips[i], routes[i]);
+            }
+
+            writer.writeError(3, TripMetric::Time, "No appropriate vertex found!");
+        }
+
+        ASSERT_EQ(
+            "Shortest driving time from Anteater Stadium to Newport Beach\n"
+            "  Begin at Anteater Stadium\n"
+            "  Continue to UCI Campus (2.1 miles @ 25.0mph = 5 mins 2.4 secs)\n"
+            "  Continue to Newport Beach (3.5 miles @ 50.0mph = 4 mins 12.0 secs)\n"
+            "Total time: 9 mins 14.4 secs\n"
+            "\n"
+            "Shortest distance from Anteater Stadium to Newport Beach\n"
+            "  Begin at Anteater Stadium\n"
+            "  Continue to UCI Campus (2.1 miles)\n"
+            "  Continue to Newport Beach (3.5 miles)\n"
+            "Total distance: 5.6 miles\n"
+            "\n"
+            "Shortest distance from Newport Beach to Anteater Stadium\n"
+            "  No route\n"
+            "Total distance: 0.0 miles\n"
+            "\n"
+            "Trip 3: No appropriate vertex found!\n"
+            "\n",
+            out.str());
+    }
+}
+
+
+TEST(RouteWriter_Tests, textDurationsRoundToTenthsOfASecond)
+{
+    // 0.999999 hours is 3599.9964 seconds, which rounds up to an hour.
+    RoadMap roadMap;
+    roadMap.addVertex(0, "Here");
+    roadMap.addVertex(1, "There");
+    roadMap.addEdge(0, 1, RoadSegment{99.9999, 100.0});
+
+    Trip trip{0, 1, TripMetric::Time};
+
+    std::ostringstream out;
+
+    {
+        RouteWriter writer{out};
+        writer.writeRoute(roadMap, trip, Route{{0, 1}, 99.9999, 0.999999});
+    }
+
+    ASSERT_EQ(
+        "Shortest driving time from Here to There\n"
+        "  Begin at Here\n"
+        "  Continue to There (100.0 miles @ 100.0mph = 1 hrs 0 mins 0.0 secs)\n"
+        "Total time: 1 hrs 0 mins 0.0 secs\n"
+        "\n",
+        out.str());
+}
+
+
+TEST(RouteWriter_Tests, jsonRecordsAreExact)
+{
+    RoadMap roadMap = makeRoadMap();
+    std::vector<Trip> trips{makeTrip(TripMetric::Time), Trip{2, 0, TripMetric::Distance}};
+    std::vector<Route> routes = TripPlanner{}.planTrips(roadMap, trips);
+
+    std::ostringstream out;
+
+    {
+        RouteWriter writer{out, RouteFormat::JsonLines};
+        writer.writeRoute(roadMap, trips[0], routes[0]);
+        writer.writeRoute(roadMap, trips[1], routes[1]);
+        writer.writeError(2, TripMetric::Time, "Bad \"trip\"\\\nline");
+    }
+
+    ASSERT_EQ(
+        "{\"trip\":0,\"metric\":\"time\",\"found\":true,\"vertices\":[0,1,2],"
+        "\"miles\":[2.1,3.5],\"hours\":[0.084,0.07],"
+        "\"totalMiles\":5.6,\"totalHours\":0.15400000000000003,\"legs\":[]}\n"
+        "{\"trip\":1,\"metric\":\"distance\",\"found\":false,\"vertices\":[],"
+        "\"miles\":[],\"hours\":[],\"totalMiles\":0,\"totalHours\":0,\"legs\":[]}\n"
+        "{\"trip\":2,\"error\":\"Bad \\\"trip\\\"\\\\ line\"}\n",
+        out.str());
+}
+
+
+TEST(RouteWriter_Tests, binaryRecordsReadBackExactly)
+{
+    RoadMap roadMap = makeRoadMap();
+    std::vector<Trip> trips{
+        makeTrip(TripMetric::Time, {1}),
+        makeTrip(TripMetric::Distance),
+        Trip{2, 0, TripMetric::Time}};
+
+    std::vector<Route> routes = TripPlanner{}.planTrips(roadMap, trips);
+    std::ostringstream out;
+
+    {
+        RouteWriter writer{out, RouteFormat::Binary};
+
+        for (std::size_t i = 0; i < trips.size(); ++i)
+        {
+            writer.writeRoute(roadMap, 10 + static_cast<std::uint32_t>(i), trips[i], routes[i]);
+        }
+
+        writer.writeError(13, TripMetric::Distance, "ignored");
+    }
+
+    BinaryRecords records{out.str()};
+    ASSERT_EQ("RTE1", records.readString(4));
+
+    for (std::size_t i = 0; i < trips.size(); ++i)
+    {
+        const Route& route = routes[i];
+
+        ASSERT_EQ(10 + i, records.readUnsigned(4));
+        ASSERT_EQ(trips[i].metric == TripMetric::Time ? 1 : 0, records.readUnsigned(1));
+        ASSERT_EQ(route.vertices.empty() ? 0 : 1, records.readUnsigned(1));
+        ASSERT_EQ(0, records.readUnsigned(2));
+        ASSERT_EQ(route.vertices.size(), records.readUnsigned(4));
+        ASSERT_EQ(route.miles, records.readDouble());
+        ASSERT_EQ(route.hours, records.readDouble());
+
+        for (int vertex : route.vertices)
+        {
+            ASSERT_EQ(vertex, records.readInt());
+        }
+
+        for (std::size_t j = 1; j < route.vertices.size(); ++j)
+        {
+            const RoadSegment& segment = roadMap.edgeInfo(route.vertices[j - 1], route.vertices[j]);
+            ASSERT_EQ(segment.miles, records.readDouble());
+            ASSERT_EQ(segment.miles / segment.milesPerHour, records.readDouble());
+        }
+
+        ASSERT_EQ(route.legs.size(), records.readUnsigned(4));
+
+        for (const Route& leg : route.legs)
+        {
+            ASSERT_EQ(leg.vertices.front(), records.readInt());
+            ASSERT_EQ(leg.vertices.back(), records.readInt());
+            ASSERT_EQ(leg.miles, records.readDouble());
+            ASSERT_EQ(leg.hours, records.readDouble());
+        }
+    }
+
+    // An error is written as the record of a trip with no route.
+    ASSERT_EQ(13, records.readUnsigned(4));
+    ASSERT_EQ(0, records.readUnsigned(1));
+    ASSERT_EQ(0, records.readUnsigned(1));
+    ASSERT_EQ(0, records.readUnsigned(2));
+    ASSERT_EQ(0, records.readUnsigned(4));
+    ASSERT_EQ(0.0, records.readDouble());
+    ASSERT_EQ(0.0, records.readDouble());
+    ASSERT_EQ(0, records.readUnsigned(4));
+    ASSERT_TRUE(records.atEnd());
+}
+
+
+TEST(RouteWriter_Tests, formatsParseByName)
+{
+    ASSERT_EQ(RouteFormat::Text, RouteWriter::parseFormat("text"));
+    ASSERT_EQ(RouteFormat::JsonLines, RouteWriter::parseFormat("json"));
+    ASSERT_EQ(RouteFormat::Binary, RouteWriter::parseFormat("binary"));
+    ASSERT_THROW(RouteWriter::parseFormat("xml"), std::invalid_argument);
+}
+
+
+TEST(RouteWriter_Tests, turnPenaltiesAddUpToTheTotal)
+{
+    RoadMap roadMap = makeRoadMap();
+    TurnTable turns{{TurnRule{0, 1, 2, 1.0f / 30.0f}}};
+    TripPlanner planner{turns};
+
+    // A stop at the vertex where the turn is made ends one leg and starts
+    // the next, so the turn there isn't charged for.
+    std::vector<Trip> trips{makeTrip(TripMetric::Time), makeTrip(TripMetric::Time, {1})};
+    std::vector<Route> routes = planner.planTrips(roadMap, trips);
+
+    std::ostringstream text;
+    std::ostringstream json;
+
+    {
+        RouteWriter textWriter{text, turns};
+        RouteWriter jsonWriter{json, turns, RouteFormat::JsonLines};
+
+        for (std::size_t i = 0; i < trips.size(); ++i)
+        {
+            textWriter.writeRoute(roadMap, trips[i], routes[i]);
+            jsonWriter.writeRoute(roadMap, trips[i], routes[i]);
+        }
+    }
+
+    ASSERT_EQ(
+        "Shortest driving time from Anteater Stadium to Newport Beach\n"
+        "  Begin at Anteater Stadium\n"
+        "  Continue to UCI Campus (2.1 miles @ 25.0mph = 5 mins 2.4 secs)\n"
+        "  Turn at UCI Campus (2 mins 0.0 secs)\n"
+        "  Continue to Newport Beach (3.5 miles @ 50.0mph = 4 mins 12.0 secs)\n"
+        "Total time: 11 mins 14.4 secs\n"
+        "\n",
+        text.str().substr(0, text.str().find("\n\n") + 2));
+    ASSERT_EQ(std::string::npos, text.str().find("Turn at", text.str().find("\n\n")));
+
+    // Each line's segment hours add up to its total hours.
+    std::istringstream lines{json.str()};
+    std::string line;
+
+    for (const Route& route : routes)
+    {
+        ASSERT_TRUE(std::getline(lines, line));
+
+        std::size_t start = line.find("\"hours\":[") + 9;
+        std::istringstream hours{line.substr(start, line.find(']', start) - start)};
+        double sum = 0.0;
+
+        for (std::string hour; std::getline(hours, hour, ',');)
+        {
+            sum += std::stod(hour);
+        }
+
+        ASSERT_NEAR(route.hours, sum, 1e-12);
+    }
+
+    ASSERT_NEAR(routes[0].hours, 2.1 / 25.0 + 3.5 / 50.0 + 1.0f / 30.0f, 1e-12);
+}
+
+
+TEST(RouteWriter_Tests, noTurnsChargedAtRepeatedStops)
+{
+    RoadMap roadMap = makeRoadMap();
+    roadMap.addVertex(3, "Costa Mesa");
+    roadMap.addEdge(2, 3, RoadSegment{3.0, 30.0});
+
+    TurnTable turns{{TurnRule{0, 1, 2, 1.0f / 30.0f}, TurnRule{1, 2, 3, 1.0f / 30.0f}}};
+
+    // Stopping at 1 twice in a row makes a leg with no segments, after
+    // which the stop at 2 still ends a leg.
+    Trip trip{0, 3, TripMetric::Time};
+    trip.stops = {1, 1, 2};
+    Route route = TripPlanner{turns}.planTrips(roadMap, {trip}).front();
+
+    ASSERT_EQ((std::vector<int>{0, 1, 2, 3}), route.vertices);
+    ASSERT_EQ(4, route.legs.size());
+
+    std::ostringstream text;
+    std::ostringstream json;
+
+    {
+        RouteWriter textWriter{text, turns};
+        RouteWriter jsonWriter{json, turns, RouteFormat::JsonLines};
+        textWriter.writeRoute(roadMap, trip, route);
+        jsonWriter.writeRoute(roadMap, trip, route);
+    }
+
+    ASSERT_EQ(std::string::npos, text.str().find("Turn at"));
+    ASSERT_NE(std::string::npos, json.str().find("\"hours\":[0.084,0.07,0.1],"));
+    ASSERT_NEAR(2.1 / 25.0 + 3.5 / 50.0 + 3.0 / 30.0, route.hours, 1e-12);
+}
+
+
+TEST(RouteWriter_Tests, textListsLegsOfMultiStopTrips)
+{
+    ASSERT_EQ(
+        "Shortest driving time from Anteater Stadium to Newport Beach\n"
+        "  Begin at Anteater Stadium\n"
+        "  Continue to UCI Campus (2.1 miles @ 25.0mph = 5 mins 2.4 secs)\n"
+        "  Continue to Newport Beach (3.5 miles @ 50.0mph = 4 mins 12.0 secs)\n"
+        "  Legs:\n"
+        "    1. Anteater Stadium to UCI Campus (2.1 miles, 5 mins 2.4 secs)\n"
+        "    2. UCI Campus to Newport Beach (3.5 miles, 4 mins 12.0 secs)\n"
+        "Total time: 9 mins 14.4 secs\n"
+        "\n",
+        write(RouteFormat::Text, makeRoadMap(), makeTrip(TripMetric::Time, {1})));
+}
+
+
+TEST(RouteWriter_Tests, jsonListsLegsOfMultiStopTrips)
+{
+    RoadMap roadMap = makeRoadMap();
+
+    std::string withStop = write(RouteFormat::JsonLines, roadMap, makeTrip(TripMetric::Distance, {1}));
+    ASSERT_NE(std::string::npos, withStop.find(",\"legs\":[{\"from\":0,\"to\":1,\"miles\":2.1,\"hours\":"));
+    ASSERT_NE(std::string::npos, withStop.find("},{\"from\":1,\"to\":2,\"miles\":3.5,\"hours\":0.07}]}\n"));
+
+    std::string withoutStop = write(RouteFormat::JsonLines, roadMap, makeTrip(TripMetric::Distance));
+    ASSERT_NE(std::string::npos, withoutStop.find(",\"legs\":[]}\n"));
+}
+
+
+TEST(RouteWriter_Tests, binaryListsLegsOfMultiStopTrips)
+{
+    BinaryRecords records{write(RouteFormat::Binary, makeRoadMap(), makeTrip(TripMetric::Time, {1}))};
+
+    ASSERT_EQ("RTE1", records.readString(4));
+    records.readString(8);
+    ASSERT_EQ(3, records.readUnsigned(4));
+    records.readString(2 * 8 + 3 * 4 + 2 * 2 * 8);
+
+    ASSERT_EQ(2, records.readUnsigned(4));
+    ASSERT_EQ(0, records.readInt());
+    ASSERT_EQ(1, records.readInt());
+    ASSERT_DOUBLE_EQ(2.1, records.readDouble());
+    ASSERT_DOUBLE_EQ(2.1 / 25.0, records.readDouble());
+    ASSERT_EQ(1, records.readInt());
+    ASSERT_EQ(2, records.readInt());
+    ASSERT_DOUBLE_EQ(3.5, records.readDouble());
+    ASSERT_DOUBLE_EQ(0.07, records.readDouble());
+    ASSERT_TRUE(records.atEnd());
+}
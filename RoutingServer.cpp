@@ -0,0 +1,230 @@
+// RoutingServer.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <exception>
+#include <future>
+#include <optional>
+#include <sstream>
+#include <thread>
+#include <utility>
+#include <unistd.h>
+#include "RouteWriter.hpp"
+#include "RoutingServer.hpp"
+#include "TripPlanner.hpp"
+#include "TripReader.hpp"
+
+
+namespace
+{
+    // The servers given no TurnTable share this empty one, which allows
+    // every turn.
+    const TurnTable& noTurns()
+    {
+        static const TurnTable turns;
+        return turns;
+    }
+}
+
+
+RoutingServer::RoutingServer(const RoadMap& roadMap, unsigned int workerCount, std::size_t maxQueueDepth)
+    : RoutingServer{roadMap, noTurns(), workerCount, maxQueueDepth}
+{
+}
+
+
+RoutingServer::RoutingServer(
+    const RoadMap& roadMap, const TurnTable& turns, unsigned int workerCount, std::size_t maxQueueDepth)
+    : roadMap_{roadMap}, turns_{turns}, locations_{roadMap},
+      router_{roadMap, turns, workerCount, maxQueueDepth}, stopping_{false}
+{
+}
+
+
+RoutingServer::RoutingServer(
+    const NumaReplicas<RoadMap>& replicas, unsigned int workerCount, std::size_t maxQueueDepth)
+    : RoutingServer{replicas, noTurns(), workerCount, maxQueueDepth}
+{
+}
+
+
+RoutingServer::RoutingServer(
+    const NumaReplicas<RoadMap>& replicas, const TurnTable& turns, unsigned int workerCount,
+    std::size_t maxQueueDepth)
+    : roadMap_{replicas.onNode(0)}, turns_{turns}, locations_{roadMap_},
+      router_{replicas, turns, workerCount, maxQueueDepth}, stopping_{false}
+{
+}
+
+
+void RoutingServer::serve(const std::string& socketPath)
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        listener_ = std::make_shared<UnixSocket>(UnixSocket::listenAt(socketPath));
+
+        if (stopping_)
+        {
+            listener_->shutdown();
+        }
+    }
+
+    while (true)
+    {
+        std::shared_ptr<UnixSocket> connection;
+
+        try
+        {
+            connection = std::make_shared<UnixSocket>(listener_->accept());
+        }
+        catch (const std::exception&)
+        {
+            std::lock_guard<std::mutex> lock{mutex_};
+
+            if (stopping_)
+            {
+                break;
+            }
+
+            throw;
+        }
+
+        std::lock_guard<std::mutex> lock{mutex_};
+
+        if (stopping_)
+        {
+            break;
+        }
+
+        connections_.push_back(connection);
+
+        // Connection threads are detached; serve() instead waits below
+        // for every connection to be taken off the list.
+        std::thread{[this, connection]() { serveConnection(connection); }}.detach();
+    }
+
+    std::unique_lock<std::mutex> lock{mutex_};
+    allClosed_.wait(lock, [this]() { return connections_.empty(); });
+
+    listener_.reset();
+    ::unlink(socketPath.c_str());
+}
+
+
+void RoutingServer::serve(UnixSocket connection)
+{
+    auto shared = std::make_shared<UnixSocket>(std::move(connection));
+
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        connections_.push_back(shared);
+
+        if (stopping_)
+        {
+            shared->shutdown();
+        }
+    }
+
+    serveConnection(shared);
+}
+
+
+void RoutingServer::stop()
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    stopping_ = true;
+
+    if (listener_)
+    {
+        listener_->shutdown();
+    }
+
+    for (const std::shared_ptr<UnixSocket>& connection : connections_)
+    {
+        connection->shutdown();
+    }
+}
+
+
+std::string RoutingServer::answerBatch(const std::vector<std::string>& lines, std::uint32_t firstIndex)
+{
+    std::vector<Trip> trips;
+    std::vector<std::optional<std::future<Route>>> routes(lines.size());
+    std::vector<std::string> errors(lines.size());
+
+    // Every request is submitted before waiting for any of them, so they
+    // can all be planned in the same micro-batch.
+    for (std::size_t i = 0; i < lines.size(); ++i)
+    {
+        try
+        {
+            trips.push_back(TripReader::parseTrip(lines[i], &locations_));
+            routes[i] = router_.submit(trips.back());
+        }
+        catch (const std::exception& e)
+        {
+            trips.push_back(Trip{0, 0, TripMetric::Distance});
+            errors[i] = e.what();
+        }
+    }
+
+    std::ostringstream answers;
+
+    {
+        RouteWriter writer{answers, turns_, RouteFormat::JsonLines};
+
+        for (std::size_t i = 0; i < lines.size(); ++i)
+        {
+            std::uint32_t index = firstIndex + static_cast<std::uint32_t>(i);
+
+            if (routes[i])
+            {
+                try
+                {
+                    Route route = routes[i]->get();
+                    writer.writeRoute(roadMap_, index, trips[i], route);
+                    continue;
+                }
+                catch (const std::exception& e)
+                {
+                    errors[i] = e.what();
+                }
+            }
+
+            writer.writeError(index, trips[i].metric, errors[i]);
+        }
+    }
+
+    return answers.str();
+}
+
+
+void RoutingServer::serveConnection(std::shared_ptr<UnixSocket> connection)
+{
+    std::uint32_t nextIndex = 0;
+    std::vector<std::string> lines;
+
+    connection->setMaxLineLength(maxRequestLength);
+
+    try
+    {
+        while (connection->readLines(lines))
+        {
+            connection->writeAll(answerBatch(lines, nextIndex));
+
+            nextIndex += static_cast<std::uint32_t>(lines.size());
+            lines.clear();
+        }
+    }
+    catch (const std::exception&)
+    {
+        // A connection that fails, or sends a request that's too long, is
+        // simply dropped; the client will see it close.
+    }
+
+    std::lock_guard<std::mutex> lock{mutex_};
+    connections_.remove(connection);
+    allClosed_.notify_all();
+}
+
@@ -0,0 +1,123 @@
+// RoutingServer.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A RoutingServer answers trip requests over a Unix domain socket, so
+// that a RoadMap can be loaded once and then queried for as long as the
+// server runs.  The protocol is framed by newlines: each request is one
+// trip line, in the same format TripReader reads (e.g., "0 3 T 7:45"; the
+// server indexes location names when it starts, so "\"UCI Campus\"
+// \"Tustin\" D" works too), and each is answered by one line of JSON, in
+// the JSON Lines format written by RouteWriter, or by a
+// {"trip":N,"error":"..."} line if it couldn't be planned.  A connection's
+// requests are numbered from 0, in the order they were sent, and answered
+// in that order.  A connection that sends a request line longer than
+// maxRequestLength bytes is dropped.
+//
+// A client may send many requests without waiting for answers.  Requests
+// from all connections are handed to an AsyncRouter, which plans them in
+// micro-batches on a fixed pool of worker threads, so that trips from the
+// same start vertex share searches even across connections.
+//
+// A RoutingServer given the map's TurnTable plans every trip obeying it,
+// and the hours its answers give for each segment include the penalty of
+// the turn onto it, so that they still add up to the total.
+
+#ifndef ROUTINGSERVER_HPP
+#define ROUTINGSERVER_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "AsyncRouter.hpp"
+#include "LocationIndex.hpp"
+#include "NumaReplicas.hpp"
+#include "RoadMap.hpp"
+#include "TurnTable.hpp"
+#include "UnixSocket.hpp"
+
+
+
+class RoutingServer
+{
+public:
+    // The longest request line, in bytes, that a connection may send.
+    static constexpr std::size_t maxRequestLength = 1 << 16;
+
+    // Initializes a RoutingServer that answers requests about the given
+    // RoadMap with the given number of worker threads (0 meaning one per
+    // core), queueing at most maxQueueDepth requests before connections
+    // have to wait.  The RoadMap must outlive the RoutingServer.
+    RoutingServer(const RoadMap& roadMap, unsigned int workerCount, std::size_t maxQueueDepth = 4096);
+
+    // Initializes a RoutingServer the same way, except that it plans trips
+    // obeying the given TurnTable, which must also outlive it.
+    RoutingServer(
+        const RoadMap& roadMap, const TurnTable& turns, unsigned int workerCount,
+        std::size_t maxQueueDepth = 4096);
+
+    // Initializes a RoutingServer that plans trips on a copy of the RoadMap
+    // on each NUMA node, with its workers pinned across the nodes (see
+    // AsyncRouter.hpp).  The replicas must outlive the RoutingServer.
+    RoutingServer(
+        const NumaReplicas<RoadMap>& replicas, unsigned int workerCount,
+        std::size_t maxQueueDepth = 4096);
+
+    // Initializes a RoutingServer on NUMA replicas that plans trips obeying
+    // the given TurnTable, which must also outlive it.
+    RoutingServer(
+        const NumaReplicas<RoadMap>& replicas, const TurnTable& turns, unsigned int workerCount,
+        std::size_t maxQueueDepth = 4096);
+
+    RoutingServer(const RoutingServer&) = delete;
+    RoutingServer& operator=(const RoutingServer&) = delete;
+
+    // serve() listens for connections on a socket at the given path and
+    // answers their requests, returning only after stop() is called and
+    // every connection has been closed.  The socket file is removed
+    // before serve() returns.
+    void serve(const std::string& socketPath);
+
+    // This overload of serve() answers the requests arriving on one
+    // already-connected socket (such as one end of a UnixSocket::pair())
+    // on the calling thread, returning once the peer closes it or stop()
+    // is called.
+    void serve(UnixSocket connection);
+
+    // stop() makes serve() stop accepting connections and close the ones
+    // it has.  It can be called from any thread, but not from a signal
+    // handler.
+    void stop();
+
+    // answerBatch() answers the given request lines, the first of which
+    // is numbered firstIndex, returning the answer lines.  This is what
+    // the server does with the requests that arrive on a connection.
+    std::string answerBatch(const std::vector<std::string>& lines, std::uint32_t firstIndex);
+
+private:
+    // serveConnection() answers a connection's requests until it's
+    // closed, on a thread of its own.
+    void serveConnection(std::shared_ptr<UnixSocket> connection);
+
+    const RoadMap& roadMap_;
+    const TurnTable& turns_;
+    LocationIndex locations_;
+    AsyncRouter router_;
+
+    std::mutex mutex_;
+    std::condition_variable allClosed_;
+    std::shared_ptr<UnixSocket> listener_;
+    std::list<std::shared_ptr<UnixSocket>> connections_;
+    bool stopping_;
+};
+
+
+
+#endif
+
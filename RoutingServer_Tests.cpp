@@ -0,0 +1,178 @@
+// RoutingServer_Tests.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// Unit tests for RoutingServer, answering requests in-process rather
+// than over a listening socket: directly through answerBatch(), and over
+// one end of a UnixSocket::pair() served on another thread.
+
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "RoutingServer.hpp"
+
+
+namespace
+{
+    RoadMap makeRoadMap()
+    {
+        RoadMap roadMap;
+        roadMap.addVertex(0, "Anteater Stadium");
+        roadMap.addVertex(1, "UCI Campus");
+        roadMap.addVertex(2, "Newport Beach");
+        roadMap.addEdge(0, 1, RoadSegment{2.0, 25.0});
+        roadMap.addEdge(1, 2, RoadSegment{3.5, 50.0});
+
+        return roadMap;
+    }
+
+
+    // readAnswers() reads answer lines from the given socket until there
+    // are at least the given number of them.
+    std::vector<std::string> readAnswers(UnixSocket& socket, std::size_t count)
+    {
+        std::vector<std::string> answers;
+
+        while (answers.size() < count && socket.readLines(answers))
+        {
+        }
+
+        return answers;
+    }
+}
+
+
+TEST(RoutingServer_Tests, answersBatchesInOrderWithErrorsInPlace)
+{
+    RoadMap roadMap = makeRoadMap();
+    RoutingServer server{roadMap, 2};
+
+    std::string answers = server.answerBatch(
+        {"0 2 D", "not a trip", "0 9 T", "\"Anteater Stadium\" \"UCI Campus\" T"}, 5);
+
+    std::vector<std::string> lines;
+    std::size_t start = 0;
+
+    for (std::size_t newline; (newline = answers.find('\n', start)) != std::string::npos; start = newline + 1)
+    {
+        lines.push_back(answers.substr(start, newline - start));
+    }
+
+    ASSERT_EQ(4, lines.size());
+    ASSERT_EQ(0, lines[0].find("{\"trip\":5,\"metric\":\"distance\",\"found\":true,\"vertices\":[0,1,2],"));
+    ASSERT_EQ(0, lines[1].find("{\"trip\":6,\"error\":\""));
+    ASSERT_EQ(0, lines[2].find("{\"trip\":7,\"error\":\""));
+    ASSERT_EQ(0, lines[3].find("{\"trip\":8,\"metric\":\"time\",\"found\":true,\"vertices\":[0,1],"));
+}
+
+
+TEST(RoutingServer_Tests, servesConnectionUntilPeerCloses)
+{
+    RoadMap roadMap = makeRoadMap();
+    RoutingServer server{roadMap, 2};
+
+    std::pair<UnixSocket, UnixSocket> ends = UnixSocket::pair();
+    std::thread serving{
+        [&server, connection = std::move(ends.second)]() mutable
+        {
+            server.serve(std::move(connection));
+        }};
+
+    {
+        UnixSocket client = std::move(ends.first);
+
+        // Requests sent together are answered together, and numbering
+        // carries on across batches.
+        client.writeAll("0 2 D\n0 1 T\n");
+        std::vector<std::string> answers = readAnswers(client, 2);
+        ASSERT_EQ(2, answers.size());
+        ASSERT_EQ(0, answers[0].find("{\"trip\":0,\"metric\":\"distance\",\"found\":true,"));
+        ASSERT_EQ(0, answers[1].find("{\"trip\":1,\"metric\":\"time\",\"found\":true,"));
+
+        client.writeAll("2 0 D\n");
+        answers = readAnswers(client, 1);
+        ASSERT_EQ(1, answers.size());
+        ASSERT_EQ(0, answers[0].find("{\"trip\":2,\"metric\":\"distance\",\"found\":false,"));
+    }
+
+    serving.join();
+}
+
+
+TEST(RoutingServer_Tests, dropsConnectionSendingTooLongALine)
+{
+    RoadMap roadMap = makeRoadMap();
+    RoutingServer server{roadMap, 1};
+
+    std::pair<UnixSocket, UnixSocket> ends = UnixSocket::pair();
+    UnixSocket client = std::move(ends.first);
+    std::thread serving{
+        [&server, connection = std::move(ends.second)]() mutable
+        {
+            server.serve(std::move(connection));
+        }};
+
+    // The server may hang up partway through, which fails the write.
+    try
+    {
+        for (std::size_t sent = 0; sent <= 2 * RoutingServer::maxRequestLength; sent += 4096)
+        {
+            client.writeAll(std::string(4096, '0'));
+        }
+    }
+    catch (const std::system_error&)
+    {
+    }
+
+    serving.join();
+
+    std::vector<std::string> answers;
+    bool closed;
+
+    try
+    {
+        closed = !client.readLines(answers);
+    }
+    catch (const std::system_error&)
+    {
+        closed = true;
+    }
+
+    ASSERT_TRUE(closed);
+    ASSERT_TRUE(answers.empty());
+}
+
+
+TEST(RoutingServer_Tests, answersListLegsOfMultiStopTrips)
+{
+    RoadMap roadMap = makeRoadMap();
+    RoutingServer server{roadMap, 1};
+
+    std::string answers = server.answerBatch({"0 1 2 D", "0 2 D"}, 0);
+    std::string first = answers.substr(0, answers.find('\n') + 1);
+    std::string second = answers.substr(first.size());
+
+    ASSERT_NE(std::string::npos, first.find(
+        ",\"legs\":[{\"from\":0,\"to\":1,\"miles\":2,\"hours\":0.08},"
+        "{\"from\":1,\"to\":2,\"miles\":3.5,\"hours\":0.07}]}\n"));
+    ASSERT_NE(std::string::npos, second.find(",\"legs\":[]}\n"));
+}
+
+
+TEST(RoutingServer_Tests, chargesTurnPenaltiesInAnswers)
+{
+    RoadMap roadMap = makeRoadMap();
+    TurnTable turns{{TurnRule{0, 1, 2, 0.5f}}};
+    RoutingServer server{roadMap, turns, 1};
+
+    std::string answer = server.answerBatch({"0 2 T"}, 0);
+
+    // The half hour turning at 1 is part of the hours of the segment that
+    // turns onto 2, so the hours still add up to the total.
+    ASSERT_NE(std::string::npos, answer.find("\"hours\":[0.08,0.57"));
+    ASSERT_NE(std::string::npos, answer.find("\"totalHours\":0.65,"));
+}
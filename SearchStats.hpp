@@ -0,0 +1,153 @@
+// SearchStats.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// The searches done by Digraph can optionally report how much work they
+// did, which helps explain why a particular query was slow.  Which kind
+// of reporting is wanted is chosen at compile time, by passing a search
+// statistics policy: NoSearchStats, whose member functions all do nothing
+// (so a search that uses it costs exactly what it would have otherwise),
+// or CountingSearchStats, which adds everything up in a SearchStats.
+// One CountingSearchStats can be passed to any number of searches, in
+// which case it totals them all.
+
+#ifndef SEARCHSTATS_HPP
+#define SEARCHSTATS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+
+
+
+struct SearchStats
+{
+    // The number of searches that these statistics total up.
+    std::size_t queries = 0;
+
+    std::size_t verticesSettled = 0;
+    std::size_t edgesRelaxed = 0;
+
+    // Every vertex pushed onto the priority queue is eventually popped
+    // unless the search stops early; pops of entries that had already
+    // been superseded by a better label are counted as stale.
+    std::size_t queuePushes = 0;
+    std::size_t queuePops = 0;
+    std::size_t stalePops = 0;
+
+    // The largest the priority queue got during any one of the searches.
+    std::size_t peakQueueSize = 0;
+
+    double wallSeconds = 0.0;
+
+    SearchStats& operator+=(const SearchStats& other) noexcept;
+};
+
+
+
+class NoSearchStats
+{
+public:
+    void searchStarted() noexcept { }
+    void queuePushed(std::size_t) noexcept { }
+    void queuePopped(bool) noexcept { }
+    void vertexSettled() noexcept { }
+    void edgeRelaxed() noexcept { }
+    void searchFinished() noexcept { }
+};
+
+
+
+class CountingSearchStats
+{
+public:
+    // searchStarted() and searchFinished() bracket each search; the time
+    // between them is added to wallSeconds.
+    void searchStarted() noexcept;
+
+    // queuePushed() is given the size of the queue after the push.
+    void queuePushed(std::size_t queueSize) noexcept;
+
+    void queuePopped(bool stale) noexcept;
+    void vertexSettled() noexcept;
+    void edgeRelaxed() noexcept;
+    void searchFinished() noexcept;
+
+    const SearchStats& stats() const noexcept;
+
+private:
+    SearchStats stats_;
+    std::chrono::steady_clock::time_point started_;
+};
+
+
+
+inline SearchStats& SearchStats::operator+=(const SearchStats& other) noexcept
+{
+    queries += other.queries;
+    verticesSettled += other.verticesSettled;
+    edgesRelaxed += other.edgesRelaxed;
+    queuePushes += other.queuePushes;
+    queuePops += other.queuePops;
+    stalePops += other.stalePops;
+    peakQueueSize = std::max(peakQueueSize, other.peakQueueSize);
+    wallSeconds += other.wallSeconds;
+
+    return *this;
+}
+
+
+inline void CountingSearchStats::searchStarted() noexcept
+{
+    stats_.queries++;
+    started_ = std::chrono::steady_clock::now();
+}
+
+
+inline void CountingSearchStats::queuePushed(std::size_t queueSize) noexcept
+{
+    stats_.queuePushes++;
+    stats_.peakQueueSize = std::max(stats_.peakQueueSize, queueSize);
+}
+
+
+inline void CountingSearchStats::queuePopped(bool stale) noexcept
+{
+    stats_.queuePops++;
+
+    if (stale)
+    {
+        stats_.stalePops++;
+    }
+}
+
+
+inline void CountingSearchStats::vertexSettled() noexcept
+{
+    stats_.verticesSettled++;
+}
+
+
+inline void CountingSearchStats::edgeRelaxed() noexcept
+{
+    stats_.edgesRelaxed++;
+}
+
+
+inline void CountingSearchStats::searchFinished() noexcept
+{
+    stats_.wallSeconds += std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - started_).count();
+}
+
+
+inline const SearchStats& CountingSearchStats::stats() const noexcept
+{
+    return stats_;
+}
+
+
+
+#endif
+
@@ -0,0 +1,207 @@
+// ShardWorker.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <charconv>
+#include <exception>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "ShardWorker.hpp"
+#include "TripPlanner.hpp"
+
+
+namespace
+{
+    void appendNumber(std::string& line, double value)
+    {
+        char digits[32];
+        std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+
+        line.append(digits, result.ptr);
+    }
+
+
+    TripMetric parseMetric(const std::string& field)
+    {
+        if (field == "D")
+        {
+            return TripMetric::Distance;
+        }
+        else if (field == "T")
+        {
+            return TripMetric::Time;
+        }
+
+        throw std::invalid_argument{"Not a metric: " + field};
+    }
+
+
+    double costOf(const Route& route, TripMetric metric)
+    {
+        if (route.vertices.empty())
+        {
+            return std::numeric_limits<double>::infinity();
+        }
+
+        return metric == TripMetric::Time ? route.hours : route.miles;
+    }
+}
+
+
+ShardWorker::ShardWorker(RoadMap shard)
+    : shard_{std::move(shard)}
+{
+    for (int vertex : shard_.vertices())
+    {
+        reversed_.addVertex(vertex, shard_.vertexInfo(vertex));
+    }
+
+    for (const std::pair<int, int>& edge : shard_.edges())
+    {
+        reversed_.addEdge(edge.second, edge.first, shard_.edgeInfo(edge.first, edge.second));
+    }
+}
+
+
+std::string ShardWorker::answer(const std::string& request) const
+{
+    try
+    {
+        std::istringstream in{request};
+        std::string operation;
+        std::string metricField;
+        int vertex;
+
+        if (!(in >> operation))
+        {
+            throw std::invalid_argument{"Malformed request: " + request};
+        }
+
+        if (operation == "name" || operation == "segment")
+        {
+            return describe(operation, in, request);
+        }
+
+        if (!(in >> metricField >> vertex))
+        {
+            throw std::invalid_argument{"Malformed request: " + request};
+        }
+
+        TripMetric metric = parseMetric(metricField);
+        std::vector<int> others;
+        int other;
+
+        while (in >> other)
+        {
+            others.push_back(other);
+        }
+
+        if (!in.eof())
+        {
+            throw std::invalid_argument{"Malformed request: " + request};
+        }
+
+        std::string reply;
+
+        if (operation == "from" || operation == "to")
+        {
+            // Searching backward from a target over the reversed shard finds
+            // the cost to it from every source at once.
+            const RoadMap& roadMap = operation == "from" ? shard_ : reversed_;
+            std::map<int, int> predecessors = roadMap.findShortestPaths(
+                vertex, others, TripPlanner::edgeWeightFor(metric));
+
+            for (int target : others)
+            {
+                if (!reply.empty())
+                {
+                    reply += ' ';
+                }
+
+                appendNumber(reply, costOf(TripPlanner::routeFor(roadMap, predecessors, vertex, target), metric));
+            }
+        }
+        else if (operation == "path" && others.size() == 1)
+        {
+            std::map<int, int> predecessors = shard_.findShortestPaths(
+                vertex, others, TripPlanner::edgeWeightFor(metric));
+
+            Route route = TripPlanner::routeFor(shard_, predecessors, vertex, others[0]);
+
+            if (route.vertices.empty())
+            {
+                return "none";
+            }
+
+            appendNumber(reply, route.miles);
+            reply += ' ';
+            appendNumber(reply, route.hours);
+
+            for (int v : route.vertices)
+            {
+                reply += ' ';
+                reply += std::to_string(v);
+            }
+        }
+        else
+        {
+            throw std::invalid_argument{"Malformed request: " + request};
+        }
+
+        return reply;
+    }
+    catch (const std::exception& e)
+    {
+        return std::string{"error "} + e.what();
+    }
+}
+
+
+std::string ShardWorker::describe(const std::string& operation, std::istream& in, const std::string& request) const
+{
+    int from;
+    int to = 0;
+
+    if (!(in >> from) || (operation == "segment" && !(in >> to)) || !(in >> std::ws).eof())
+    {
+        throw std::invalid_argument{"Malformed request: " + request};
+    }
+
+    if (operation == "name")
+    {
+        return "=" + std::string{shard_.vertexInfo(from)};
+    }
+
+    RoadSegment segment = shard_.edgeInfo(from, to);
+
+    std::string reply;
+    appendNumber(reply, segment.miles);
+    reply += ' ';
+    appendNumber(reply, segment.milesPerHour);
+
+    return reply;
+}
+
+
+void ShardWorker::serve(UnixSocket& socket) const
+{
+    std::vector<std::string> requests;
+
+    while (socket.readLines(requests))
+    {
+        std::string replies;
+
+        for (const std::string& request : requests)
+        {
+            replies += answer(request);
+            replies += '\n';
+        }
+
+        socket.writeAll(replies);
+        requests.clear();
+    }
+}
+
@@ -0,0 +1,66 @@
+// ShardWorker.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A ShardWorker answers searches within one shard of a RoadMapPartition,
+// on behalf of a ShardedRouter that is usually in another process.  It
+// only ever sees its own shard's RoadMap, so it knows nothing about the
+// rest of the map; the ShardedRouter stitches the answers of the shards
+// together.
+//
+// Requests and replies are single lines of space-separated fields.  The
+// metric is "D" (distance, in miles) or "T" (driving time, in hours),
+// and costs that are infinite (because there's no route within the
+// shard) are written as "inf".
+//
+//     from METRIC SOURCE V1 V2 ...    the cost from SOURCE to each Vi
+//     to METRIC TARGET V1 V2 ...      the cost from each Vi to TARGET
+//     path METRIC FROM TO             MILES HOURS FROM ... TO, or "none"
+//     name V                          "=" followed by V's location name
+//     segment FROM TO                 MILES MPH of the road segment
+//
+// (The '=' keeps a location name from being mistaken for an error.)
+//
+// A request that can't be answered gets the reply "error" followed by a
+// description of the problem.
+
+#ifndef SHARDWORKER_HPP
+#define SHARDWORKER_HPP
+
+#include <istream>
+#include <string>
+#include "RoadMap.hpp"
+#include "UnixSocket.hpp"
+
+
+
+class ShardWorker
+{
+public:
+    // Initializes a ShardWorker that searches the given shard.
+    explicit ShardWorker(RoadMap shard);
+
+    // answer() returns the reply to one request, without a newline.
+    std::string answer(const std::string& request) const;
+
+    // serve() answers requests arriving on the given UnixSocket until the
+    // other end closes it.
+    void serve(UnixSocket& socket) const;
+
+private:
+    // describe() answers a name or segment request, whose operation has
+    // already been read from the given stream.
+    std::string describe(const std::string& operation, std::istream& in, const std::string& request) const;
+
+    RoadMap shard_;
+
+    // The shard with every road segment turned around, so that searches
+    // from a target backward to many sources are ordinary searches.
+    RoadMap reversed_;
+};
+
+
+
+#endif
+
@@ -0,0 +1,587 @@
+// ShardedRouter.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "ShardedRouter.hpp"
+
+
+namespace
+{
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+
+    // The most requests sent to a shard before its replies are read.
+    constexpr std::size_t requestsPerBatch = 256;
+
+
+    const char* metricField(TripMetric metric)
+    {
+        return metric == TripMetric::Time ? "T" : "D";
+    }
+
+
+    // request() returns a request line for the given operation, metric,
+    // vertex, and list of other vertices.
+    std::string request(
+        const std::string& operation, TripMetric metric, int vertex, const std::vector<int>& others)
+    {
+        std::string line = operation + ' ' + metricField(metric) + ' ' + std::to_string(vertex);
+
+        for (int other : others)
+        {
+            line += ' ';
+            line += std::to_string(other);
+        }
+
+        return line;
+    }
+
+
+    double segmentCost(const RoadSegment& segment, TripMetric metric)
+    {
+        return metric == TripMetric::Time ? segment.miles / segment.milesPerHour : segment.miles;
+    }
+}
+
+
+ShardedRouter::ShardedRouter(RoadMapPartition partition, std::vector<UnixSocket> shards)
+    : partition_{std::move(partition)}, shards_{std::move(shards)}, replies_(shards_.size())
+{
+    const int shardCount = partition_.shardCount();
+
+    if (static_cast<int>(shards_.size()) != shardCount)
+    {
+        throw std::invalid_argument{"There must be one connection per shard"};
+    }
+
+    for (int shard = 0; shard < shardCount; ++shard)
+    {
+        for (int vertex : partition_.boundaryVertices(shard))
+        {
+            overlayIndexes_.emplace(vertex, static_cast<int>(overlayVertices_.size()));
+            overlayVertices_.push_back(vertex);
+        }
+    }
+
+    const std::size_t n = overlayVertices_.size();
+
+    for (std::vector<std::vector<OverlayArc>>& arcs : arcs_)
+    {
+        arcs.resize(n);
+    }
+
+    for (const auto& cut : partition_.cutEdges())
+    {
+        int from = overlayIndexes_.at(cut.first.first);
+        int to = overlayIndexes_.at(cut.first.second);
+
+        for (TripMetric metric : {TripMetric::Distance, TripMetric::Time})
+        {
+            arcs_[static_cast<int>(metric)][from].push_back(
+                OverlayArc{to, segmentCost(cut.second, metric), -1});
+        }
+    }
+
+    // Each shard is asked for the costs between its own boundary vertices
+    // on a thread of its own, so that the shards all work at once.
+    std::vector<std::exception_ptr> failures(shardCount);
+    std::vector<std::thread> threads;
+
+    for (int shard = 0; shard < shardCount; ++shard)
+    {
+        threads.emplace_back(
+            [this, shard, &failures]()
+            {
+                try
+                {
+                    const std::vector<int>& boundary = partition_.boundaryVertices(shard);
+
+                    for (TripMetric metric : {TripMetric::Distance, TripMetric::Time})
+                    {
+                        for (int from : boundary)
+                        {
+                            send(shard, request("from", metric, from, boundary));
+                            std::vector<double> costs = receiveCosts(shard);
+
+                            std::vector<OverlayArc>& arcs =
+                                arcs_[static_cast<int>(metric)][overlayIndexes_.at(from)];
+
+                            for (std::size_t i = 0; i < boundary.size(); ++i)
+                            {
+                                if (boundary[i] != from && costs.at(i) < infinity)
+                                {
+                                    arcs.push_back(OverlayArc{overlayIndexes_.at(boundary[i]), costs[i], shard});
+                                }
+                            }
+                        }
+                    }
+                }
+                catch (...)
+                {
+                    failures[shard] = std::current_exception();
+                }
+            });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    for (std::exception_ptr& failure : failures)
+    {
+        if (failure)
+        {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    distances_.assign(n, infinity);
+    exitCosts_.assign(n, infinity);
+    parents_.assign(n, {-1, -1});
+}
+
+
+Route ShardedRouter::route(const Trip& trip)
+{
+    std::vector<int> points{trip.startVertex};
+    points.insert(points.end(), trip.stops.begin(), trip.stops.end());
+    points.push_back(trip.endVertex);
+
+    for (int point : points)
+    {
+        partition_.shardOf(point);
+    }
+
+    if (trip.stops.empty())
+    {
+        return routeLeg(trip.startVertex, trip.endVertex, trip.metric);
+    }
+
+    Route route{{trip.startVertex}, 0.0, 0.0};
+
+    for (std::size_t i = 1; i < points.size(); ++i)
+    {
+        Route leg = routeLeg(points[i - 1], points[i], trip.metric);
+
+        if (leg.vertices.empty())
+        {
+            return Route{{}, 0.0, 0.0};
+        }
+
+        route.vertices.insert(route.vertices.end(), leg.vertices.begin() + 1, leg.vertices.end());
+        route.miles += leg.miles;
+        route.hours += leg.hours;
+        route.legs.push_back(std::move(leg));
+    }
+
+    return route;
+}
+
+
+RoadMap ShardedRouter::routeMapFor(const std::vector<Trip>& trips, const std::vector<Route>& routes)
+{
+    std::set<int> vertices;
+    std::set<std::pair<int, int>> segments;
+
+    for (const Trip& trip : trips)
+    {
+        vertices.insert(trip.startVertex);
+        vertices.insert(trip.stops.begin(), trip.stops.end());
+        vertices.insert(trip.endVertex);
+    }
+
+    for (const Route& route : routes)
+    {
+        for (std::size_t i = 0; i < route.vertices.size(); ++i)
+        {
+            vertices.insert(route.vertices[i]);
+
+            if (i > 0)
+            {
+                segments.emplace(route.vertices[i - 1], route.vertices[i]);
+            }
+        }
+    }
+
+    RoadMap roadMap;
+    std::vector<std::vector<std::string>> requests(partition_.shardCount());
+    std::vector<std::vector<int>> named(partition_.shardCount());
+
+    for (int vertex : vertices)
+    {
+        int shard = partition_.shardOf(vertex);
+
+        requests[shard].push_back("name " + std::to_string(vertex));
+        named[shard].push_back(vertex);
+    }
+
+    askInBatches(
+        requests,
+        [&](int shard, std::size_t i, const std::string& reply)
+        {
+            if (reply.empty() || reply[0] != '=')
+            {
+                throw std::runtime_error{"Shard " + std::to_string(shard) + " sent no name: " + reply};
+            }
+
+            roadMap.addVertex(named[shard][i], reply.substr(1));
+        });
+
+    // Cut edges are already known here; the rest lie within one shard.
+    std::vector<std::vector<std::pair<int, int>>> measured(partition_.shardCount());
+
+    for (std::vector<std::string>& shardRequests : requests)
+    {
+        shardRequests.clear();
+    }
+
+    for (const std::pair<int, int>& segment : segments)
+    {
+        auto cut = partition_.cutEdges().find(segment);
+
+        if (cut != partition_.cutEdges().end())
+        {
+            roadMap.addEdge(segment.first, segment.second, RoadSegment{cut->second.miles, cut->second.milesPerHour});
+            continue;
+        }
+
+        int shard = partition_.shardOf(segment.first);
+
+        requests[shard].push_back(
+            "segment " + std::to_string(segment.first) + ' ' + std::to_string(segment.second));
+        measured[shard].push_back(segment);
+    }
+
+    askInBatches(
+        requests,
+        [&](int shard, std::size_t i, const std::string& reply)
+        {
+            std::istringstream in{reply};
+            std::string miles;
+            std::string milesPerHour;
+
+            in >> miles >> milesPerHour;
+
+            const std::pair<int, int>& segment = measured[shard][i];
+            roadMap.addEdge(segment.first, segment.second, RoadSegment{std::stod(miles), std::stod(milesPerHour)});
+        });
+
+    return roadMap;
+}
+
+
+int ShardedRouter::overlayVertexCount() const noexcept
+{
+    return static_cast<int>(overlayVertices_.size());
+}
+
+
+std::size_t ShardedRouter::overlayEdgeCount() const noexcept
+{
+    std::size_t count = 0;
+
+    for (const std::vector<std::vector<OverlayArc>>& arcs : arcs_)
+    {
+        for (const std::vector<OverlayArc>& outgoing : arcs)
+        {
+            count += outgoing.size();
+        }
+    }
+
+    return count;
+}
+
+
+Route ShardedRouter::routeLeg(int fromVertex, int toVertex, TripMetric metric)
+{
+    const int fromShard = partition_.shardOf(fromVertex);
+    const int toShard = partition_.shardOf(toVertex);
+    const std::vector<int>& entries = partition_.boundaryVertices(fromShard);
+    const std::vector<int>& exits = partition_.boundaryVertices(toShard);
+
+    // The end vertex is added to the start shard's request when they're
+    // in the same shard, for the route that never leaves it.
+    std::vector<int> targets = entries;
+
+    if (fromShard == toShard)
+    {
+        targets.push_back(toVertex);
+    }
+
+    send(fromShard, request("from", metric, fromVertex, targets));
+    send(toShard, request("to", metric, toVertex, exits));
+
+    std::vector<double> entryCosts = receiveCosts(fromShard);
+    std::vector<double> exitCosts = receiveCosts(toShard);
+
+    double best = fromShard == toShard ? entryCosts.back() : infinity;
+    int bestExit = -1;
+
+    // The overlay search starts from all of the start shard's boundary
+    // vertices at once, each at the cost of reaching it, and stops once
+    // nothing left in the queue could lead to a better route.
+    using Entry = std::pair<double, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> pq;
+
+    auto reach = [&](int index, double distance, std::pair<int, int> parent)
+    {
+        if (distance < distances_[index])
+        {
+            if (distances_[index] == infinity && exitCosts_[index] == infinity)
+            {
+                touched_.push_back(index);
+            }
+
+            distances_[index] = distance;
+            parents_[index] = parent;
+            pq.push({distance, index});
+        }
+    };
+
+    for (std::size_t i = 0; i < exits.size(); ++i)
+    {
+        int index = overlayIndexes_.at(exits[i]);
+
+        if (distances_[index] == infinity && exitCosts_[index] == infinity)
+        {
+            touched_.push_back(index);
+        }
+
+        exitCosts_[index] = exitCosts.at(i);
+    }
+
+    for (std::size_t i = 0; i < entries.size(); ++i)
+    {
+        reach(overlayIndexes_.at(entries[i]), entryCosts.at(i), {-1, -1});
+    }
+
+    const std::vector<std::vector<OverlayArc>>& arcs = arcs_[static_cast<int>(metric)];
+
+    while (!pq.empty())
+    {
+        Entry top = pq.top();
+        pq.pop();
+
+        if (top.first >= best)
+        {
+            break;
+        }
+
+        if (top.first > distances_[top.second])
+        {
+            continue;
+        }
+
+        if (top.first + exitCosts_[top.second] < best)
+        {
+            best = top.first + exitCosts_[top.second];
+            bestExit = top.second;
+        }
+
+        for (const OverlayArc& arc : arcs[top.second])
+        {
+            reach(arc.to, top.first + arc.cost, {top.second, arc.shard});
+        }
+    }
+
+    // The overlay path is followed back from the best exit before the
+    // scratch space is reset.
+    std::vector<std::pair<int, int>> path;
+
+    for (int index = bestExit; index >= 0; index = parents_[index].first)
+    {
+        path.emplace_back(index, parents_[index].second);
+    }
+
+    for (int index : touched_)
+    {
+        distances_[index] = infinity;
+        exitCosts_[index] = infinity;
+        parents_[index] = {-1, -1};
+    }
+
+    touched_.clear();
+
+    if (best == infinity)
+    {
+        return Route{{}, 0.0, 0.0};
+    }
+
+    Route route{{fromVertex}, 0.0, 0.0};
+
+    if (bestExit < 0)
+    {
+        send(fromShard, request("path", metric, fromVertex, {toVertex}));
+        receivePath(fromShard, route);
+        return route;
+    }
+
+    // Once reversed, the path runs from the entry to the exit, each entry
+    // after the first recording the shard of the overlay edge arriving at
+    // it.  All of the path requests are sent before any reply is read, so
+    // the shards expand their pieces of the route at the same time.
+    std::reverse(path.begin(), path.end());
+
+    // Each piece is the shard that expands it (or -1 for a cut edge)
+    // and the vertex it ends at.
+    std::vector<std::pair<int, int>> pieces;
+    int previous = fromVertex;
+
+    auto expand = [&](int shard, int vertex)
+    {
+        if (shard >= 0)
+        {
+            send(shard, request("path", metric, previous, {vertex}));
+        }
+
+        pieces.emplace_back(shard, vertex);
+        previous = vertex;
+    };
+
+    expand(fromShard, overlayVertices_[path.front().first]);
+
+    for (std::size_t i = 1; i < path.size(); ++i)
+    {
+        expand(path[i].second, overlayVertices_[path[i].first]);
+    }
+
+    expand(toShard, toVertex);
+
+    for (const std::pair<int, int>& piece : pieces)
+    {
+        if (piece.first >= 0)
+        {
+            receivePath(piece.first, route);
+        }
+        else
+        {
+            const RoadSegment& segment = partition_.cutEdges().at({route.vertices.back(), piece.second});
+
+            route.vertices.push_back(piece.second);
+            route.miles += segment.miles;
+            route.hours += segment.miles / segment.milesPerHour;
+        }
+    }
+
+    return route;
+}
+
+
+void ShardedRouter::send(int shard, const std::string& request)
+{
+    shards_[shard].writeAll(request + '\n');
+}
+
+
+std::string ShardedRouter::receive(int shard)
+{
+    std::deque<std::string>& replies = replies_[shard];
+
+    while (replies.empty())
+    {
+        std::vector<std::string> lines;
+
+        if (!shards_[shard].readLines(lines))
+        {
+            throw std::runtime_error{"Shard " + std::to_string(shard) + " closed its connection"};
+        }
+
+        replies.insert(replies.end(), lines.begin(), lines.end());
+    }
+
+    std::string reply = std::move(replies.front());
+    replies.pop_front();
+
+    if (reply.compare(0, 6, "error ") == 0)
+    {
+        throw std::runtime_error{"Shard " + std::to_string(shard) + ": " + reply.substr(6)};
+    }
+
+    return reply;
+}
+
+
+std::vector<double> ShardedRouter::receiveCosts(int shard)
+{
+    std::istringstream in{receive(shard)};
+    std::vector<double> costs;
+    std::string field;
+
+    while (in >> field)
+    {
+        costs.push_back(std::stod(field));
+    }
+
+    return costs;
+}
+
+
+void ShardedRouter::receivePath(int shard, Route& route)
+{
+    std::string reply = receive(shard);
+
+    if (reply == "none")
+    {
+        throw std::runtime_error{"Shard " + std::to_string(shard) + " lost a route it reported"};
+    }
+
+    std::istringstream in{reply};
+    std::string miles;
+    std::string hours;
+    int vertex;
+
+    in >> miles >> hours >> vertex;
+
+    route.miles += std::stod(miles);
+    route.hours += std::stod(hours);
+
+    while (in >> vertex)
+    {
+        route.vertices.push_back(vertex);
+    }
+}
+
+
+
+void ShardedRouter::askInBatches(
+    const std::vector<std::vector<std::string>>& requests,
+    const std::function<void(int, std::size_t, const std::string&)>& replyFunc)
+{
+    std::size_t longest = 0;
+
+    for (const std::vector<std::string>& shardRequests : requests)
+    {
+        longest = std::max(longest, shardRequests.size());
+    }
+
+    // Every shard gets its batch before any replies are read, so that the
+    // shards all work at once.
+    for (std::size_t first = 0; first < longest; first += requestsPerBatch)
+    {
+        for (int shard = 0; shard < static_cast<int>(requests.size()); ++shard)
+        {
+            for (std::size_t i = first; i < requests[shard].size() && i < first + requestsPerBatch; ++i)
+            {
+                send(shard, requests[shard][i]);
+            }
+        }
+
+        for (int shard = 0; shard < static_cast<int>(requests.size()); ++shard)
+        {
+            for (std::size_t i = first; i < requests[shard].size() && i < first + requestsPerBatch; ++i)
+            {
+                replyFunc(shard, i, receive(shard));
+            }
+        }
+    }
+}
@@ -0,0 +1,133 @@
+// ShardedRouter.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A ShardedRouter answers trips over a RoadMap that has been split by a
+// RoadMapPartition, with each shard searched by its own ShardWorker
+// (normally in a separate process, connected by a UnixSocket).  The
+// router itself never holds the RoadMap; it keeps only the partition and
+// an overlay graph on the partition's boundary vertices.
+//
+// The overlay has two kinds of edges: the cut edges themselves, and, for
+// every pair of boundary vertices in the same shard, an edge whose cost
+// is the shortest route between them within that shard.  The latter are
+// computed when the router starts, by asking each shard.  A trip is then
+// answered by asking the start vertex's shard for the cost to each of its
+// boundary vertices, asking the end vertex's shard for the cost from each
+// of its boundary vertices, and searching the overlay in between.  Every
+// route that leaves the start vertex's shard does so through one of its
+// boundary vertices, so the best of those, or of the route that stays
+// within a single shard, is the shortest route in the whole map.  The
+// overlay edges of the chosen route are finally expanded into road
+// segments by asking the shards they lie in.
+//
+// Writing routes takes the names of their locations and the details of
+// their road segments, which only the shards have; routeMapFor() asks
+// them for just the parts of the map that a set of routes uses.
+//
+// A trip's intermediate stops are visited in the order given, even if
+// the trip allows them to be reordered, and driving times always use the
+// road segments' own speeds, ignoring any departure time.
+//
+// A ShardedRouter may only be used by one thread at a time.
+
+#ifndef SHARDEDROUTER_HPP
+#define SHARDEDROUTER_HPP
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "RoadMapPartition.hpp"
+#include "Route.hpp"
+#include "Trip.hpp"
+#include "UnixSocket.hpp"
+
+
+
+class ShardedRouter
+{
+public:
+    // Initializes a ShardedRouter over the given partition, taking over
+    // one UnixSocket per shard, in shard order, each connected to a
+    // ShardWorker searching that shard.  The overlay is built before the
+    // constructor returns.  If a shard reports an error, a
+    // std::runtime_error is thrown.
+    ShardedRouter(RoadMapPartition partition, std::vector<UnixSocket> shards);
+
+    // route() returns the Route for the given trip.  If one of its
+    // vertices doesn't exist, a DigraphException is thrown instead.
+    Route route(const Trip& trip);
+
+    // routeMapFor() returns a RoadMap holding only the locations and road
+    // segments that the given trips and their routes (as returned by
+    // route()) refer to, named and measured as they are in the shards, so
+    // that a RouteWriter can write the routes without the whole map.
+    // Like route(), it ignores speed profiles.  If a shard reports an
+    // error, a std::runtime_error is thrown.
+    RoadMap routeMapFor(const std::vector<Trip>& trips, const std::vector<Route>& routes);
+
+    // overlayVertexCount() and overlayEdgeCount() return the size of the
+    // overlay graph (whose edges are counted separately for each metric).
+    int overlayVertexCount() const noexcept;
+    std::size_t overlayEdgeCount() const noexcept;
+
+private:
+    // An OverlayArc leads to the overlay vertex with the given index.  Its
+    // shard is the one whose ShardWorker can expand it into road segments,
+    // or -1 for a cut edge.
+    struct OverlayArc
+    {
+        int to;
+        double cost;
+        int shard;
+    };
+
+    // routeLeg() returns the shortest Route between two vertices.
+    Route routeLeg(int fromVertex, int toVertex, TripMetric metric);
+
+    // send() and receive() pass one request to the given shard and take
+    // back its replies in the order the requests were sent.
+    void send(int shard, const std::string& request);
+    std::string receive(int shard);
+
+    // receiveCosts() takes back a reply listing costs.
+    std::vector<double> receiveCosts(int shard);
+
+    // receivePath() takes back a reply to a path request, appending its
+    // road segments to the given Route.
+    void receivePath(int shard, Route& route);
+
+    // askInBatches() sends each shard its list of requests, a batch at a
+    // time so that neither side's socket fills up, calling the given
+    // function with each reply and the shard and position of its request.
+    void askInBatches(
+        const std::vector<std::vector<std::string>>& requests,
+        const std::function<void(int, std::size_t, const std::string&)>& replyFunc);
+
+    RoadMapPartition partition_;
+    std::vector<UnixSocket> shards_;
+    std::vector<std::deque<std::string>> replies_;
+
+    std::vector<int> overlayVertices_;
+    std::map<int, int> overlayIndexes_;
+
+    // One set of overlay edges for each metric, indexed by TripMetric.
+    std::vector<std::vector<OverlayArc>> arcs_[2];
+
+    // Scratch space for the overlay search, kept between trips so that
+    // only the entries a search touched need to be reset.
+    std::vector<double> distances_;
+    std::vector<double> exitCosts_;
+    std::vector<std::pair<int, int>> parents_;
+    std::vector<int> touched_;
+};
+
+
+
+#endif
+
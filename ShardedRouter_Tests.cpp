@@ -0,0 +1,205 @@
+// ShardedRouter_Tests.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// Unit tests for ShardedRouter, running each shard's ShardWorker on a
+// thread of its own, connected by UnixSocket pairs, and comparing the
+// routes against a TripPlanner working on the whole map, and the way
+// they're written against the way they'd be written with it.
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+#include "RoadMapPartition.hpp"
+#include "RoadMapReader.hpp"
+#include "RoadMapWriter.hpp"
+#include "RouteWriter.hpp"
+#include "ShardWorker.hpp"
+#include "ShardedRouter.hpp"
+#include "TripPlanner.hpp"
+
+
+namespace
+{
+    // A two-way ring whose roads get faster and longer going around it,
+    // plus a one-way chord straight across.
+    RoadMap makeRing()
+    {
+        RoadMap roadMap;
+
+        for (int i = 0; i < 8; ++i)
+        {
+            roadMap.addVertex(i, "Location " + std::to_string(i));
+        }
+
+        for (int i = 0; i < 8; ++i)
+        {
+            roadMap.addEdge(i, (i + 1) % 8, RoadSegment{1.0 + i, 20.0 + 10.0 * i});
+            roadMap.addEdge((i + 1) % 8, i, RoadSegment{1.0 + i, 20.0 + 10.0 * i});
+        }
+
+        roadMap.addEdge(1, 5, RoadSegment{4.0, 15.0});
+
+        return roadMap;
+    }
+
+
+    // startWorkers() starts a ShardWorker thread for each of the given
+    // shards, returning the router's end of each one's connection.
+    std::vector<UnixSocket> startWorkers(std::vector<RoadMap> shards, std::vector<std::thread>& workers)
+    {
+        std::vector<UnixSocket> sockets;
+
+        for (RoadMap& shard : shards)
+        {
+            std::pair<UnixSocket, UnixSocket> ends = UnixSocket::pair();
+            sockets.push_back(std::move(ends.first));
+
+            workers.emplace_back(
+                [worker = ShardWorker{std::move(shard)}, socket = std::move(ends.second)]() mutable
+                {
+                    worker.serve(socket);
+                });
+        }
+
+        return sockets;
+    }
+}
+
+
+TEST(ShardedRouter_Tests, matchesPlannerAcrossShards)
+{
+    RoadMap roadMap = makeRing();
+
+    RoadMapPartition partition{roadMap, 3};
+    ASSERT_FALSE(partition.cutEdges().empty());
+
+    std::vector<RoadMap> shards;
+
+    for (int shard = 0; shard < partition.shardCount(); ++shard)
+    {
+        shards.push_back(partition.shardRoadMap(roadMap, shard));
+    }
+
+    std::vector<std::thread> workers;
+    std::vector<UnixSocket> sockets = startWorkers(std::move(shards), workers);
+
+    {
+        ShardedRouter router{partition, std::move(sockets)};
+        std::vector<Trip> trips;
+
+        for (int from = 0; from < 8; ++from)
+        {
+            for (int to = 0; to < 8; ++to)
+            {
+                trips.push_back(Trip{from, to, TripMetric::Distance});
+                trips.push_back(Trip{from, to, TripMetric::Time});
+            }
+        }
+
+        std::vector<Route> expected = TripPlanner{}.planTrips(roadMap, trips);
+
+        for (std::size_t i = 0; i < trips.size(); ++i)
+        {
+            // Routes tied on the trip's metric may differ on the other one,
+            // so only the metric being minimized is compared.
+            Route route = router.route(trips[i]);
+
+            EXPECT_EQ(expected[i].vertices.front(), route.vertices.front());
+            EXPECT_EQ(expected[i].vertices.back(), route.vertices.back());
+
+            if (trips[i].metric == TripMetric::Distance)
+            {
+                EXPECT_DOUBLE_EQ(expected[i].miles, route.miles);
+            }
+            else
+            {
+                EXPECT_DOUBLE_EQ(expected[i].hours, route.hours);
+            }
+        }
+
+        EXPECT_THROW(router.route(Trip{0, 9, TripMetric::Distance}), DigraphException);
+    }
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+
+TEST(ShardedRouter_Tests, writesRoutesFromWrittenShardsAlone)
+{
+    RoadMap roadMap = makeRing();
+
+    // Everything the router and its workers know is written out and read
+    // back, as shardmain does with its files.
+    RoadMapPartition original{roadMap, 3};
+    std::stringstream partitionText;
+    original.write(partitionText);
+
+    InputReader partitionIn{partitionText};
+    RoadMapPartition partition = RoadMapPartition::read(partitionIn);
+
+    std::vector<RoadMap> shards;
+
+    for (int shard = 0; shard < original.shardCount(); ++shard)
+    {
+        std::stringstream shardText;
+        RoadMapWriter{}.writeNumberedRoadMap(shardText, original.shardRoadMap(roadMap, shard));
+
+        InputReader shardIn{shardText};
+        shards.push_back(RoadMapReader{}.readNumberedRoadMap(shardIn));
+    }
+
+    std::vector<std::thread> workers;
+    std::vector<UnixSocket> sockets = startWorkers(std::move(shards), workers);
+
+    {
+        ShardedRouter router{partition, std::move(sockets)};
+
+        std::vector<Trip> trips{
+            {0, 5, TripMetric::Time},
+            {3, 3, TripMetric::Distance},
+            {6, 2, TripMetric::Distance}};
+
+        trips[2].stops = {1, 1};
+
+        std::vector<Route> routes;
+
+        for (const Trip& trip : trips)
+        {
+            routes.push_back(router.route(trip));
+        }
+
+        RoadMap routeMap = router.routeMapFor(trips, routes);
+        ASSERT_GT(roadMap.vertexCount(), routeMap.vertexCount());
+
+        // The same routes come out the same whether they're written with
+        // the whole map or with only the parts the shards sent back.
+        std::ostringstream expected;
+        std::ostringstream actual;
+
+        {
+            RouteWriter wholeMapWriter{expected};
+            RouteWriter routeMapWriter{actual};
+
+            for (std::size_t i = 0; i < trips.size(); ++i)
+            {
+                wholeMapWriter.writeRoute(roadMap, trips[i], routes[i]);
+                routeMapWriter.writeRoute(routeMap, trips[i], routes[i]);
+            }
+        }
+
+        ASSERT_EQ(expected.str(), actual.str());
+    }
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
@@ -0,0 +1,339 @@
+// ShortestPathTree.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A ShortestPathTree is a long-lived answer to findShortestPaths(): the
+// distance to, and predecessor of, every vertex reachable from one start
+// vertex.  Unlike the std::map returned by findShortestPaths(), it can be
+// kept up to date as traffic changes.  After the EdgeInfo of some edges
+// has been changed with Digraph::updateEdge(), repair() fixes the tree in
+// place, doing work proportional to the part of the tree whose distances
+// actually change rather than searching the whole graph again.
+//
+// The tree keeps a reference to its Digraph, so the Digraph must outlive
+// it.  repair() only understands changes to edge weights; if vertices or
+// edges are added or removed, build a new ShortestPathTree instead.
+
+#ifndef SHORTESTPATHTREE_HPP
+#define SHORTESTPATHTREE_HPP
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <map>
+#include <queue>
+#include <set>
+#include <utility>
+#include <vector>
+#include "Digraph.hpp"
+
+
+
+template <typename VertexInfo, typename EdgeInfo>
+class ShortestPathTree
+{
+public:
+    // Initializes a ShortestPathTree by running Dijkstra's algorithm on
+    // the given Digraph from the given start vertex, using the given
+    // function to determine edge weights.  If the start vertex does not
+    // exist, a DigraphException is thrown instead.
+    ShortestPathTree(
+        const Digraph<VertexInfo, EdgeInfo>& digraph,
+        int startVertex,
+        std::function<double(const EdgeInfo&)> edgeWeightFunc);
+
+    // repair() brings the tree up to date after the EdgeInfo of each of
+    // the given (from, to) edges has been changed in the Digraph.  Both
+    // increases and decreases in weight may be mixed in one batch.
+    void repair(const std::vector<std::pair<int, int>>& changedEdges);
+
+    // predecessors() returns the tree in the same form findShortestPaths()
+    // does: every vertex mapped to its predecessor, with the start vertex
+    // and unreachable vertices mapped to themselves.
+    std::map<int, int> predecessors() const;
+
+    // distanceTo() returns the length of the shortest path to the given
+    // vertex, or infinity if it is unreachable.
+    double distanceTo(int vertex) const;
+
+    int startVertex() const noexcept;
+
+private:
+    // edgeWeight() returns the current weight of the edge pointing from
+    // "from" to "to" in the Digraph.
+    double edgeWeight(int fromVertex, int toVertex) const;
+
+    // setParent() makes "from" the predecessor of "to", keeping the
+    // children lists in step.
+    void setParent(int toVertex, int fromVertex);
+
+    // detach() removes the given vertex from its parent's children.
+    void detach(int vertex);
+
+    // collectSubtree() appends the given vertex and all of its tree
+    // descendants that aren't already in "affected" to it.
+    void collectSubtree(int vertex, std::set<int>& affected) const;
+
+    using Queue = std::priority_queue<
+        std::pair<double, int>, std::vector<std::pair<double, int>>,
+        std::greater<std::pair<double, int>>>;
+
+    // settle() runs Dijkstra's algorithm onward from whatever tentative
+    // distances are waiting in the queue.
+    void settle(Queue& pq);
+
+    const Digraph<VertexInfo, EdgeInfo>& digraph_;
+    int startVertex_;
+    std::function<double(const EdgeInfo&)> edgeWeightFunc_;
+
+    std::map<int, double> distances_;
+    std::map<int, int> parents_;
+    std::map<int, std::vector<int>> children_;
+
+    // The Digraph only stores outgoing edges, so the tree keeps its own
+    // list of each vertex's incoming neighbors, used to find a new parent
+    // for a vertex whose old one got worse.
+    std::map<int, std::vector<int>> incoming_;
+};
+
+
+
+template <typename VertexInfo, typename EdgeInfo>
+ShortestPathTree<VertexInfo, EdgeInfo>::ShortestPathTree(
+    const Digraph<VertexInfo, EdgeInfo>& digraph,
+    int startVertex,
+    std::function<double(const EdgeInfo&)> edgeWeightFunc)
+    : digraph_{digraph}, startVertex_{startVertex}, edgeWeightFunc_{std::move(edgeWeightFunc)}
+{
+    // Fail early, the same way findShortestPaths() does, if the start
+    // vertex isn't there.
+    digraph_.vertexInfo(startVertex_);
+
+    for (const std::pair<int, int>& edge : digraph_.edges())
+    {
+        incoming_[edge.second].push_back(edge.first);
+    }
+
+    Queue pq;
+    distances_[startVertex_] = 0.0;
+    pq.push(std::make_pair(0.0, startVertex_));
+    settle(pq);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void ShortestPathTree<VertexInfo, EdgeInfo>::repair(const std::vector<std::pair<int, int>>& changedEdges)
+{
+    // First, every vertex whose tree path runs through an edge that got
+    // more expensive may now have a longer shortest path, so the whole
+    // subtree hanging below that edge is cut loose.
+    std::set<int> affected;
+
+    for (const std::pair<int, int>& edge : changedEdges)
+    {
+        auto parent = parents_.find(edge.second);
+
+        if (parent != parents_.end() && parent->second == edge.first && edge.second != startVertex_
+            && distances_.at(edge.first) + edgeWeight(edge.first, edge.second) > distances_.at(edge.second))
+        {
+            collectSubtree(edge.second, affected);
+        }
+    }
+
+    for (int vertex : affected)
+    {
+        detach(vertex);
+        distances_.erase(vertex);
+    }
+
+    Queue pq;
+
+    // Each vertex that was cut loose gets its best tentative distance
+    // through a neighbor whose distance is still known to be right...
+    for (int vertex : affected)
+    {
+        double best = std::numeric_limits<double>::infinity();
+        int bestParent = vertex;
+
+        for (int neighbor : incoming_[vertex])
+        {
+            auto distance = distances_.find(neighbor);
+
+            if (distance != distances_.end() && affected.count(neighbor) == 0)
+            {
+                double candidate = distance->second + edgeWeight(neighbor, vertex);
+
+                if (candidate < best)
+                {
+                    best = candidate;
+                    bestParent = neighbor;
+                }
+            }
+        }
+
+        if (bestParent != vertex)
+        {
+            distances_[vertex] = best;
+            setParent(vertex, bestParent);
+            pq.push(std::make_pair(best, vertex));
+        }
+    }
+
+    // ...and every edge that got cheaper may offer a shortcut.
+    for (const std::pair<int, int>& edge : changedEdges)
+    {
+        auto from = distances_.find(edge.first);
+
+        if (from == distances_.end() || affected.count(edge.first) > 0 || edge.second == startVertex_)
+        {
+            continue;
+        }
+
+        double candidate = from->second + edgeWeight(edge.first, edge.second);
+        auto to = distances_.find(edge.second);
+
+        if (to == distances_.end() || candidate < to->second)
+        {
+            distances_[edge.second] = candidate;
+            setParent(edge.second, edge.first);
+            pq.push(std::make_pair(candidate, edge.second));
+        }
+    }
+
+    settle(pq);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+std::map<int, int> ShortestPathTree<VertexInfo, EdgeInfo>::predecessors() const
+{
+    std::map<int, int> returnValue = parents_;
+    returnValue[startVertex_] = startVertex_;
+
+    for (int vertex : digraph_.vertices())
+    {
+        returnValue.emplace(vertex, vertex);
+    }
+
+    return returnValue;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+double ShortestPathTree<VertexInfo, EdgeInfo>::distanceTo(int vertex) const
+{
+    auto found = distances_.find(vertex);
+
+    if (found == distances_.end())
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    return found->second;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+int ShortestPathTree<VertexInfo, EdgeInfo>::startVertex() const noexcept
+{
+    return startVertex_;
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+double ShortestPathTree<VertexInfo, EdgeInfo>::edgeWeight(int fromVertex, int toVertex) const
+{
+    return edgeWeightFunc_(digraph_.edgeInfo(fromVertex, toVertex));
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void ShortestPathTree<VertexInfo, EdgeInfo>::setParent(int toVertex, int fromVertex)
+{
+    detach(toVertex);
+    parents_[toVertex] = fromVertex;
+    children_[fromVertex].push_back(toVertex);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void ShortestPathTree<VertexInfo, EdgeInfo>::detach(int vertex)
+{
+    auto parent = parents_.find(vertex);
+
+    if (parent == parents_.end())
+    {
+        return;
+    }
+
+    std::vector<int>& siblings = children_[parent->second];
+    siblings.erase(std::find(siblings.begin(), siblings.end(), vertex));
+    parents_.erase(parent);
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void ShortestPathTree<VertexInfo, EdgeInfo>::collectSubtree(int vertex, std::set<int>& affected) const
+{
+    std::vector<int> stack{vertex};
+
+    while (!stack.empty())
+    {
+        int current = stack.back();
+        stack.pop_back();
+
+        if (!affected.insert(current).second)
+        {
+            continue;
+        }
+
+        auto children = children_.find(current);
+
+        if (children != children_.end())
+        {
+            stack.insert(stack.end(), children->second.begin(), children->second.end());
+        }
+    }
+}
+
+
+template <typename VertexInfo, typename EdgeInfo>
+void ShortestPathTree<VertexInfo, EdgeInfo>::settle(Queue& pq)
+{
+    while (!pq.empty())
+    {
+        double minDistance = pq.top().first;
+        int minVertex = pq.top().second;
+        pq.pop();
+
+        if (minDistance > distances_.at(minVertex))
+        {
+            continue;
+        }
+
+        digraph_.forEachEdge(
+            minVertex,
+            [&](const DigraphEdge<EdgeInfo>& edge)
+            {
+                if (edge.toVertex == startVertex_)
+                {
+                    return;
+                }
+
+                double candidate = minDistance + edgeWeightFunc_(edge.einfo);
+                auto found = distances_.find(edge.toVertex);
+
+                if (found == distances_.end() || candidate < found->second)
+                {
+                    distances_[edge.toVertex] = candidate;
+                    setParent(edge.toVertex, minVertex);
+                    pq.push(std::make_pair(candidate, edge.toVertex));
+                }
+            });
+    }
+}
+
+
+
+#endif
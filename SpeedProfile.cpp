@@ -0,0 +1,232 @@
+// SpeedProfile.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "SpeedProfile.hpp"
+
+
+namespace
+{
+    constexpr double hoursPerDay = 24.0;
+
+    // Breakpoints closer than this to the current hour are treated as
+    // already passed, so rounding can't leave travelHours() stuck on a
+    // zero-length piece.
+    constexpr double epsilonHours = 1e-9;
+
+
+    // parseDigits() parses the given digits as a whole number, throwing
+    // a std::invalid_argument naming the time they came from if they are
+    // anything but digits.
+    int parseDigits(const std::string& digits, const std::string& text)
+    {
+        if (digits.empty() || digits.size() > 4
+            || !std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; }))
+        {
+            throw std::invalid_argument{"Not a time of day: " + text};
+        }
+
+        return std::stoi(digits);
+    }
+}
+
+
+SpeedProfile::SpeedProfile(Breakpoints breakpoints)
+    : breakpoints_{std::move(breakpoints)}
+{
+    if (breakpoints_.empty())
+    {
+        throw std::invalid_argument{"A speed profile needs at least one breakpoint"};
+    }
+
+    for (const auto& breakpoint : breakpoints_)
+    {
+        if (breakpoint.first < 0.0f || breakpoint.first >= hoursPerDay || breakpoint.second <= 0.0f)
+        {
+            throw std::invalid_argument{"Speed profile breakpoint is out of range"};
+        }
+    }
+
+    std::sort(breakpoints_.begin(), breakpoints_.end());
+}
+
+
+double SpeedProfile::speedAt(double hour) const
+{
+    double day = std::floor(hour / hoursPerDay) * hoursPerDay;
+    double h = hour - day;
+
+    // Find the breakpoints on either side of h; before the first one of
+    // the day or after the last one, interpolate across midnight.
+    auto after = std::upper_bound(
+        breakpoints_.begin(), breakpoints_.end(), h,
+        [](double value, const std::pair<float, float>& breakpoint)
+        {
+            return value < breakpoint.first;
+        });
+
+    double fromHour;
+    double fromSpeed;
+    double toHour;
+    double toSpeed;
+
+    if (after == breakpoints_.begin())
+    {
+        fromHour = breakpoints_.back().first - hoursPerDay;
+        fromSpeed = breakpoints_.back().second;
+    }
+    else
+    {
+        fromHour = (after - 1)->first;
+        fromSpeed = (after - 1)->second;
+    }
+
+    if (after == breakpoints_.end())
+    {
+        toHour = breakpoints_.front().first + hoursPerDay;
+        toSpeed = breakpoints_.front().second;
+    }
+    else
+    {
+        toHour = after->first;
+        toSpeed = after->second;
+    }
+
+    if (toHour <= fromHour)
+    {
+        return fromSpeed;
+    }
+
+    return fromSpeed + (toSpeed - fromSpeed) * (h - fromHour) / (toHour - fromHour);
+}
+
+
+double SpeedProfile::travelHours(double miles, double departureHour) const
+{
+    double hour = departureHour;
+    double remaining = miles;
+
+    // Speed is linear between consecutive breakpoints, so each piece can
+    // be crossed in closed form; walk piece by piece until the distance
+    // left fits inside the current one.
+    while (remaining > 0.0)
+    {
+        double pieceEnd = nextBreakpointHour(hour);
+        double duration = pieceEnd - hour;
+        double v0 = speedAt(hour);
+        double v1 = speedAt(pieceEnd);
+        double covered = (v0 + v1) / 2.0 * duration;
+
+        if (covered >= remaining)
+        {
+            double acceleration = (v1 - v0) / duration;
+
+            if (std::abs(acceleration) < 1e-12)
+            {
+                hour += remaining / v0;
+            }
+            else
+            {
+                // remaining = v0 * t + acceleration * t^2 / 2
+                hour += (std::sqrt(v0 * v0 + 2.0 * acceleration * remaining) - v0) / acceleration;
+            }
+
+            break;
+        }
+
+        remaining -= covered;
+        hour = pieceEnd;
+    }
+
+    return hour - departureHour;
+}
+
+
+const SpeedProfile::Breakpoints& SpeedProfile::breakpoints() const noexcept
+{
+    return breakpoints_;
+}
+
+
+double SpeedProfile::parseHour(const std::string& text)
+{
+    std::size_t colon = text.find(':');
+
+    if (colon == std::string::npos)
+    {
+        std::size_t parsed = 0;
+        double hour = 0.0;
+
+        try
+        {
+            hour = std::stod(text, &parsed);
+        }
+        catch (const std::exception&)
+        {
+            parsed = 0;
+        }
+
+        if (parsed == 0 || parsed != text.size() || !(hour >= 0.0))
+        {
+            throw std::invalid_argument{"Not a time of day: " + text};
+        }
+
+        return hour;
+    }
+
+    int hours = parseDigits(text.substr(0, colon), text);
+    std::string minuteDigits = text.substr(colon + 1);
+    int minutes = parseDigits(minuteDigits, text);
+
+    if (minuteDigits.size() != 2 || minutes > 59)
+    {
+        throw std::invalid_argument{"Not a time of day: " + text};
+    }
+
+    return hours + minutes / 60.0;
+}
+
+
+double SpeedProfile::nextBreakpointHour(double hour) const
+{
+    double day = std::floor(hour / hoursPerDay) * hoursPerDay;
+    double h = hour - day;
+
+    for (const auto& breakpoint : breakpoints_)
+    {
+        if (breakpoint.first > h + epsilonHours)
+        {
+            return day + breakpoint.first;
+        }
+    }
+
+    return day + hoursPerDay + breakpoints_.front().first;
+}
+
+
+std::shared_ptr<const SpeedProfile> SpeedProfilePool::intern(SpeedProfile::Breakpoints breakpoints)
+{
+    std::sort(breakpoints.begin(), breakpoints.end());
+
+    auto found = profiles_.find(breakpoints);
+
+    if (found != profiles_.end())
+    {
+        return found->second;
+    }
+
+    auto profile = std::make_shared<const SpeedProfile>(breakpoints);
+    profiles_.emplace(std::move(breakpoints), profile);
+    return profile;
+}
+
+
+std::size_t SpeedProfilePool::size() const noexcept
+{
+    return profiles_.size();
+}
+
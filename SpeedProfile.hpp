@@ -0,0 +1,84 @@
+// SpeedProfile.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A SpeedProfile describes how the speed of traffic on a road segment
+// varies over the course of a day.  It's a piecewise-linear function of
+// the time of day, given as a sequence of breakpoints (an hour between 0
+// and 24, and the speed in miles per hour at that hour); speeds between
+// breakpoints are interpolated, wrapping around from the last breakpoint
+// of one day to the first breakpoint of the next.
+//
+// Since many road segments share the same pattern of traffic, profiles
+// are meant to be created through a SpeedProfilePool, which hands back
+// the same shared, immutable SpeedProfile for identical breakpoints.
+
+#ifndef SPEEDPROFILE_HPP
+#define SPEEDPROFILE_HPP
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+
+class SpeedProfile
+{
+public:
+    using Breakpoints = std::vector<std::pair<float, float>>;
+
+    // Initializes a SpeedProfile from a sequence of (hour, milesPerHour)
+    // breakpoints.  The breakpoints are sorted by hour; there must be at
+    // least one, every hour must be in [0, 24), and every speed must be
+    // positive, or a std::invalid_argument is thrown instead.
+    explicit SpeedProfile(Breakpoints breakpoints);
+
+    // speedAt() returns the speed, in miles per hour, at the given hour.
+    // Hours outside of [0, 24) are taken to be on an earlier or later day.
+    double speedAt(double hour) const;
+
+    // travelHours() returns how many hours it takes to drive the given
+    // number of miles when leaving at the given hour, following the speed
+    // changes along the way.  Leaving later never means arriving earlier.
+    double travelHours(double miles, double departureHour) const;
+
+    const Breakpoints& breakpoints() const noexcept;
+
+    // parseHour() converts a time of day written either as "H:MM" (e.g.,
+    // "7:30") or as a decimal number of hours (e.g., "7.5") into hours.
+    // Minutes outside 0-59, or characters left over after the time, cause
+    // a std::invalid_argument to be thrown.
+    static double parseHour(const std::string& text);
+
+private:
+    // nextBreakpointHour() returns the earliest breakpoint hour strictly
+    // after the given hour, which may belong to the following day.
+    double nextBreakpointHour(double hour) const;
+
+    Breakpoints breakpoints_;
+};
+
+
+
+// A SpeedProfilePool interns SpeedProfiles, so that every road segment
+// with the same breakpoints shares one SpeedProfile object.
+
+class SpeedProfilePool
+{
+public:
+    std::shared_ptr<const SpeedProfile> intern(SpeedProfile::Breakpoints breakpoints);
+
+    // size() returns the number of distinct profiles in the pool.
+    std::size_t size() const noexcept;
+
+private:
+    std::map<SpeedProfile::Breakpoints, std::shared_ptr<const SpeedProfile>> profiles_;
+};
+
+
+
+#endif
+
@@ -0,0 +1,59 @@
+// SpeedProfile_Tests.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// Unit tests for reading speed profiles, checking that times of day and
+// the pairs following a road segment's '@' are either read completely or
+// rejected.
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <gtest/gtest.h>
+#include "RoadMapReader.hpp"
+#include "SpeedProfile.hpp"
+
+
+namespace
+{
+    RoadSegment readSegment(const std::string& text, SpeedProfilePool& profiles)
+    {
+        std::istringstream in{text};
+        return RoadMapReader::readRoadSegment(in, profiles);
+    }
+}
+
+
+TEST(SpeedProfile_Tests, parsesOnlyWellFormedTimes)
+{
+    ASSERT_DOUBLE_EQ(7.5, SpeedProfile::parseHour("7:30"));
+    ASSERT_DOUBLE_EQ(0.0, SpeedProfile::parseHour("0:00"));
+    ASSERT_DOUBLE_EQ(7.5, SpeedProfile::parseHour("7.5"));
+
+    ASSERT_THROW(SpeedProfile::parseHour("7:75"), std::invalid_argument);
+    ASSERT_THROW(SpeedProfile::parseHour("7:30x"), std::invalid_argument);
+    ASSERT_THROW(SpeedProfile::parseHour("7:5"), std::invalid_argument);
+    ASSERT_THROW(SpeedProfile::parseHour(":30"), std::invalid_argument);
+    ASSERT_THROW(SpeedProfile::parseHour("-1:30"), std::invalid_argument);
+    ASSERT_THROW(SpeedProfile::parseHour("7.5h"), std::invalid_argument);
+    ASSERT_THROW(SpeedProfile::parseHour("noon"), std::invalid_argument);
+}
+
+
+TEST(SpeedProfile_Tests, roadSegmentsNeedCompleteProfiles)
+{
+    SpeedProfilePool profiles;
+
+    RoadSegment plain = readSegment("1.5 45", profiles);
+    ASSERT_DOUBLE_EQ(45.0, plain.milesPerHour);
+    ASSERT_EQ(nullptr, plain.speedProfile);
+
+    RoadSegment profiled = readSegment("1.5 45 @ 0:00 65 7:30 25", profiles);
+    ASSERT_NEAR(25.0, profiled.speedProfile->speedAt(7.5), 1e-9);
+
+    ASSERT_THROW(readSegment("1.5 45 @ 0:00 65 7:30", profiles), std::invalid_argument);
+    ASSERT_THROW(readSegment("1.5 45 @ 0:00 65x", profiles), std::invalid_argument);
+    ASSERT_THROW(readSegment("1.5 45 @ 7:75 65", profiles), std::invalid_argument);
+    ASSERT_THROW(readSegment("1.5 45 0:00 65", profiles), std::invalid_argument);
+}
@@ -6,10 +6,20 @@
 // Describes a type that carries information about one trip to be evaluated
 // by the program.  A trip is described by a start vertex number, an end
 // vertex number, and a TripMetric (i.e., distance or driving time).
+// A trip may also carry a departure time (in hours since midnight), in
+// which case driving time trips are answered using each road segment's
+// speed profile at the time it would actually be driven.
+//
+// A trip can also visit a sequence of intermediate stops on its way from
+// the start vertex to the end vertex.  If reorderStops is true, those
+// stops may be visited in whatever order makes the whole trip shortest
+// (by the trip's metric); otherwise they're visited in the order given.
 
 #ifndef TRIP_HPP
 #define TRIP_HPP
 
+#include <optional>
+#include <vector>
 #include "TripMetric.hpp"
 
 
@@ -19,6 +29,9 @@ struct Trip
     int startVertex;
     int endVertex;
     TripMetric metric;
+    std::optional<double> departureTime = std::nullopt;
+    std::vector<int> stops = {};
+    bool reorderStops = false;
 };
 
 
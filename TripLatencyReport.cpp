@@ -0,0 +1,117 @@
+// TripLatencyReport.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <cstdint>
+#include <iomanip>
+#include <string>
+#include "TripLatencyReport.hpp"
+
+
+void TripLatencyReport::record(const Trip& trip, const Route& route, std::chrono::nanoseconds latency)
+{
+    histograms_[Key{trip.metric, lengthClass(route)}].record(latency);
+}
+
+
+void TripLatencyReport::merge(const TripLatencyReport& other)
+{
+    for (const auto& entry : other.histograms_)
+    {
+        histograms_[entry.first].merge(entry.second);
+    }
+}
+
+
+void TripLatencyReport::write(std::ostream& out, double seconds) const
+{
+    std::uint64_t tripCount = 0;
+
+    for (const auto& entry : histograms_)
+    {
+        tripCount += entry.second.count();
+    }
+
+    out << std::endl << "Planned " << tripCount << " trips in "
+        << std::fixed << std::setprecision(3) << seconds << " s ("
+        << std::setprecision(1) << tripCount / seconds << " trips/s)" << std::endl
+        << "  " << std::left << std::setw(28) << "latency (ms)" << std::right
+        << std::setw(8) << "trips" << std::setw(11) << "p50" << std::setw(11) << "p95"
+        << std::setw(11) << "p99" << std::setw(11) << "max" << std::endl;
+
+    for (TripMetric metric : {TripMetric::Distance, TripMetric::Time})
+    {
+        std::string name = metric == TripMetric::Distance ? "distance" : "time";
+        LatencyHistogram all;
+
+        for (const auto& entry : histograms_)
+        {
+            if (entry.first.first == metric)
+            {
+                all.merge(entry.second);
+            }
+        }
+
+        if (all.count() == 0)
+        {
+            continue;
+        }
+
+        writeLine(out, name, all);
+
+        for (const auto& entry : histograms_)
+        {
+            if (entry.first.first != metric)
+            {
+                continue;
+            }
+
+            std::size_t lengthClass = entry.first.second;
+            std::string label = lengthClass == 0
+                ? "no route"
+                : std::to_string(lengthClass == 1 ? 0 : lengthClass) + "-"
+                    + std::to_string(lengthClass * 10 - 1) + " segments";
+
+            writeLine(out, "  " + label, entry.second);
+        }
+    }
+}
+
+
+std::size_t TripLatencyReport::lengthClass(const Route& route) noexcept
+{
+    // A trip that starts where it ends has a route of one vertex and no
+    // segments, which is still a route.
+    if (route.vertices.empty())
+    {
+        return 0;
+    }
+
+    std::size_t segments = route.vertices.size() - 1;
+    std::size_t lengthClass = 1;
+
+    while (segments >= lengthClass * 10)
+    {
+        lengthClass *= 10;
+    }
+
+    return lengthClass;
+}
+
+
+void TripLatencyReport::writeLine(std::ostream& out, const std::string& label, const LatencyHistogram& histogram)
+{
+    auto ms = [](std::chrono::nanoseconds latency)
+    {
+        return std::chrono::duration<double, std::milli>(latency).count();
+    };
+
+    out << "  " << std::left << std::setw(28) << label << std::right
+        << std::setw(8) << histogram.count()
+        << std::fixed << std::setprecision(3)
+        << std::setw(11) << ms(histogram.percentile(50))
+        << std::setw(11) << ms(histogram.percentile(95))
+        << std::setw(11) << ms(histogram.percentile(99))
+        << std::setw(11) << ms(histogram.max()) << std::endl;
+}
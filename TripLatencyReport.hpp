@@ -0,0 +1,67 @@
+// TripLatencyReport.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A TripLatencyReport collects how long each trip of a run took to plan
+// and writes the summary printed by "main --report": throughput, plus
+// latency percentiles broken down by metric and by the number of road
+// segments in each route, rounded down to a power of ten (with routes of
+// fewer than ten segments, including a trip's single vertex when it
+// starts where it ends, counted together).  For example:
+//
+//     Planned 4 trips in 0.500 s (8.0 trips/s)
+//       latency (ms)                   trips        p50        p95        p99        max
+//       distance                           3      2.097      4.194      4.194      4.194
+//         no route                         1      1.049      1.049      1.049      1.049
+//         0-9 segments                     1      2.097      2.097      2.097      2.097
+//         10-99 segments                   1      4.194      4.194      4.194      4.194
+//
+// Like a LatencyHistogram, a TripLatencyReport is not synchronized; give
+// each thread its own and merge() them afterward.
+
+#ifndef TRIPLATENCYREPORT_HPP
+#define TRIPLATENCYREPORT_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include "LatencyHistogram.hpp"
+#include "Route.hpp"
+#include "Trip.hpp"
+
+
+
+class TripLatencyReport
+{
+public:
+    // record() adds one trip, planned as the given route, that took the
+    // given amount of time.
+    void record(const Trip& trip, const Route& route, std::chrono::nanoseconds latency);
+
+    // merge() adds every trip recorded in another report.
+    void merge(const TripLatencyReport& other);
+
+    // write() writes the summary to the given output stream, given how
+    // many seconds the whole run took.
+    void write(std::ostream& out, double seconds) const;
+
+private:
+    // Latencies are grouped by metric and by the route's segment count,
+    // rounded down to a power of ten (0 meaning there was no route, and
+    // 1 meaning fewer than ten segments).
+    using Key = std::pair<TripMetric, std::size_t>;
+
+    static std::size_t lengthClass(const Route& route) noexcept;
+
+    static void writeLine(std::ostream& out, const std::string& label, const LatencyHistogram& histogram);
+
+    std::map<Key, LatencyHistogram> histograms_;
+};
+
+
+
+#endif
@@ -0,0 +1,78 @@
+// TripLatencyReport_Tests.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// Unit tests for TripLatencyReport, checking the summary that
+// "main --report" prints.
+
+#include <chrono>
+#include <sstream>
+#include <gtest/gtest.h>
+#include "TripLatencyReport.hpp"
+
+
+namespace
+{
+    // A route with the given number of road segments.
+    Route withSegments(int segments)
+    {
+        Route route{{}, 0.0, 0.0};
+
+        for (int i = 0; i <= segments; ++i)
+        {
+            route.vertices.push_back(i);
+        }
+
+        return route;
+    }
+
+
+    // What the planner returns when the end can't be reached.
+    Route noRoute()
+    {
+        return Route{{}, 0.0, 0.0};
+    }
+
+
+    // Times of 2^k - 1 nanoseconds are the limits of their histogram
+    // buckets, so percentiles of them come out exact.
+    std::chrono::nanoseconds exact(int k)
+    {
+        return std::chrono::nanoseconds{(std::int64_t{1} << k) - 1};
+    }
+}
+
+
+TEST(TripLatencyReport_Tests, reportsGroupsByMetricAndRouteLength)
+{
+    Trip distance{0, 1, TripMetric::Distance};
+    Trip time{0, 1, TripMetric::Time};
+
+    TripLatencyReport report;
+    report.record(distance, noRoute(), exact(20));
+    report.record(distance, withSegments(12), exact(22));
+
+    TripLatencyReport other;
+    other.record(distance, withSegments(3), exact(21));
+    other.record(time, withSegments(1), exact(23));
+    report.merge(other);
+
+    // A trip that starts where it ends is a route of no segments.
+    report.record(Trip{1, 1, TripMetric::Time}, withSegments(0), exact(23));
+
+    std::ostringstream out;
+    report.write(out, 0.5);
+
+    ASSERT_EQ(
+        "\n"
+        "Planned 5 trips in 0.500 s (10.0 trips/s)\n"
+        "  latency (ms)                   trips        p50        p95        p99        max\n"
+        "  distance                           3      2.097      4.194      4.194      4.194\n"
+        "    no route                         1      1.049      1.049      1.049      1.049\n"
+        "    0-9 segments                     1      2.097      2.097      2.097      2.097\n"
+        "    10-99 segments                   1      4.194      4.194      4.194      4.194\n"
+        "  time                               2      8.389      8.389      8.389      8.389\n"
+        "    0-9 segments                     2      8.389      8.389      8.389      8.389\n",
+        out.str());
+}
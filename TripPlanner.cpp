@@ -0,0 +1,446 @@
+// TripPlanner.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include "TripPlanner.hpp"
+
+
+namespace
+{
+    using GroupKey = std::tuple<int, TripMetric, std::optional<double>>;
+
+
+    // departingHours() returns the driving time of a route when leaving
+    // at the given hour, entering each segment at the time the previous
+    // one was finished.
+    double departingHours(const RoadMap& roadMap, const Route& route, double departureTime)
+    {
+        double hour = departureTime;
+
+        for (std::size_t i = 1; i < route.vertices.size(); ++i)
+        {
+            hour += travelHours(roadMap.edgeInfo(route.vertices[i - 1], route.vertices[i]), hour);
+        }
+
+        return hour - departureTime;
+    }
+
+
+    // orderStops() chooses an order in which to visit points 1 through
+    // n - 2, given the cost of getting from each point to every other
+    // (costs[i][j]), when the trip must start at point 0 and end at
+    // point n - 1.  The result lists all n points in visiting order.
+    std::vector<std::size_t> orderStops(const std::vector<std::vector<double>>& costs)
+    {
+        std::size_t n = costs.size();
+        std::vector<std::size_t> order{0};
+        std::vector<bool> visited(n, false);
+        visited[0] = true;
+        visited[n - 1] = true;
+
+        for (std::size_t step = 1; step + 1 < n; ++step)
+        {
+            std::size_t nearest = 0;
+
+            for (std::size_t j = 1; j + 1 < n; ++j)
+            {
+                if (!visited[j] && (nearest == 0 || costs[order.back()][j] < costs[order.back()][nearest]))
+                {
+                    nearest = j;
+                }
+            }
+
+            visited[nearest] = true;
+            order.push_back(nearest);
+        }
+
+        order.push_back(n - 1);
+
+        auto totalCost = [&](const std::vector<std::size_t>& candidate)
+        {
+            double total = 0.0;
+
+            for (std::size_t i = 1; i < candidate.size(); ++i)
+            {
+                total += costs[candidate[i - 1]][candidate[i]];
+            }
+
+            return total;
+        };
+
+        // Costs needn't be symmetric (one-way streets), so each reversal
+        // is judged by the whole trip's cost rather than just its ends.
+        double best = totalCost(order);
+        bool improved = true;
+
+        while (improved)
+        {
+            improved = false;
+
+            for (std::size_t i = 1; i + 2 < order.size(); ++i)
+            {
+                for (std::size_t j = i + 1; j + 1 < order.size(); ++j)
+                {
+                    std::vector<std::size_t> candidate = order;
+                    std::reverse(candidate.begin() + i, candidate.begin() + j + 1);
+
+                    double cost = totalCost(candidate);
+
+                    if (cost < best)
+                    {
+                        best = cost;
+                        order = std::move(candidate);
+                        improved = true;
+                    }
+                }
+            }
+        }
+
+        return order;
+    }
+}
+
+
+TripPlanner::TripPlanner(const TurnTable& turns) noexcept
+    : turns_{&turns}
+{
+}
+
+
+std::vector<Route> TripPlanner::planTrips(const RoadMap& roadMap, const std::vector<Trip>& trips)
+{
+    NoSearchStats stats;
+    return planTripsWith(roadMap, trips, stats);
+}
+
+
+std::vector<Route> TripPlanner::planTrips(
+    const RoadMap& roadMap, const std::vector<Trip>& trips, SearchStats& stats)
+{
+    CountingSearchStats counting;
+    std::vector<Route> routes = planTripsWith(roadMap, trips, counting);
+
+    stats += counting.stats();
+    return routes;
+}
+
+
+template <typename SearchStatsPolicy>
+std::vector<Route> TripPlanner::planTripsWith(
+    const RoadMap& roadMap, const std::vector<Trip>& trips, SearchStatsPolicy& stats)
+{
+    std::vector<Route> routes(trips.size());
+
+    // Trips sharing a start vertex and a metric (and, for time-dependent
+    // driving time trips, a departure time) can all be answered out of
+    // the same search, so collect the indexes of the trips in each of
+    // those groups first.
+    std::map<GroupKey, std::vector<std::size_t>> groups;
+
+    for (std::size_t i = 0; i < trips.size(); ++i)
+    {
+        if (!trips[i].stops.empty())
+        {
+            routes[i] = planMultiStopTrip(roadMap, trips[i], stats);
+            continue;
+        }
+
+        std::optional<double> departureTime;
+
+        if (trips[i].metric == TripMetric::Time)
+        {
+            departureTime = trips[i].departureTime;
+        }
+
+        groups[GroupKey{trips[i].startVertex, trips[i].metric, departureTime}].push_back(i);
+    }
+
+    for (const auto& group : groups)
+    {
+        int startVertex = std::get<0>(group.first);
+        TripMetric metric = std::get<1>(group.first);
+        std::optional<double> departureTime = std::get<2>(group.first);
+
+        std::vector<int> targets;
+
+        for (std::size_t i : group.second)
+        {
+            targets.push_back(trips[i].endVertex);
+        }
+
+        if (obeysTurns())
+        {
+            // Turn-aware searches use snapshot driving times; trips with a
+            // departure time are then re-timed along the route they find.
+            std::map<int, Route> found = turnAwareRoutes(roadMap, startVertex, targets, metric, stats);
+
+            for (std::size_t i : group.second)
+            {
+                routes[i] = found.at(trips[i].endVertex);
+
+                if (departureTime)
+                {
+                    routes[i].hours = departingHours(roadMap, routes[i], *departureTime)
+                        + turns_->routePenaltyHours(routes[i].vertices);
+                }
+            }
+
+            continue;
+        }
+
+        std::map<int, int> predecessors;
+
+        if (departureTime)
+        {
+            predecessors = roadMap.findTimeDependentPaths(
+                startVertex, *departureTime, targets, travelHours, stats);
+        }
+        else
+        {
+            predecessors = roadMap.findShortestPaths(
+                startVertex, targets, edgeWeightFor(metric), stats);
+        }
+
+        for (std::size_t i : group.second)
+        {
+            routes[i] = routeFor(roadMap, predecessors, startVertex, trips[i].endVertex);
+
+            if (departureTime)
+            {
+                routes[i].hours = departingHours(roadMap, routes[i], *departureTime);
+            }
+        }
+    }
+
+    return routes;
+}
+
+
+void TripPlanner::checkVertices(const RoadMap& roadMap, const Trip& trip)
+{
+    std::vector<int> vertices{trip.startVertex, trip.endVertex};
+    vertices.insert(vertices.end(), trip.stops.begin(), trip.stops.end());
+
+    for (int vertex : vertices)
+    {
+        if (roadMap.findVertexInfo(vertex) == nullptr)
+        {
+            throw DigraphException("No such vertex: " + std::to_string(vertex));
+        }
+    }
+}
+
+
+std::function<double(const RoadSegment&)> TripPlanner::edgeWeightFor(TripMetric metric)
+{
+    if (metric == TripMetric::Time)
+    {
+        return [](const RoadSegment& segment) { return segment.miles / segment.milesPerHour; };
+    }
+    else
+    {
+        return [](const RoadSegment& segment) { return segment.miles; };
+    }
+}
+
+
+Route TripPlanner::routeFor(
+    const RoadMap& roadMap, const std::map<int, int>& predecessors,
+    int startVertex, int endVertex)
+{
+    auto found = predecessors.find(endVertex);
+
+    if (found == predecessors.end() || (found->second == endVertex && endVertex != startVertex))
+    {
+        return Route{{}, 0.0, 0.0};
+    }
+
+    std::vector<int> vertices{endVertex};
+
+    while (vertices.back() != startVertex)
+    {
+        vertices.push_back(predecessors.at(vertices.back()));
+    }
+
+    std::reverse(vertices.begin(), vertices.end());
+    return routeAlong(roadMap, std::move(vertices));
+}
+
+
+Route TripPlanner::routeAlong(const RoadMap& roadMap, std::vector<int> vertices)
+{
+    Route route{std::move(vertices), 0.0, 0.0};
+
+    for (std::size_t i = 1; i < route.vertices.size(); ++i)
+    {
+        RoadSegment segment = roadMap.edgeInfo(route.vertices[i - 1], route.vertices[i]);
+
+        route.miles += segment.miles;
+        route.hours += segment.miles / segment.milesPerHour;
+    }
+
+    return route;
+}
+
+
+template <typename SearchStatsPolicy>
+Route TripPlanner::planMultiStopTrip(const RoadMap& roadMap, const Trip& trip, SearchStatsPolicy& stats)
+{
+    std::vector<int> points{trip.startVertex};
+    points.insert(points.end(), trip.stops.begin(), trip.stops.end());
+    points.push_back(trip.endVertex);
+
+    std::size_t n = points.size();
+
+    // legs[i][j] is the best route from points[i] to points[j].  Without
+    // reordering, only consecutive points are ever needed.
+    std::vector<std::vector<Route>> legs(n, std::vector<Route>(n));
+    std::vector<std::vector<double>> costs(
+        n, std::vector<double>(n, std::numeric_limits<double>::infinity()));
+
+    for (std::size_t i = 0; i + 1 < n; ++i)
+    {
+        std::vector<std::size_t> destinations;
+
+        if (trip.reorderStops)
+        {
+            for (std::size_t j = 1; j < n; ++j)
+            {
+                if (j != i)
+                {
+                    destinations.push_back(j);
+                }
+            }
+        }
+        else
+        {
+            destinations.push_back(i + 1);
+        }
+
+        std::vector<int> targets;
+
+        for (std::size_t j : destinations)
+        {
+            targets.push_back(points[j]);
+        }
+
+        std::map<int, Route> found;
+        std::map<int, int> predecessors;
+
+        if (obeysTurns())
+        {
+            found = turnAwareRoutes(roadMap, points[i], targets, trip.metric, stats);
+        }
+        else
+        {
+            predecessors = roadMap.findShortestPaths(points[i], targets, edgeWeightFor(trip.metric), stats);
+        }
+
+        for (std::size_t j : destinations)
+        {
+            legs[i][j] = obeysTurns()
+                ? found.at(points[j])
+                : routeFor(roadMap, predecessors, points[i], points[j]);
+
+            if (!legs[i][j].vertices.empty())
+            {
+                costs[i][j] = trip.metric == TripMetric::Time ? legs[i][j].hours : legs[i][j].miles;
+            }
+        }
+    }
+
+    std::vector<std::size_t> order(n);
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        order[i] = i;
+    }
+
+    if (trip.reorderStops)
+    {
+        order = orderStops(costs);
+    }
+
+    Route route{{trip.startVertex}, 0.0, 0.0};
+    double hour = trip.departureTime.value_or(0.0);
+
+    for (std::size_t i = 1; i < n; ++i)
+    {
+        Route leg = legs[order[i - 1]][order[i]];
+
+        if (leg.vertices.empty())
+        {
+            return Route{{}, 0.0, 0.0};
+        }
+
+        if (trip.metric == TripMetric::Time && trip.departureTime)
+        {
+            leg.hours = departingHours(roadMap, leg, hour);
+
+            if (obeysTurns())
+            {
+                leg.hours += turns_->routePenaltyHours(leg.vertices);
+            }
+
+            hour += leg.hours;
+        }
+
+        route.vertices.insert(route.vertices.end(), leg.vertices.begin() + 1, leg.vertices.end());
+        route.miles += leg.miles;
+        route.hours += leg.hours;
+        route.legs.push_back(std::move(leg));
+    }
+
+    return route;
+}
+
+
+bool TripPlanner::obeysTurns() const noexcept
+{
+    return turns_ != nullptr && !turns_->empty();
+}
+
+
+template <typename SearchStatsPolicy>
+std::map<int, Route> TripPlanner::turnAwareRoutes(
+    const RoadMap& roadMap, int startVertex, const std::vector<int>& targets,
+    TripMetric metric, SearchStatsPolicy& stats) const
+{
+    const TurnTable& turns = *turns_;
+
+    // Turn penalties are time, so they only count against driving time;
+    // banned turns are avoided whatever the metric.
+    std::function<double(int, int, int)> turnCostFunc;
+
+    if (metric == TripMetric::Time)
+    {
+        turnCostFunc = [&](int from, int via, int to) { return turns.penaltyHours(from, via, to); };
+    }
+    else
+    {
+        turnCostFunc = [&](int from, int via, int to)
+        {
+            return turns.isBanned(from, via, to) ? std::numeric_limits<double>::infinity() : 0.0;
+        };
+    }
+
+    std::map<int, std::vector<int>> paths = roadMap.findTurnAwarePaths(
+        startVertex, targets, edgeWeightFor(metric), turnCostFunc, stats);
+
+    std::map<int, Route> routes;
+
+    for (auto& path : paths)
+    {
+        Route route = routeAlong(roadMap, std::move(path.second));
+        route.hours += turns.routePenaltyHours(route.vertices);
+        routes.emplace(path.first, std::move(route));
+    }
+
+    return routes;
+}
@@ -0,0 +1,106 @@
+// TripPlanner.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A TripPlanner answers a whole batch of trips (as read by a TripReader)
+// at once.  Rather than running one search per trip, it groups the trips
+// by start vertex and metric, runs a single one-to-many search for each
+// group that stops as soon as all of that group's end vertices have been
+// reached, and then hands back one Route per trip in the original order.
+//
+// Trips with intermediate stops are planned from a table of the best
+// route between every pair of their stops, filled in with one one-to-many
+// search per stop.  When a trip allows its stops to be reordered, that
+// table is used to choose a good visiting order: stops are first taken
+// nearest-first, and then the order is improved by reversing stretches
+// of it (the "2-opt" heuristic) for as long as that helps.
+//
+// A TripPlanner can also be given a TurnTable, in which case its searches
+// avoid banned turns and, when minimizing driving time, weigh the extra
+// time that turns take; every route's driving time includes the penalties
+// of the turns it makes.  Turns at a trip's intermediate stops aren't
+// restricted, since the driver stops there anyway.
+
+#ifndef TRIPPLANNER_HPP
+#define TRIPPLANNER_HPP
+
+#include <functional>
+#include <map>
+#include <vector>
+#include "RoadMap.hpp"
+#include "Route.hpp"
+#include "SearchStats.hpp"
+#include "Trip.hpp"
+#include "TurnTable.hpp"
+
+
+
+class TripPlanner
+{
+public:
+    // Initializes a TripPlanner that allows every turn.
+    TripPlanner() noexcept = default;
+
+    // Initializes a TripPlanner that obeys the given TurnTable, which
+    // must outlive it.
+    explicit TripPlanner(const TurnTable& turns) noexcept;
+
+    // planTrips() returns one Route for each of the given trips, in the
+    // same order as the trips.
+    std::vector<Route> planTrips(const RoadMap& roadMap, const std::vector<Trip>& trips);
+
+    // This overload of planTrips() also totals up the work done by every
+    // search it runs into the given SearchStats.
+    std::vector<Route> planTrips(
+        const RoadMap& roadMap, const std::vector<Trip>& trips, SearchStats& stats);
+
+    // checkVertices() throws a DigraphException if the start, end, or any
+    // stop of the given trip is not a vertex of the given RoadMap.
+    static void checkVertices(const RoadMap& roadMap, const Trip& trip);
+
+    // edgeWeightFor() returns the edge weight function that findShortestPaths()
+    // should use to minimize the given metric: miles for distance, hours
+    // for driving time.
+    static std::function<double(const RoadSegment&)> edgeWeightFor(TripMetric metric);
+
+    // routeFor() rebuilds the Route from startVertex to endVertex out of a
+    // predecessor map returned by findShortestPaths().
+    static Route routeFor(
+        const RoadMap& roadMap, const std::map<int, int>& predecessors,
+        int startVertex, int endVertex);
+
+    // routeAlong() returns the Route that visits the given vertices in
+    // order, totalling up the road segments between them.
+    static Route routeAlong(const RoadMap& roadMap, std::vector<int> vertices);
+
+private:
+    // planTripsWith() does the work of both planTrips() overloads, with
+    // the given search statistics policy.
+    template <typename SearchStatsPolicy>
+    std::vector<Route> planTripsWith(
+        const RoadMap& roadMap, const std::vector<Trip>& trips, SearchStatsPolicy& stats);
+
+    // planMultiStopTrip() returns the Route for a trip with intermediate
+    // stops, with one leg per pair of consecutive stops.
+    template <typename SearchStatsPolicy>
+    Route planMultiStopTrip(const RoadMap& roadMap, const Trip& trip, SearchStatsPolicy& stats);
+
+    // obeysTurns() returns true if there are turn rules to take account of.
+    bool obeysTurns() const noexcept;
+
+    // turnAwareRoutes() returns the route from the start vertex to each of
+    // the given targets found by a turn-aware search minimizing the given
+    // metric, with turn penalties added to each route's driving time.
+    template <typename SearchStatsPolicy>
+    std::map<int, Route> turnAwareRoutes(
+        const RoadMap& roadMap, int startVertex, const std::vector<int>& targets,
+        TripMetric metric, SearchStatsPolicy& stats) const;
+
+    const TurnTable* turns_ = nullptr;
+};
+
+
+
+#endif
+
@@ -3,11 +3,68 @@
 // ICS 46 Winter 2022
 // Project #5: Rock and Roll Stops the Traffic
 
+#include <iomanip>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include "SpeedProfile.hpp"
 #include "TripReader.hpp"
 
 
+namespace
+{
+    // readToken() reads the next whitespace-separated token, or the next
+    // quoted name, returning false if there are none left.
+    bool readToken(std::istream& in, std::string& token, bool& quoted)
+    {
+        token.clear();
+        in >> std::ws;
+        quoted = in.peek() == '"';
+
+        if (quoted)
+        {
+            in >> std::quoted(token);
+        }
+        else
+        {
+            in >> token;
+        }
+
+        return static_cast<bool>(in);
+    }
+
+
+    int vertexNamed(const std::string& name, const LocationIndex* locations)
+    {
+        if (locations == nullptr)
+        {
+            throw std::invalid_argument{"Locations can't be named here: " + name};
+        }
+
+        std::optional<int> vertex = locations->findVertex(name);
+
+        if (!vertex)
+        {
+            throw std::invalid_argument{"No such location: " + name};
+        }
+
+        return *vertex;
+    }
+}
+
+
+TripReader::TripReader() noexcept
+    : locations_{nullptr}
+{
+}
+
+
+TripReader::TripReader(const LocationIndex& locations) noexcept
+    : locations_{&locations}
+{
+}
+
+
 std::vector<Trip> TripReader::readTrips(InputReader& in)
 {
     std::vector<Trip> trips;
@@ -16,19 +73,71 @@ std::vector<Trip> TripReader::readTrips(InputReader& in)
 
     for (int i = 0; i < numberOfTrips; ++i)
     {
-        std::istringstream tripLine{in.readLine()};
+        trips.push_back(parseTrip(in.readLine(), locations_));
+    }
+
+    return trips;
+}
+
+
+Trip TripReader::parseTrip(const std::string& line, const LocationIndex* locations)
+{
+    std::istringstream tripLine{line};
+
+    // A trip line lists two or more vertex numbers or quoted location
+    // names (the start, any intermediate stops, and the end), then the
+    // metric, then an optional departure time and an optional "reorder"
+    // keyword.
+    std::vector<int> vertices;
+    std::string token;
+    bool quoted = false;
+
+    while (readToken(tripLine, token, quoted) && (quoted || (token != "D" && token != "T")))
+    {
+        if (quoted)
+        {
+            vertices.push_back(vertexNamed(token, locations));
+            continue;
+        }
 
-        int fromVertex;
-        int toVertex;
-        std::string metricType;
+        std::size_t length = 0;
 
-        tripLine >> fromVertex >> toVertex >> metricType;
+        try
+        {
+            vertices.push_back(std::stoi(token, &length));
+        }
+        catch (const std::logic_error&)
+        {
+        }
 
-        trips.push_back(
-            {fromVertex, toVertex,
-             metricType == "D" ? TripMetric::Distance : TripMetric::Time});
+        if (length == 0 || length != token.size())
+        {
+            throw std::invalid_argument{"Not a vertex number: " + token};
+        }
     }
 
-    return trips;
-}
+    if (vertices.size() < 2 || quoted || (token != "D" && token != "T"))
+    {
+        throw std::invalid_argument{"A trip needs a start, an end, and a metric (D or T)"};
+    }
+
+    Trip trip{
+        vertices.front(), vertices.back(),
+        token == "D" ? TripMetric::Distance : TripMetric::Time};
 
+    trip.stops.assign(vertices.begin() + 1, vertices.end() - 1);
+
+    while (tripLine >> token)
+    {
+        if (token == "reorder")
+        {
+            trip.reorderStops = true;
+        }
+        else
+        {
+            trip.departureTime = SpeedProfile::parseHour(token);
+        }
+    }
+
+    return trip;
+}
@@ -5,22 +5,53 @@
 //
 // A TripReader reads a sequence of trips from the given input, assuming
 // they're written in the format described in the project write-up.
+//
+// That format is extended in two ways.  Any number of intermediate stops
+// may be listed between the start and end vertex numbers, and the metric
+// may be followed by a departure time (e.g., "7:45") and/or the keyword
+// "reorder", which lets the stops be visited in the best order, e.g.:
+//
+//     0 14 9 22 T 7:45 reorder
+//
+// When the TripReader is given a LocationIndex, locations may also be
+// named instead of numbered, with each name in double quotes (and any
+// quotes or backslashes in it escaped with a backslash), e.g.:
+//
+//     "Anteater Stadium" "Newport Beach" T
 
 #ifndef TRIPREADER_HPP
 #define TRIPREADER_HPP
 
+#include <string>
 #include <vector>
 #include "Trip.hpp"
 #include "InputReader.hpp"
+#include "LocationIndex.hpp"
 
 
 
 class TripReader
 {
 public:
+    // Initializes a TripReader that only understands vertex numbers.
+    TripReader() noexcept;
+
+    // Initializes a TripReader that also understands location names, as
+    // found in the given LocationIndex, which must outlive it.
+    explicit TripReader(const LocationIndex& locations) noexcept;
+
     // readTrips() reads a sequence of trips from the given input,
     // returning them as a vector of Trip structs.
     std::vector<Trip> readTrips(InputReader& in);    
+
+    // parseTrip() converts one trip line into a Trip, looking up any
+    // location names in the given LocationIndex.  If the line isn't a
+    // valid trip, or names a location that isn't in the index (or there
+    // is no index), a std::invalid_argument is thrown instead.
+    static Trip parseTrip(const std::string& line, const LocationIndex* locations = nullptr);
+
+private:
+    const LocationIndex* locations_;
 };
 
 
@@ -0,0 +1,121 @@
+// TurnTable.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include "TurnTable.hpp"
+
+
+namespace
+{
+    std::tuple<int, int, int> keyOf(const TurnRule& rule) noexcept
+    {
+        return std::make_tuple(rule.viaVertex, rule.fromVertex, rule.toVertex);
+    }
+}
+
+
+TurnTable::TurnTable(std::vector<TurnRule> rules)
+    : rules_{std::move(rules)}
+{
+    // A stable sort keeps duplicate rules in their original order, so
+    // that the last one can be kept.
+    std::stable_sort(
+        rules_.begin(), rules_.end(),
+        [](const TurnRule& a, const TurnRule& b) { return keyOf(a) < keyOf(b); });
+
+    std::vector<TurnRule> unique;
+
+    for (const TurnRule& rule : rules_)
+    {
+        if (!unique.empty() && keyOf(unique.back()) == keyOf(rule))
+        {
+            unique.back() = rule;
+        }
+        else
+        {
+            unique.push_back(rule);
+        }
+    }
+
+    rules_ = std::move(unique);
+    rules_.shrink_to_fit();
+}
+
+
+std::size_t TurnTable::size() const noexcept
+{
+    return rules_.size();
+}
+
+
+bool TurnTable::empty() const noexcept
+{
+    return rules_.empty();
+}
+
+
+double TurnTable::penaltyHours(int fromVertex, int viaVertex, int toVertex) const noexcept
+{
+    TurnRule turn{fromVertex, viaVertex, toVertex, 0.0f};
+
+    auto found = std::lower_bound(
+        rules_.begin(), rules_.end(), turn,
+        [](const TurnRule& a, const TurnRule& b) { return keyOf(a) < keyOf(b); });
+
+    if (found == rules_.end() || keyOf(*found) != keyOf(turn))
+    {
+        return 0.0;
+    }
+
+    return found->penaltyHours;
+}
+
+
+bool TurnTable::isBanned(int fromVertex, int viaVertex, int toVertex) const noexcept
+{
+    return std::isinf(penaltyHours(fromVertex, viaVertex, toVertex));
+}
+
+
+double TurnTable::routePenaltyHours(const std::vector<int>& vertices) const noexcept
+{
+    double hours = 0.0;
+
+    for (std::size_t i = 2; i < vertices.size(); ++i)
+    {
+        hours += penaltyHours(vertices[i - 2], vertices[i - 1], vertices[i]);
+    }
+
+    return hours;
+}
+
+
+void TurnTable::removeRulesOn(const std::set<std::pair<int, int>>& segments, const std::set<int>& vertices)
+{
+    // Removing rules leaves the rest in order.
+    rules_.erase(
+        std::remove_if(
+            rules_.begin(), rules_.end(),
+            [&](const TurnRule& rule)
+            {
+                return vertices.count(rule.fromVertex) > 0 || vertices.count(rule.viaVertex) > 0
+                    || vertices.count(rule.toVertex) > 0
+                    || segments.count({rule.fromVertex, rule.viaVertex}) > 0
+                    || segments.count({rule.viaVertex, rule.toVertex}) > 0;
+            }),
+        rules_.end());
+}
+
+
+MemoryFootprint TurnTable::memoryFootprint() const
+{
+    MemoryFootprint footprint;
+    footprint.add("turn rules", sizeof(*this) + heapBytes(rules_));
+
+    return footprint;
+}
+
@@ -0,0 +1,88 @@
+// TurnTable.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A TurnTable holds the turn restrictions of a RoadMap: turns that are
+// banned outright (e.g., "no left turn"), and turns that cost extra time
+// (e.g., waiting to turn across traffic).  A turn is identified by three
+// vertices: the one the driver arrives from, the one where the turn is
+// made, and the one the driver leaves toward.  Turns without a rule are
+// allowed and free.
+//
+// Rules are attached to the vertex where the turn is made and kept in one
+// sorted array, so the table costs a fixed 16 bytes per rule, however
+// large the RoadMap is, and looking up a turn is a binary search.  Turn
+// costs are only consulted by the turn-aware searches (see
+// Digraph::findTurnAwarePaths()), which expand turns as they go rather
+// than building a separate graph of them.
+
+#ifndef TURNTABLE_HPP
+#define TURNTABLE_HPP
+
+#include <cstddef>
+#include <set>
+#include <utility>
+#include <vector>
+#include "MemoryFootprint.hpp"
+
+
+
+// A TurnRule describes one turn.  Its penalty is the extra driving time
+// the turn takes, in hours, or infinity if the turn is banned.
+
+struct TurnRule
+{
+    int fromVertex;
+    int viaVertex;
+    int toVertex;
+    float penaltyHours;
+};
+
+
+
+class TurnTable
+{
+public:
+    // Initializes an empty TurnTable, in which every turn is allowed.
+    TurnTable() noexcept = default;
+
+    // Initializes a TurnTable with the given rules.  If more than one rule
+    // describes the same turn, the last of them is the one that counts.
+    explicit TurnTable(std::vector<TurnRule> rules);
+
+    // size() returns the number of rules in the table.
+    std::size_t size() const noexcept;
+
+    bool empty() const noexcept;
+
+    // penaltyHours() returns the extra driving time of the given turn:
+    // infinity if it's banned and 0 if there's no rule about it.
+    double penaltyHours(int fromVertex, int viaVertex, int toVertex) const noexcept;
+
+    // isBanned() returns true if the given turn is banned.
+    bool isBanned(int fromVertex, int viaVertex, int toVertex) const noexcept;
+
+    // routePenaltyHours() returns the total penalty of every turn made
+    // along a route visiting the given vertices in order.
+    double routePenaltyHours(const std::vector<int>& vertices) const noexcept;
+
+    // removeRulesOn() removes every rule for a turn onto or off of one of
+    // the given road segments (each given as its "from" and "to" vertex
+    // numbers), or for a turn from, at, or toward one of the given
+    // vertices, in one pass over the rules.
+    void removeRulesOn(const std::set<std::pair<int, int>>& segments, const std::set<int>& vertices);
+
+    // memoryFootprint() returns the bytes that this TurnTable occupies.
+    MemoryFootprint memoryFootprint() const;
+
+private:
+    // The rules, sorted by the vertex the turn is made at, then by the
+    // vertices on either side.
+    std::vector<TurnRule> rules_;
+};
+
+
+
+#endif
+
@@ -0,0 +1,261 @@
+// UnixSocket.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <system_error>
+#include <utility>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "UnixSocket.hpp"
+
+
+namespace
+{
+    [[noreturn]] void throwSystemError(const std::string& what)
+    {
+        throw std::system_error{errno, std::generic_category(), what};
+    }
+
+
+    [[noreturn]] void throwLineTooLong()
+    {
+        throw std::system_error{std::make_error_code(std::errc::message_size), "read: line too long"};
+    }
+
+
+    sockaddr_un addressOf(const std::string& path)
+    {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+
+        if (path.size() >= sizeof(address.sun_path))
+        {
+            throw std::system_error{
+                std::make_error_code(std::errc::filename_too_long), "Socket path " + path};
+        }
+
+        std::strcpy(address.sun_path, path.c_str());
+        return address;
+    }
+
+
+    int newSocket()
+    {
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+
+        if (fd < 0)
+        {
+            throwSystemError("socket");
+        }
+
+        return fd;
+    }
+}
+
+
+UnixSocket::UnixSocket(int fd) noexcept
+    : fd_{fd}, maxLineLength_{std::numeric_limits<std::size_t>::max()}
+{
+}
+
+
+UnixSocket::~UnixSocket() noexcept
+{
+    if (fd_ >= 0)
+    {
+        ::close(fd_);
+    }
+}
+
+
+UnixSocket::UnixSocket(UnixSocket&& other) noexcept
+    : fd_{std::exchange(other.fd_, -1)}, received_{std::move(other.received_)},
+      maxLineLength_{other.maxLineLength_}
+{
+}
+
+
+UnixSocket& UnixSocket::operator=(UnixSocket&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+        }
+
+        fd_ = std::exchange(other.fd_, -1);
+        received_ = std::move(other.received_);
+        maxLineLength_ = other.maxLineLength_;
+    }
+
+    return *this;
+}
+
+
+UnixSocket UnixSocket::connectTo(const std::string& path)
+{
+    UnixSocket socket{newSocket()};
+    sockaddr_un address = addressOf(path);
+
+    if (::connect(socket.fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+    {
+        throwSystemError("connect to " + path);
+    }
+
+    return socket;
+}
+
+
+UnixSocket UnixSocket::listenAt(const std::string& path)
+{
+    UnixSocket socket{newSocket()};
+    sockaddr_un address = addressOf(path);
+
+    ::unlink(path.c_str());
+
+    if (::bind(socket.fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+    {
+        throwSystemError("bind to " + path);
+    }
+
+    if (::listen(socket.fd_, SOMAXCONN) < 0)
+    {
+        throwSystemError("listen on " + path);
+    }
+
+    return socket;
+}
+
+
+std::pair<UnixSocket, UnixSocket> UnixSocket::pair()
+{
+    int fds[2];
+
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0)
+    {
+        throwSystemError("socketpair");
+    }
+
+    return {UnixSocket{fds[0]}, UnixSocket{fds[1]}};
+}
+
+
+UnixSocket UnixSocket::accept()
+{
+    int fd;
+
+    do
+    {
+        fd = ::accept(fd_, nullptr, nullptr);
+    }
+    while (fd < 0 && errno == EINTR);
+
+    if (fd < 0)
+    {
+        throwSystemError("accept");
+    }
+
+    return UnixSocket{fd};
+}
+
+
+int UnixSocket::fd() const noexcept
+{
+    return fd_;
+}
+
+
+void UnixSocket::setMaxLineLength(std::size_t maxLineLength) noexcept
+{
+    maxLineLength_ = maxLineLength;
+}
+
+
+bool UnixSocket::readLines(std::vector<std::string>& lines)
+{
+    char chunk[1 << 16];
+
+    while (received_.find('\n') == std::string::npos)
+    {
+        if (received_.size() > maxLineLength_)
+        {
+            throwLineTooLong();
+        }
+
+        ssize_t count = ::read(fd_, chunk, sizeof(chunk));
+
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else if (count < 0)
+        {
+            throwSystemError("read");
+        }
+        else if (count == 0)
+        {
+            return false;
+        }
+
+        received_.append(chunk, static_cast<std::size_t>(count));
+    }
+
+    std::size_t start = 0;
+    std::size_t newline;
+
+    while ((newline = received_.find('\n', start)) != std::string::npos)
+    {
+        if (newline - start > maxLineLength_)
+        {
+            throwLineTooLong();
+        }
+
+        lines.emplace_back(received_, start, newline - start);
+        start = newline + 1;
+    }
+
+    received_.erase(0, start);
+    return true;
+}
+
+
+void UnixSocket::writeAll(const std::string& bytes)
+{
+    std::size_t written = 0;
+
+    while (written < bytes.size())
+    {
+        // send() keeps a closed peer from raising SIGPIPE, but only works
+        // on sockets; anything else is written to normally.
+        ssize_t count = ::send(fd_, bytes.data() + written, bytes.size() - written, MSG_NOSIGNAL);
+
+        if (count < 0 && errno == ENOTSOCK)
+        {
+            count = ::write(fd_, bytes.data() + written, bytes.size() - written);
+        }
+
+        if (count < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else if (count < 0)
+        {
+            throwSystemError("write");
+        }
+
+        written += static_cast<std::size_t>(count);
+    }
+}
+
+
+void UnixSocket::shutdown() noexcept
+{
+    ::shutdown(fd_, SHUT_RDWR);
+}
+
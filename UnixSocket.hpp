@@ -0,0 +1,89 @@
+// UnixSocket.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A UnixSocket owns one end of a connection over a Unix domain socket (or
+// any other file descriptor that can be read and written, such as one
+// end of a socketpair or a pipe), and sends and receives newline-framed
+// messages over it.  Reads are buffered, so a peer may send many lines
+// at once, and readLines() hands back every complete line that has
+// arrived so far, which is what lets a receiver answer them as a batch.
+//
+// Failures of the underlying system calls are reported by throwing a
+// std::system_error.
+
+#ifndef UNIXSOCKET_HPP
+#define UNIXSOCKET_HPP
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+
+class UnixSocket
+{
+public:
+    // Initializes a UnixSocket that takes ownership of the given open
+    // file descriptor.
+    explicit UnixSocket(int fd) noexcept;
+
+    // The file descriptor is closed when the UnixSocket is destroyed.
+    ~UnixSocket() noexcept;
+
+    UnixSocket(UnixSocket&& other) noexcept;
+    UnixSocket& operator=(UnixSocket&& other) noexcept;
+
+    UnixSocket(const UnixSocket&) = delete;
+    UnixSocket& operator=(const UnixSocket&) = delete;
+
+    // connectTo() returns a UnixSocket connected to the server listening
+    // on the socket at the given path.
+    static UnixSocket connectTo(const std::string& path);
+
+    // listenAt() returns a UnixSocket listening for connections on the
+    // socket at the given path, replacing any stale socket file there.
+    static UnixSocket listenAt(const std::string& path);
+
+    // pair() returns both ends of a new, already connected pair of
+    // sockets, for talking to a child process or another thread.
+    static std::pair<UnixSocket, UnixSocket> pair();
+
+    // accept() waits for the next connection on a listening UnixSocket,
+    // returning it.
+    UnixSocket accept();
+
+    int fd() const noexcept;
+
+    // setMaxLineLength() limits how long a received line can be, so that
+    // a peer that never sends a newline can't make the UnixSocket buffer
+    // without bound.  There is no limit until one is set.
+    void setMaxLineLength(std::size_t maxLineLength) noexcept;
+
+    // readLines() waits until at least one complete line has arrived,
+    // then appends every complete line received so far to the given
+    // vector, without their newlines.  It returns false (and appends
+    // nothing) once the peer has closed the connection.  If a line longer
+    // than the maximum arrives, a std::system_error is thrown instead.
+    bool readLines(std::vector<std::string>& lines);
+
+    // writeAll() sends all of the given bytes, however many writes that
+    // takes.
+    void writeAll(const std::string& bytes);
+
+    // shutdown() stops any further reading or writing, waking up a thread
+    // waiting in readLines() or accept() on another thread.
+    void shutdown() noexcept;
+
+private:
+    int fd_;
+    std::string received_;
+    std::size_t maxLineLength_;
+};
+
+
+
+#endif
+
@@ -0,0 +1,158 @@
+// VersionedRoadMap.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include "VersionedRoadMap.hpp"
+
+
+VersionedRoadMap::VersionedRoadMap(RoadMap roadMap)
+    : current_{std::make_shared<const RoadMapVersion>(RoadMapVersion{0, std::move(roadMap)})}
+{
+}
+
+
+std::shared_ptr<const RoadMapVersion> VersionedRoadMap::snapshot() const
+{
+    return std::atomic_load(&current_);
+}
+
+
+std::uint64_t VersionedRoadMap::applySpeedUpdates(const std::vector<SpeedUpdate>& updates)
+{
+    return applySpeedUpdates(updates, false);
+}
+
+
+std::uint64_t VersionedRoadMap::applyExistingSpeedUpdates(const std::vector<SpeedUpdate>& updates)
+{
+    return applySpeedUpdates(updates, true);
+}
+
+
+std::uint64_t VersionedRoadMap::applySpeedUpdates(const std::vector<SpeedUpdate>& updates, bool skipMissing)
+{
+    std::lock_guard<std::mutex> lock{writerMutex_};
+
+    std::shared_ptr<const RoadMapVersion> current = std::atomic_load(&current_);
+
+    // Readers may be using the current version, so the batch is applied
+    // to a copy that nobody else can see until it's published.
+    auto next = std::make_shared<RoadMapVersion>(RoadMapVersion{current->number + 1, current->roadMap});
+    bool applied = false;
+
+    for (const SpeedUpdate& update : updates)
+    {
+        const RoadSegment* existing = next->roadMap.findEdgeInfo(update.fromVertex, update.toVertex);
+
+        if (existing == nullptr && skipMissing)
+        {
+            continue;
+        }
+
+        RoadSegment segment = existing != nullptr
+            ? *existing
+            : next->roadMap.edgeInfo(update.fromVertex, update.toVertex);
+
+        segment.milesPerHour = update.milesPerHour;
+        next->roadMap.updateEdge(update.fromVertex, update.toVertex, segment);
+        applied = true;
+    }
+
+    if (!applied && skipMissing)
+    {
+        return current->number;
+    }
+
+    std::atomic_store(&current_, std::shared_ptr<const RoadMapVersion>{std::move(next)});
+    return current->number + 1;
+}
+
+
+std::uint64_t VersionedRoadMap::applyDelta(const MapDelta& delta)
+{
+    std::lock_guard<std::mutex> lock{writerMutex_};
+
+    std::shared_ptr<const RoadMapVersion> current = std::atomic_load(&current_);
+
+    auto next = std::make_shared<RoadMapVersion>(RoadMapVersion{current->number + 1, current->roadMap});
+    delta.applyTo(next->roadMap);
+
+    std::atomic_store(&current_, std::shared_ptr<const RoadMapVersion>{std::move(next)});
+    return current->number + 1;
+}
+
+
+SpeedUpdateWriter::SpeedUpdateWriter(VersionedRoadMap& roadMap, std::size_t maxBatchSize)
+    : roadMap_{roadMap}, maxBatchSize_{std::max<std::size_t>(maxBatchSize, 1)},
+      submitted_{0}, published_{0}, stopping_{false},
+      thread_{[this]() { run(); }}
+{
+}
+
+
+SpeedUpdateWriter::~SpeedUpdateWriter() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        stopping_ = true;
+    }
+
+    changed_.notify_all();
+    thread_.join();
+}
+
+
+void SpeedUpdateWriter::submit(const SpeedUpdate& update)
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        pending_.push_back(update);
+        submitted_++;
+    }
+
+    changed_.notify_all();
+}
+
+
+void SpeedUpdateWriter::flush()
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+    std::uint64_t target = submitted_;
+    changed_.wait(lock, [&]() { return published_ >= target; });
+}
+
+
+void SpeedUpdateWriter::run()
+{
+    std::unique_lock<std::mutex> lock{mutex_};
+
+    while (true)
+    {
+        changed_.wait(lock, [this]() { return stopping_ || !pending_.empty(); });
+
+        if (pending_.empty())
+        {
+            return;
+        }
+
+        std::size_t count = std::min(pending_.size(), maxBatchSize_);
+        std::vector<SpeedUpdate> batch(pending_.begin(), pending_.begin() + count);
+        pending_.erase(pending_.begin(), pending_.begin() + count);
+
+        lock.unlock();
+
+        // A bad update shouldn't cost the rest of its batch, so only the
+        // updates that name road segments existing at the time are
+        // published.
+        roadMap_.applyExistingSpeedUpdates(batch);
+
+        lock.lock();
+        published_ += count;
+        changed_.notify_all();
+    }
+}
+
@@ -0,0 +1,141 @@
+// VersionedRoadMap.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A VersionedRoadMap lets trip queries and traffic updates run at the
+// same time.  Queries call snapshot() to get an immutable version of the
+// RoadMap that stays valid (and unchanged) for as long as they hold on to
+// it, without ever waiting on a writer.  Writers apply whole batches of
+// speed updates to a private copy of the current version and then publish
+// that copy as the next version in a single atomic step; older versions
+// are freed once the last query holding them lets go.
+//
+// A SpeedUpdateWriter runs that writer side on a background thread,
+// gathering the updates handed to it into batches.
+
+#ifndef VERSIONEDROADMAP_HPP
+#define VERSIONEDROADMAP_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "MapDelta.hpp"
+#include "RoadMap.hpp"
+
+
+
+// A SpeedUpdate sets the current speed of traffic on one road segment.
+
+struct SpeedUpdate
+{
+    int fromVertex;
+    int toVertex;
+    double milesPerHour;
+};
+
+
+
+// A RoadMapVersion is one published, immutable state of the RoadMap,
+// numbered in the order the versions were published.
+
+struct RoadMapVersion
+{
+    std::uint64_t number;
+    RoadMap roadMap;
+};
+
+
+
+class VersionedRoadMap
+{
+public:
+    // Initializes a VersionedRoadMap whose first version (numbered 0) is
+    // the given RoadMap.
+    explicit VersionedRoadMap(RoadMap roadMap);
+
+    // snapshot() returns the most recently published version.  It can be
+    // called from any number of threads at once and never blocks behind
+    // applySpeedUpdates().
+    std::shared_ptr<const RoadMapVersion> snapshot() const;
+
+    // applySpeedUpdates() publishes a new version in which every one of
+    // the given updates has been applied, and returns its number.  Calls
+    // from different threads are applied one batch at a time.  If any
+    // update names a road segment that does not exist, a DigraphException
+    // is thrown and nothing is published.
+    std::uint64_t applySpeedUpdates(const std::vector<SpeedUpdate>& updates);
+
+    // applyExistingSpeedUpdates() is like applySpeedUpdates(), except that
+    // updates naming a road segment that doesn't exist are skipped rather
+    // than failing the whole batch.  Segments are looked up in the version
+    // being replaced, under the same lock as applyDelta(), so a segment
+    // that a delta removes in the meantime is skipped too.  If every
+    // update is skipped, nothing is published and the current version's
+    // number is returned.
+    std::uint64_t applyExistingSpeedUpdates(const std::vector<SpeedUpdate>& updates);
+
+    // applyDelta() publishes a new version in which the given MapDelta has
+    // been applied, and returns its number.  If the delta can't be applied,
+    // a DigraphException is thrown and nothing is published.
+    std::uint64_t applyDelta(const MapDelta& delta);
+
+private:
+    std::uint64_t applySpeedUpdates(const std::vector<SpeedUpdate>& updates, bool skipMissing);
+
+    // Only ever read and replaced through std::atomic_load() and
+    // std::atomic_store(), so readers and the writer never race on it.
+    std::shared_ptr<const RoadMapVersion> current_;
+
+    std::mutex writerMutex_;
+};
+
+
+
+class SpeedUpdateWriter
+{
+public:
+    // Initializes a SpeedUpdateWriter that applies updates to the given
+    // VersionedRoadMap on its own thread, publishing at most maxBatchSize
+    // updates per version.
+    SpeedUpdateWriter(VersionedRoadMap& roadMap, std::size_t maxBatchSize);
+
+    // The destructor publishes any updates still waiting and then stops
+    // the writer thread.
+    ~SpeedUpdateWriter() noexcept;
+
+    SpeedUpdateWriter(const SpeedUpdateWriter&) = delete;
+    SpeedUpdateWriter& operator=(const SpeedUpdateWriter&) = delete;
+
+    // submit() hands an update to the writer thread and returns right
+    // away; it will be visible in some later version.  Updates naming a
+    // road segment that does not exist when they're applied are dropped,
+    // without affecting the rest of their batch.
+    void submit(const SpeedUpdate& update);
+
+    // flush() waits until every update submitted so far is published.
+    void flush();
+
+private:
+    void run();
+
+    VersionedRoadMap& roadMap_;
+    std::size_t maxBatchSize_;
+
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    std::vector<SpeedUpdate> pending_;
+    std::uint64_t submitted_;
+    std::uint64_t published_;
+    bool stopping_;
+
+    std::thread thread_;
+};
+
+
+
+#endif
+
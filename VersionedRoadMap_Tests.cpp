@@ -0,0 +1,196 @@
+// VersionedRoadMap_Tests.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// Unit tests for VersionedRoadMap and SpeedUpdateWriter, checking that
+// snapshots never change underneath the queries holding them and that
+// the writer thread publishes every good update it's handed, even while
+// deltas are editing the map underneath it.
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include "MapDelta.hpp"
+#include "VersionedRoadMap.hpp"
+
+
+namespace
+{
+    RoadMap makeLine()
+    {
+        RoadMap roadMap;
+
+        for (int i = 0; i < 3; ++i)
+        {
+            roadMap.addVertex(i, "Location");
+        }
+
+        roadMap.addEdge(0, 1, RoadSegment{1.0, 10.0});
+        roadMap.addEdge(1, 2, RoadSegment{1.0, 10.0});
+
+        return roadMap;
+    }
+}
+
+
+TEST(VersionedRoadMap_Tests, snapshotsStayUnchangedWhileWriterPublishes)
+{
+    VersionedRoadMap roadMap{makeLine()};
+    std::shared_ptr<const RoadMapVersion> first = roadMap.snapshot();
+
+    constexpr int versions = 200;
+    std::atomic<bool> torn{false};
+
+    // Every batch sets both segments to the same speed, so a snapshot
+    // that ever shows them differing has seen half of a batch.
+    std::thread reader{
+        [&]()
+        {
+            std::uint64_t last = 0;
+
+            while (last < versions)
+            {
+                std::shared_ptr<const RoadMapVersion> version = roadMap.snapshot();
+
+                if (version->number < last
+                    || version->roadMap.edgeInfo(0, 1).milesPerHour
+                       != version->roadMap.edgeInfo(1, 2).milesPerHour)
+                {
+                    torn = true;
+                }
+
+                last = version->number;
+            }
+        }};
+
+    for (int i = 1; i <= versions; ++i)
+    {
+        double speed = 10.0 + i;
+        ASSERT_EQ(i, roadMap.applySpeedUpdates({{0, 1, speed}, {1, 2, speed}}));
+    }
+
+    reader.join();
+
+    ASSERT_FALSE(torn);
+    ASSERT_EQ(0, first->number);
+    ASSERT_DOUBLE_EQ(10.0, first->roadMap.edgeInfo(0, 1).milesPerHour);
+    ASSERT_DOUBLE_EQ(10.0 + versions, roadMap.snapshot()->roadMap.edgeInfo(1, 2).milesPerHour);
+}
+
+
+TEST(VersionedRoadMap_Tests, badUpdatePublishesNothing)
+{
+    VersionedRoadMap roadMap{makeLine()};
+
+    ASSERT_THROW(roadMap.applySpeedUpdates({{0, 1, 30.0}, {0, 2, 30.0}}), DigraphException);
+
+    std::shared_ptr<const RoadMapVersion> version = roadMap.snapshot();
+    ASSERT_EQ(0, version->number);
+    ASSERT_DOUBLE_EQ(10.0, version->roadMap.edgeInfo(0, 1).milesPerHour);
+}
+
+
+
+TEST(VersionedRoadMap_Tests, existingUpdatesSkipMissingSegments)
+{
+    VersionedRoadMap roadMap{makeLine()};
+
+    ASSERT_EQ(1, roadMap.applyExistingSpeedUpdates({{0, 1, 30.0}, {0, 2, 30.0}, {7, 8, 30.0}}));
+
+    std::shared_ptr<const RoadMapVersion> version = roadMap.snapshot();
+    ASSERT_DOUBLE_EQ(30.0, version->roadMap.edgeInfo(0, 1).milesPerHour);
+    ASSERT_FALSE(version->roadMap.findEdgeInfo(0, 2));
+
+    // A batch with nothing left to apply doesn't publish a new version.
+    ASSERT_EQ(1, roadMap.applyExistingSpeedUpdates({{0, 2, 40.0}}));
+    ASSERT_EQ(version, roadMap.snapshot());
+}
+
+TEST(VersionedRoadMap_Tests, writerBatchesUpdatesAndFlushWaitsForThem)
+{
+    VersionedRoadMap roadMap{makeLine()};
+
+    {
+        SpeedUpdateWriter writer{roadMap, 3};
+
+        for (int i = 1; i <= 7; ++i)
+        {
+            writer.submit(SpeedUpdate{i % 2, i % 2 + 1, 10.0 + i});
+        }
+
+        writer.flush();
+
+        // How the updates fall into batches depends on when the writer
+        // thread wakes up, but no batch holds more than three of them.
+        std::shared_ptr<const RoadMapVersion> version = roadMap.snapshot();
+        ASSERT_LE(3, version->number);
+        ASSERT_GE(7, version->number);
+        ASSERT_DOUBLE_EQ(16.0, version->roadMap.edgeInfo(0, 1).milesPerHour);
+        ASSERT_DOUBLE_EQ(17.0, version->roadMap.edgeInfo(1, 2).milesPerHour);
+
+        writer.submit(SpeedUpdate{0, 1, 50.0});
+    }
+
+    // The destructor publishes whatever is still waiting.
+    ASSERT_DOUBLE_EQ(50.0, roadMap.snapshot()->roadMap.edgeInfo(0, 1).milesPerHour);
+}
+
+
+TEST(VersionedRoadMap_Tests, writerDropsBadUpdateButKeepsRestOfBatch)
+{
+    VersionedRoadMap roadMap{makeLine()};
+    SpeedUpdateWriter writer{roadMap, 10};
+
+    writer.submit(SpeedUpdate{0, 1, 20.0});
+    writer.submit(SpeedUpdate{0, 2, 30.0});
+    writer.submit(SpeedUpdate{7, 8, 30.0});
+    writer.submit(SpeedUpdate{1, 2, 40.0});
+    writer.flush();
+
+    std::shared_ptr<const RoadMapVersion> version = roadMap.snapshot();
+    ASSERT_LE(1, version->number);
+    ASSERT_DOUBLE_EQ(20.0, version->roadMap.edgeInfo(0, 1).milesPerHour);
+    ASSERT_DOUBLE_EQ(40.0, version->roadMap.edgeInfo(1, 2).milesPerHour);
+    ASSERT_FALSE(version->roadMap.findEdgeInfo(0, 2));
+}
+
+
+TEST(VersionedRoadMap_Tests, writerSkipsSegmentsRemovedByConcurrentDeltas)
+{
+    VersionedRoadMap roadMap{makeLine()};
+    SpeedUpdateWriter writer{roadMap, 4};
+
+    MapDelta removeEdge{{MapEdit{MapEditKind::RemoveEdge, 0, 1}}};
+    MapDelta addEdge{{MapEdit{MapEditKind::AddEdge, 0, 1, "", RoadSegment{1.0, 10.0}}}};
+
+    constexpr int rounds = 500;
+
+    // The segment from 0 to 1 keeps disappearing and coming back, so
+    // some of the writer's updates to it name a segment that is gone by
+    // the time their batch is applied.
+    std::thread editor{
+        [&]()
+        {
+            for (int i = 0; i < rounds; ++i)
+            {
+                roadMap.applyDelta(removeEdge);
+                roadMap.applyDelta(addEdge);
+            }
+        }};
+
+    for (int i = 1; i <= rounds; ++i)
+    {
+        writer.submit(SpeedUpdate{0, 1, 10.0 + i});
+        writer.submit(SpeedUpdate{1, 2, 10.0 + i});
+    }
+
+    editor.join();
+    writer.flush();
+
+    std::shared_ptr<const RoadMapVersion> version = roadMap.snapshot();
+    ASSERT_TRUE(version->roadMap.findEdgeInfo(0, 1));
+    ASSERT_DOUBLE_EQ(10.0 + rounds, version->roadMap.edgeInfo(1, 2).milesPerHour);
+}
@@ -0,0 +1,113 @@
+// WorkerPool.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+
+#include <algorithm>
+#include <system_error>
+#include <utility>
+#include "WorkerPool.hpp"
+
+
+WorkerPool::WorkerPool(unsigned int threadCount)
+    : stopping_{false}
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (unsigned int i = 0; i < threadCount; ++i)
+    {
+        threads_.emplace_back([this]() { work(); });
+    }
+}
+
+
+WorkerPool::WorkerPool(unsigned int threadCount, const NumaTopology& topology)
+    : stopping_{false}
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (unsigned int i = 0; i < threadCount; ++i)
+    {
+        threads_.emplace_back(
+            [this, topology, node = static_cast<int>(i % topology.nodeCount())]()
+            {
+                // Pinning only affects where the thread runs, so a thread
+                // that can't be pinned is still perfectly able to work.
+                try
+                {
+                    topology.pinCurrentThread(node);
+                }
+                catch (const std::system_error&)
+                {
+                }
+
+                work();
+            });
+    }
+}
+
+
+WorkerPool::~WorkerPool() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        stopping_ = true;
+    }
+
+    available_.notify_all();
+
+    for (std::thread& thread : threads_)
+    {
+        thread.join();
+    }
+}
+
+
+unsigned int WorkerPool::threadCount() const noexcept
+{
+    return static_cast<unsigned int>(threads_.size());
+}
+
+
+void WorkerPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        tasks_.push_back(std::move(task));
+    }
+
+    available_.notify_one();
+}
+
+
+void WorkerPool::work()
+{
+    while (true)
+    {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock{mutex_};
+            available_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+
+            // Even when stopping, the tasks already queued are finished
+            // first.
+            if (tasks_.empty())
+            {
+                return;
+            }
+
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+
+        task();
+    }
+}
+
@@ -0,0 +1,65 @@
+// WorkerPool.hpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// A WorkerPool is a fixed set of threads that run tasks handed to it,
+// in the order they were submitted, each on whichever thread is free
+// first.  Tasks must not throw; anything that can fail should catch its
+// own exceptions and report them some other way (e.g., via a promise).
+//
+// Given a NumaTopology, a WorkerPool spreads its threads evenly across
+// the NUMA nodes, pinning each thread to its node.
+
+#ifndef WORKERPOOL_HPP
+#define WORKERPOOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "NumaTopology.hpp"
+
+
+
+class WorkerPool
+{
+public:
+    // Initializes a WorkerPool with the given number of threads (a
+    // threadCount of 0 means one thread per core).
+    explicit WorkerPool(unsigned int threadCount);
+
+    // Initializes a WorkerPool with the given number of threads (0 again
+    // meaning one per core), thread i being pinned to node i modulo the
+    // number of nodes.  A thread that can't be pinned runs unpinned.
+    WorkerPool(unsigned int threadCount, const NumaTopology& topology);
+
+    // Destroying a WorkerPool waits for every task already submitted to
+    // finish.
+    ~WorkerPool() noexcept;
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    unsigned int threadCount() const noexcept;
+
+    // submit() queues a task to be run by one of the threads.
+    void submit(std::function<void()> task);
+
+private:
+    void work();
+
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;
+    std::condition_variable available_;
+    std::deque<std::function<void()>> tasks_;
+    bool stopping_;
+};
+
+
+
+#endif
+
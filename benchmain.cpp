@@ -0,0 +1,692 @@
+// benchmain.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// This is the main() function for the benchmark driver, which measures
+// how long the program's main operations take on synthetic road maps
+// produced by a MapGenerator.  It can be run in two ways:
+//
+//     benchmain generate SHAPE VERTICES [SEED]
+//         writes a map to the standard output, in the format read by
+//         RoadMapReader, so it can be fed to the main program
+//
+//     benchmain run SHAPE VERTICES [TRIPS] [SEED]
+//         times loading and building the map, applying a delta of map
+//         edits, one-to-all searches, point-to-point searches, and
+//         planning a batch of trips, then reports the throughput and
+//         latencies of each; one-to-all searches are also timed with
+//         delta-stepping on increasing numbers of threads against the
+//         sequential compact search, and many-source distance tables
+//         are timed with PHAST sweeps over a contraction hierarchy
+//         against repeated searches; it finishes by comparing threads pinned
+//         across the NUMA nodes reading one shared copy of the map
+//         against each reading a copy on its own node, and compact
+//         searches with and without huge pages
+//
+// SHAPE is one of grid, geometric, or highway.
+//
+// Every allocation the program makes is reported to the AllocationTracker,
+// so "run" can also report how much memory the map and its compact
+// snapshot actually take, next to their estimated memory footprints.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "AllocationTracker.hpp"
+#include "CompactDigraph.hpp"
+#include "ContractionHierarchy.hpp"
+#include "DeltaStepping.hpp"
+#include "InputReader.hpp"
+#include "LocationIndex.hpp"
+#include "MapDelta.hpp"
+#include "MapGenerator.hpp"
+#include "NumaReplicas.hpp"
+#include "Phast.hpp"
+#include "RoadMapReader.hpp"
+#include "RouteWriter.hpp"
+#include "TripPlanner.hpp"
+
+
+// Each allocation is preceded by a header recording its size, so that the
+// tracker can be told how much is being freed.  The size reported is what
+// the heap sets aside for the block, to be comparable with the estimates
+// made by memoryFootprint().  (GCC is kept from inlining the replacements
+// into their callers, where it would mistake them for mismatched calls.)
+namespace
+{
+    constexpr std::size_t allocationHeader = 16;
+}
+
+#if defined(__GNUC__)
+#define TRACKING_NOINLINE __attribute__((noinline))
+#else
+#define TRACKING_NOINLINE
+#endif
+
+
+TRACKING_NOINLINE void* operator new(std::size_t size)
+{
+    void* block = std::malloc(size + allocationHeader);
+
+    if (block == nullptr)
+    {
+        throw std::bad_alloc{};
+    }
+
+    *static_cast<std::size_t*>(block) = size;
+    AllocationTracker::allocated(heapBlockBytes(size));
+
+    return static_cast<char*>(block) + allocationHeader;
+}
+
+
+TRACKING_NOINLINE void operator delete(void* p) noexcept
+{
+    if (p != nullptr)
+    {
+        void* block = static_cast<char*>(p) - allocationHeader;
+
+        AllocationTracker::deallocated(heapBlockBytes(*static_cast<std::size_t*>(block)));
+        std::free(block);
+    }
+}
+
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    operator delete(p);
+}
+
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+
+    double secondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+
+    // report() prints one line of results for a benchmark whose individual
+    // operations took the given number of seconds each.
+    void report(const std::string& name, std::vector<double> seconds)
+    {
+        if (seconds.empty())
+        {
+            return;
+        }
+
+        std::sort(seconds.begin(), seconds.end());
+
+        double total = 0.0;
+
+        for (double s : seconds)
+        {
+            total += s;
+        }
+
+        auto percentile = [&](double p)
+        {
+            return seconds[static_cast<std::size_t>(p * (seconds.size() - 1))] * 1000.0;
+        };
+
+        std::cout << std::left << std::setw(22) << name << std::right << std::fixed
+            << std::setw(8) << seconds.size() << " ops"
+            << std::setw(12) << std::setprecision(1) << seconds.size() / total << " ops/s"
+            << "   mean " << std::setprecision(3) << total / seconds.size() * 1000.0 << " ms"
+            << "   p50 " << percentile(0.50) << " ms"
+            << "   p99 " << percentile(0.99) << " ms"
+            << std::endl;
+    }
+
+
+    // reportMemory() prints a memory footprint, with the bytes actually
+    // allocated while building the structure it describes.
+    void reportMemory(const std::string& name, const MemoryFootprint& footprint, std::size_t allocatedBytes)
+    {
+        auto mb = [](std::size_t bytes)
+        {
+            return bytes / (1024.0 * 1024.0);
+        };
+
+        std::cout << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(2)
+            << std::setw(10) << mb(footprint.total()) << " MB estimated"
+            << std::setw(10) << mb(allocatedBytes) << " MB allocated" << std::endl;
+
+        for (const auto& component : footprint.components)
+        {
+            std::cout << "  " << std::left << std::setw(20) << component.first << std::right
+                << std::setw(10) << mb(component.second) << " MB" << std::endl;
+        }
+    }
+
+
+    // runPinned() runs work(i) on each of threadCount threads, thread i
+    // pinned to node i modulo the number of nodes, and returns how many
+    // seconds they took altogether.
+    double runPinned(
+        const NumaTopology& topology, unsigned int threadCount,
+        const std::function<void(unsigned int)>& work)
+    {
+        std::vector<std::thread> threads;
+        Clock::time_point start = Clock::now();
+
+        for (unsigned int t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back(
+                [&, t]()
+                {
+                    try
+                    {
+                        topology.pinCurrentThread(static_cast<int>(t % topology.nodeCount()));
+                    }
+                    catch (const std::system_error&)
+                    {
+                    }
+
+                    work(t);
+                });
+        }
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        return secondsSince(start);
+    }
+
+
+    // compareLayouts() plans the given trips, and runs one-to-all compact
+    // searches, on threads pinned across the NUMA nodes, first with every
+    // thread reading the same copy of the map and then with each reading
+    // a copy on its own node.
+    void compareLayouts(const RoadMap& roadMap, const CompactDigraph& compact, const std::vector<Trip>& trips)
+    {
+        NumaTopology topology = NumaTopology::detect();
+        unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+        std::cout << "  " << topology.nodeCount() << " NUMA node(s), "
+            << threadCount << " pinned threads" << std::endl;
+
+        auto planShares = [&](const std::function<const RoadMap&()>& roadMapFor)
+        {
+            return runPinned(
+                topology, threadCount,
+                [&](unsigned int t)
+                {
+                    std::vector<Trip> share;
+
+                    for (std::size_t i = t; i < trips.size(); i += threadCount)
+                    {
+                        share.push_back(trips[i]);
+                    }
+
+                    TripPlanner{}.planTrips(roadMapFor(), share);
+                });
+        };
+
+        // Each thread runs the same handful of one-to-all searches, so
+        // the total is the same however many threads there are.
+        auto searchShares = [&](const std::function<const CompactDigraph&()>& compactFor)
+        {
+            return runPinned(
+                topology, threadCount,
+                [&](unsigned int t)
+                {
+                    std::vector<double> distances;
+                    std::vector<int> parents;
+
+                    for (std::size_t i = t; i < trips.size() && i < 10; i += threadCount)
+                    {
+                        const CompactDigraph& graph = compactFor();
+                        graph.findDistances(graph.indexOf(trips[i].startVertex), distances, parents);
+                    }
+                });
+        };
+
+        double seconds = planShares([&]() -> const RoadMap& { return roadMap; });
+        report("shared map trips", {seconds});
+        std::cout << "  " << std::setprecision(1) << trips.size() / seconds << " trips/s" << std::endl;
+
+        std::size_t before = AllocationTracker::counts().currentBytes;
+        Clock::time_point start = Clock::now();
+        NumaReplicas<RoadMap> replicas{topology, [&]() { return roadMap.detachedCopy(); }};
+        report("map replication", {secondsSince(start)});
+        std::cout << "  " << std::setprecision(2)
+            << (AllocationTracker::counts().currentBytes - before) / (1024.0 * 1024.0)
+            << " MB for " << topology.nodeCount() << " replica(s)" << std::endl;
+
+        seconds = planShares([&]() -> const RoadMap& { return replicas.local(); });
+        report("replicated map trips", {seconds});
+        std::cout << "  " << std::setprecision(1) << trips.size() / seconds << " trips/s" << std::endl;
+
+        auto weight = TripPlanner::edgeWeightFor(TripMetric::Distance);
+        NumaReplicas<CompactDigraph> normalPages{topology, [&]() { return CompactDigraph{roadMap, weight}; }};
+        NumaReplicas<CompactDigraph> hugePages{topology, [&]() { return CompactDigraph{roadMap, weight, true}; }};
+
+        report("shared compact", {searchShares([&]() -> const CompactDigraph& { return compact; })});
+        report("replicated compact", {searchShares([&]() -> const CompactDigraph& { return normalPages.local(); })});
+        report("  with huge pages", {searchShares([&]() -> const CompactDigraph& { return hugePages.local(); })});
+    }
+
+
+    // compareDeltaStepping() times one-to-all searches from the starts of
+    // the first few trips, first with the sequential compact search and
+    // then with delta-stepping on 1, 2, 4, ... threads up to the number
+    // of cores, reporting each one's speedup over the sequential search.
+    void compareDeltaStepping(const CompactDigraph& compact, const std::vector<Trip>& trips)
+    {
+        double totalWeight = 0.0;
+
+        for (std::size_t e = 0; e < compact.edgeCount(); ++e)
+        {
+            totalWeight += compact.edgeWeight(e);
+        }
+
+        double bucketWidth = totalWeight / std::max<std::size_t>(compact.edgeCount(), 1);
+
+        if (!(bucketWidth > 0.0))
+        {
+            return;
+        }
+
+        std::vector<double> distances;
+        std::vector<int> parents;
+
+        auto timeSearches = [&](const std::function<void(int)>& search)
+        {
+            std::vector<double> seconds;
+
+            for (std::size_t i = 0; i < trips.size() && i < 10; ++i)
+            {
+                Clock::time_point start = Clock::now();
+                search(compact.indexOf(trips[i].startVertex));
+                seconds.push_back(secondsSince(start));
+            }
+
+            return seconds;
+        };
+
+        auto mean = [](const std::vector<double>& seconds)
+        {
+            double total = 0.0;
+
+            for (double s : seconds)
+            {
+                total += s;
+            }
+
+            return total / std::max<std::size_t>(seconds.size(), 1);
+        };
+
+        std::vector<double> sequential = timeSearches(
+            [&](int startIndex) { compact.findDistances(startIndex, distances, parents); });
+
+        report("compact one-to-all", sequential);
+
+        unsigned int coreCount = std::max(1u, std::thread::hardware_concurrency());
+
+        for (unsigned int threads = 1; ; threads = std::min(threads * 2, coreCount))
+        {
+            DeltaStepping search{bucketWidth, threads};
+
+            std::vector<double> seconds = timeSearches(
+                [&](int startIndex) { search.findDistances(compact, startIndex, distances, parents); });
+
+            report("delta-stepping x" + std::to_string(threads), seconds);
+            std::cout << "  " << std::setprecision(2) << mean(sequential) / mean(seconds)
+                << "x the compact search's speed" << std::endl;
+
+            if (threads == coreCount)
+            {
+                break;
+            }
+        }
+    }
+
+
+    // comparePhast() times building a contraction hierarchy over the
+    // given compact graph, then computes the distances from the starts of
+    // the first few trips three ways: one compact search per source, one
+    // PHAST sweep per source, and PHAST sweeps serving Phast::lanes
+    // sources each.  Each is reported as seconds per source, so that the
+    // hierarchy's cost can be weighed against what it saves per source.
+    void comparePhast(const CompactDigraph& compact, const std::vector<Trip>& trips)
+    {
+        std::size_t before = AllocationTracker::counts().currentBytes;
+        Clock::time_point start = Clock::now();
+        ContractionHierarchy hierarchy{compact};
+        double buildSeconds = secondsSince(start);
+        std::size_t hierarchyBytes = AllocationTracker::counts().currentBytes - before;
+
+        report("hierarchy build", {buildSeconds});
+        std::cout << "  " << hierarchy.shortcutCount() << " shortcuts" << std::endl;
+        reportMemory("ContractionHierarchy", hierarchy.memoryFootprint(), hierarchyBytes + sizeof(ContractionHierarchy));
+
+        std::vector<int> sources;
+
+        for (std::size_t i = 0; i < trips.size() && i < 4 * Phast::lanes; ++i)
+        {
+            sources.push_back(compact.indexOf(trips[i].startVertex));
+        }
+
+        if (sources.empty())
+        {
+            return;
+        }
+
+        Phast phast{hierarchy};
+        std::vector<double> distances;
+        std::vector<int> parents;
+        std::vector<double> seconds;
+
+        for (int source : sources)
+        {
+            start = Clock::now();
+            compact.findDistances(source, distances, parents);
+            seconds.push_back(secondsSince(start));
+        }
+
+        report("repeated one-to-all", seconds);
+        double searchTotal = 0.0;
+
+        for (double s : seconds)
+        {
+            searchTotal += s;
+        }
+
+        seconds.clear();
+
+        for (int source : sources)
+        {
+            start = Clock::now();
+            phast.distancesFrom(source);
+            seconds.push_back(secondsSince(start));
+        }
+
+        report("phast sweep", seconds);
+        seconds.clear();
+
+        // Each batch's time is spread evenly over the sources it served.
+        double batchTotal = 0.0;
+
+        for (std::size_t first = 0; first < sources.size(); first += Phast::lanes)
+        {
+            std::size_t last = std::min(first + Phast::lanes, sources.size());
+            std::vector<int> batch(sources.begin() + first, sources.begin() + last);
+
+            start = Clock::now();
+            phast.distancesFrom(batch);
+            double batchSeconds = secondsSince(start);
+
+            batchTotal += batchSeconds;
+            seconds.insert(seconds.end(), batch.size(), batchSeconds / batch.size());
+        }
+
+        report("phast x" + std::to_string(Phast::lanes) + " per source", seconds);
+
+        double savedPerSource = (searchTotal - batchTotal) / sources.size();
+
+        std::cout << "  " << std::setprecision(2) << searchTotal / batchTotal
+            << "x the repeated searches' speed";
+
+        if (savedPerSource > 0.0)
+        {
+            std::cout << "; the hierarchy pays for itself after "
+                << static_cast<std::size_t>(std::ceil(buildSeconds / savedPerSource)) << " sources";
+        }
+
+        std::cout << std::endl;
+    }
+
+
+    int generate(MapShape shape, int vertexCount, std::uint64_t seed)
+    {
+        MapGenerator generator{shape, vertexCount, seed};
+        generator.writeRoadMap(std::cout);
+        return 0;
+    }
+
+
+    int run(MapShape shape, int vertexCount, int tripCount, std::uint64_t seed)
+    {
+        MapGenerator generator{shape, vertexCount, seed};
+
+        std::stringstream text;
+        generator.writeRoadMap(text);
+
+        Clock::time_point start = Clock::now();
+        InputReader in{text};
+        RoadMap roadMap = RoadMapReader{}.readRoadMap(in);
+        report("map load", {secondsSince(start)});
+
+        std::size_t before = AllocationTracker::counts().currentBytes;
+        start = Clock::now();
+        RoadMap built = generator.buildRoadMap();
+        report("graph construction", {secondsSince(start)});
+        std::size_t roadMapBytes = AllocationTracker::counts().currentBytes - before;
+
+        std::cout << "  " << built.vertexCount() << " vertices, "
+            << built.edgeCount() << " edges" << std::endl;
+
+        before = AllocationTracker::counts().currentBytes;
+        CompactDigraph compact{built, TripPlanner::edgeWeightFor(TripMetric::Distance)};
+        std::size_t compactBytes = AllocationTracker::counts().currentBytes - before;
+
+        // The RoadMap itself lives on the stack, so its own size is added
+        // to what was allocated for it; likewise the CompactDigraph.
+        reportMemory("RoadMap", roadMapFootprint(built), roadMapBytes + sizeof(RoadMap));
+        reportMemory("CompactDigraph", compact.memoryFootprint(), compactBytes + sizeof(CompactDigraph));
+
+        // A copy shares everything with the original until one of them
+        // changes, and then only the touched vertex is copied.
+        start = Clock::now();
+        RoadMap scenario = built;
+        report("snapshot copy", {secondsSince(start)});
+
+        std::pair<int, int> closed = built.edges().front();
+        before = AllocationTracker::counts().currentBytes;
+        scenario.removeEdge(closed.first, closed.second);
+        std::cout << "  first change to the copy allocated "
+            << AllocationTracker::counts().currentBytes - before << " bytes" << std::endl;
+
+        before = AllocationTracker::counts().currentBytes;
+        start = Clock::now();
+        LocationIndex locations{built};
+        report("location index", {secondsSince(start)});
+        std::size_t locationBytes = AllocationTracker::counts().currentBytes - before;
+
+        reportMemory("LocationIndex", locations.memoryFootprint(), locationBytes + sizeof(LocationIndex));
+
+        // The index shares the RoadMap's pool of names rather than copying
+        // them, so it costs only its own tables on top of the map.
+        double locationCount = std::max(built.vertexCount(), 1);
+        std::cout << "  adds " << std::setprecision(1)
+            << (locationBytes + sizeof(LocationIndex)) / locationCount
+            << " bytes per location to the RoadMap's "
+            << (roadMapBytes + sizeof(RoadMap)) / locationCount << " (+"
+            << 100.0 * (locationBytes + sizeof(LocationIndex)) / (roadMapBytes + sizeof(RoadMap))
+            << "%)" << std::endl;
+
+        // Lookups take nanoseconds, too little to time one at a time, so
+        // a whole pass over the map's names is timed at once.
+        std::vector<std::string> names;
+
+        for (int vertex : built.vertices())
+        {
+            names.emplace_back(locations.nameOf(vertex));
+        }
+
+        std::size_t resolved = 0;
+        start = Clock::now();
+
+        for (const std::string& name : names)
+        {
+            resolved += locations.findVertex(name).has_value() ? 1 : 0;
+        }
+
+        double lookupSeconds = secondsSince(start);
+
+        std::cout << "  " << resolved << " of " << names.size() << " names resolved, "
+            << std::setprecision(1) << lookupSeconds / std::max<std::size_t>(names.size(), 1) * 1e9
+            << " ns each" << std::endl;
+
+        // A day's worth of map edits: new locations joined to the map,
+        // closed roads, and new speeds.  Applying them should take time
+        // proportional to the edits, not to the map, unlike "map load".
+        std::vector<std::pair<int, int>> edges = built.edges();
+        std::vector<MapEdit> edits;
+        int newVertex = built.vertices().back() + 1;
+        std::size_t editCount = std::min<std::size_t>(100, edges.size() / 3);
+
+        for (std::size_t i = 0; i < editCount; ++i)
+        {
+            int joined = edges[i].first;
+
+            edits.push_back(MapEdit{MapEditKind::AddVertex, newVertex, 0, "New Location " + std::to_string(i)});
+            edits.push_back(MapEdit{MapEditKind::AddEdge, newVertex, joined, {}, RoadSegment{0.5, 25.0}});
+            edits.push_back(MapEdit{MapEditKind::AddEdge, joined, newVertex, {}, RoadSegment{0.5, 25.0}});
+            edits.push_back(MapEdit{MapEditKind::RemoveEdge, edges[editCount + i].first, edges[editCount + i].second});
+            edits.push_back(MapEdit{MapEditKind::SetSpeed, edges[2 * editCount + i].first, edges[2 * editCount + i].second, {}, RoadSegment{0.0, 15.0}});
+            newVertex++;
+        }
+
+        MapDelta delta{std::move(edits)};
+        RoadMap edited = built;
+        LocationIndex editedLocations = locations;
+
+        start = Clock::now();
+        delta.applyTo(edited, editedLocations);
+        report("map delta", {secondsSince(start)});
+
+        std::cout << "  " << delta.edits().size() << " edits, now "
+            << edited.vertexCount() << " vertices and " << edited.edgeCount() << " edges" << std::endl;
+
+        std::vector<Trip> trips = generator.randomTrips(tripCount);
+        auto weight = TripPlanner::edgeWeightFor(TripMetric::Distance);
+
+        // A one-to-all search visits the whole map, so only a handful of
+        // them are run, however many trips were asked for.
+        std::vector<double> seconds;
+
+        for (std::size_t i = 0; i < trips.size() && i < 10; ++i)
+        {
+            start = Clock::now();
+            roadMap.findShortestPaths(trips[i].startVertex, weight);
+            seconds.push_back(secondsSince(start));
+        }
+
+        report("one-to-all search", seconds);
+        seconds.clear();
+
+        compareDeltaStepping(compact, trips);
+        comparePhast(compact, trips);
+
+        for (const Trip& trip : trips)
+        {
+            start = Clock::now();
+            roadMap.findShortestPaths(trip.startVertex, {trip.endVertex}, TripPlanner::edgeWeightFor(trip.metric));
+            seconds.push_back(secondsSince(start));
+        }
+
+        report("point-to-point", seconds);
+
+        TripPlanner planner;
+        SearchStats stats;
+        start = Clock::now();
+        std::vector<Route> routes = planner.planTrips(roadMap, trips, stats);
+        double batchSeconds = secondsSince(start);
+
+        report("trip batch", {batchSeconds});
+        std::cout << "  " << std::setprecision(1) << trips.size() / batchSeconds
+            << " trips/s" << std::endl;
+
+        if (stats.queries > 0)
+        {
+            std::cout << "  per search: " << std::setprecision(1)
+                << static_cast<double>(stats.verticesSettled) / stats.queries << " settled, "
+                << static_cast<double>(stats.edgesRelaxed) / stats.queries << " relaxed, "
+                << static_cast<double>(stats.queuePushes) / stats.queries << " pushes, "
+                << static_cast<double>(stats.stalePops) / stats.queries << " stale pops; "
+                << "peak queue " << stats.peakQueueSize << std::endl;
+        }
+
+        std::ostringstream output;
+        start = Clock::now();
+
+        {
+            RouteWriter writer{output};
+
+            for (std::size_t i = 0; i < trips.size(); ++i)
+            {
+                writer.writeRoute(roadMap, trips[i], routes[i]);
+            }
+        }
+
+        report("route output", {secondsSince(start)});
+
+        compareLayouts(roadMap, compact, trips);
+
+        return 0;
+    }
+
+
+    int usage()
+    {
+        std::cerr << "usage: benchmain generate SHAPE VERTICES [SEED]" << std::endl
+            << "       benchmain run SHAPE VERTICES [TRIPS] [SEED]" << std::endl
+            << "SHAPE is one of grid, geometric, or highway" << std::endl;
+        return 2;
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> args{argv + 1, argv + argc};
+
+    if (args.size() < 3)
+    {
+        return usage();
+    }
+
+    try
+    {
+        MapShape shape = MapGenerator::parseShape(args[1]);
+        int vertexCount = std::stoi(args[2]);
+
+        if (args[0] == "generate" && args.size() <= 4)
+        {
+            return generate(shape, vertexCount, args.size() > 3 ? std::stoull(args[3]) : 1);
+        }
+        else if (args[0] == "run" && args.size() <= 5)
+        {
+            return run(
+                shape, vertexCount,
+                args.size() > 3 ? std::stoi(args[3]) : 1000,
+                args.size() > 4 ? std::stoull(args[4]) : 1);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+    }
+
+    return usage();
+}
+
@@ -0,0 +1,174 @@
+// loadgenmain.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// This is the main() function for the load generator, which measures how
+// quickly a running servermain answers trip requests:
+//
+//     loadgenmain SOCKET VERTICES [CONNECTIONS] [REQUESTS] [PIPELINE] [SEED]
+//
+// It opens the given number of connections (4 by default) to the server,
+// and on each one sends REQUESTS (1000 by default) random trips between
+// the vertices 0 through VERTICES - 1, alternating between the metrics.
+// Each connection keeps PIPELINE requests (1 by default) outstanding at
+// once.  Afterward, it reports the overall throughput and percentiles of
+// the time from sending each request to receiving its answer.
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LatencyHistogram.hpp"
+#include "UnixSocket.hpp"
+
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+
+    struct ConnectionResult
+    {
+        LatencyHistogram latencies;
+        std::size_t errors = 0;
+    };
+
+
+    // runConnection() sends a connection's requests a window of
+    // pipelineDepth at a time, timing each one's answer.
+    void runConnection(
+        const std::string& socketPath, int vertexCount, int requestCount,
+        int pipelineDepth, std::uint64_t seed, ConnectionResult& result)
+    {
+        UnixSocket connection = UnixSocket::connectTo(socketPath);
+
+        std::mt19937_64 random{seed};
+        std::uniform_int_distribution<int> vertex{0, vertexCount - 1};
+
+        std::vector<Clock::time_point> sent;
+        std::vector<std::string> answers;
+
+        for (int first = 0; first < requestCount; first += pipelineDepth)
+        {
+            int windowSize = std::min(pipelineDepth, requestCount - first);
+            std::string requests;
+
+            sent.clear();
+
+            for (int i = 0; i < windowSize; ++i)
+            {
+                requests += std::to_string(vertex(random)) + ' ' + std::to_string(vertex(random))
+                    + ((first + i) % 2 == 0 ? " D\n" : " T\n");
+            }
+
+            Clock::time_point now = Clock::now();
+            sent.assign(windowSize, now);
+            connection.writeAll(requests);
+
+            answers.clear();
+
+            while (answers.size() < static_cast<std::size_t>(windowSize))
+            {
+                std::size_t before = answers.size();
+
+                if (!connection.readLines(answers))
+                {
+                    throw std::runtime_error{"The server closed the connection"};
+                }
+
+                Clock::time_point received = Clock::now();
+
+                for (std::size_t i = before; i < answers.size(); ++i)
+                {
+                    result.latencies.record(received - sent[i]);
+
+                    if (answers[i].find("\"error\"") != std::string::npos)
+                    {
+                        result.errors++;
+                    }
+                }
+            }
+        }
+    }
+
+
+    double milliseconds(std::chrono::nanoseconds latency)
+    {
+        return std::chrono::duration<double, std::milli>(latency).count();
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    if (argc < 3 || argc > 7)
+    {
+        std::cerr << "usage: loadgenmain SOCKET VERTICES [CONNECTIONS] [REQUESTS] [PIPELINE] [SEED]" << std::endl;
+        return 2;
+    }
+
+    std::string socketPath{argv[1]};
+    int vertexCount = std::stoi(argv[2]);
+    int connectionCount = argc > 3 ? std::stoi(argv[3]) : 4;
+    int requestCount = argc > 4 ? std::stoi(argv[4]) : 1000;
+    int pipelineDepth = argc > 5 ? std::max(1, std::stoi(argv[5])) : 1;
+    std::uint64_t seed = argc > 6 ? std::stoull(argv[6]) : 1;
+
+    std::vector<ConnectionResult> results(connectionCount);
+    std::vector<std::thread> threads;
+    bool failed = false;
+
+    Clock::time_point start = Clock::now();
+
+    for (int c = 0; c < connectionCount; ++c)
+    {
+        threads.emplace_back(
+            [&, c]()
+            {
+                try
+                {
+                    runConnection(socketPath, vertexCount, requestCount, pipelineDepth, seed + c, results[c]);
+                }
+                catch (const std::exception& e)
+                {
+                    std::cerr << "connection " << c << ": " << e.what() << std::endl;
+                    failed = true;
+                }
+            });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    LatencyHistogram latencies;
+    std::size_t errors = 0;
+
+    for (const ConnectionResult& result : results)
+    {
+        latencies.merge(result.latencies);
+        errors += result.errors;
+    }
+
+    std::cout << std::fixed << std::setprecision(1)
+        << latencies.count() << " requests over " << connectionCount << " connections in "
+        << std::setprecision(3) << seconds << " s (" << std::setprecision(1)
+        << latencies.count() / seconds << " requests/s), " << errors << " errors" << std::endl
+        << std::setprecision(3)
+        << "latency (ms): mean " << milliseconds(latencies.mean())
+        << "  p50 " << milliseconds(latencies.percentile(50))
+        << "  p95 " << milliseconds(latencies.percentile(95))
+        << "  p99 " << milliseconds(latencies.percentile(99))
+        << "  max " << milliseconds(latencies.max()) << std::endl;
+
+    return failed ? 1 : 0;
+}
+
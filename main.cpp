@@ -5,77 +5,205 @@
 //
 // This is the program's main() function, which is the entry point for your
 // console user interface.
+//
+// Run as "main --report [THREADS]", the program also times every trip
+// individually, spread across the given number of threads (one per core
+// by default), and finishes with a summary of the run: throughput, plus
+// latency percentiles broken down by metric and by the number of road
+// segments in each route.
+//
+// "--format json" or "--format binary" writes the routes as JSON Lines
+// or binary records, described in RouteWriter.hpp, instead of as text.
+// The --report summary then goes to the standard error instead, so the
+// routes on the standard output can still be read back.
+//
+// "--delta FILE" applies the map edits in the given file (described in
+// MapDeltaReader.hpp) after the map is read and before the trips are; it
+// can be given more than once, and the files are applied in order.  A
+// file that can't be read, or whose edits don't fit the map, is reported
+// on the standard error and ends the program with an exit status of 1.
+#include <cctype>
+#include <chrono>
+#include <fstream>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 #include "InputReader.hpp"
+#include "LocationIndex.hpp"
+#include "MapDeltaReader.hpp"
 #include "RoadMapReader.hpp"
 #include "RoadMapWriter.hpp"
 #include "RoadSegment.hpp"
+#include "RouteWriter.hpp"
 #include "TripMetric.hpp"
 #include "Trip.hpp"
 #include "TripReader.hpp"
+#include "TripLatencyReport.hpp"
+#include "TripPlanner.hpp"
+#include "TurnTable.hpp"
 #include "Digraph.hpp"
 
-struct properties
+namespace
 {
-    int vertex;
-    std::string name;
-    RoadSegment information;
-};
+    void writeUsage()
+    {
+        std::cerr << "usage: main [--report [THREADS]] [--format text|json|binary] [--delta FILE]..." << std::endl;
+    }
 
-int main()
-{
-    InputReader inR = InputReader(std::cin);    //readLine() // readIntLine()
-    RoadMapReader rM;                           // knows how to read RoadMap
-    RoadMap roadMap = rM.readRoadMap(inR);;     // <name, RoadSegment>
-    //RoadSegment travel;
-    std::vector<Trip> trip;                     // start Vertex, endVertex, metric
-    TripReader tR;
-    trip = tR.readTrips(inR);                   //read the trip
-    
-    std::map<int, int> dijkstraMap;
-    for(auto iter = trip.begin(); iter != trip.end(); ++iter)
+
+    // planTimed() plans each trip on its own, spread across the given
+    // number of threads, recording each one's latency in that thread's
+    // own report, which are merged together at the end.
+    std::vector<Route> planTimed(
+        const RoadMap& roadMap, const TurnTable& turns, const std::vector<Trip>& trips,
+        unsigned int threadCount, TripLatencyReport& report)
     {
-        std::vector<properties> roadTripVector;
-        
-        if(iter->metric == TripMetric::Time)
+        std::vector<Route> routes(trips.size());
+        std::vector<TripLatencyReport> perThread(threadCount);
+        std::vector<std::thread> threads;
+
+        for (unsigned int t = 0; t < threadCount; ++t)
         {
-            dijkstraMap = roadMap.findShortestPaths(iter->startVertex, [](RoadSegment roadSegment){return roadSegment.milesPerHour/ roadSegment.miles;});
+            threads.emplace_back(
+                [&, t]()
+                {
+                    TripPlanner planner{turns};
+
+                    for (std::size_t i = t; i < trips.size(); i += threadCount)
+                    {
+                        auto start = std::chrono::steady_clock::now();
+                        routes[i] = planner.planTrips(roadMap, {trips[i]})[0];
+                        auto latency = std::chrono::steady_clock::now() - start;
+
+                        perThread[t].record(trips[i], routes[i], latency);
+                    }
+                });
         }
-        else
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        for (const TripLatencyReport& local : perThread)
         {
-            dijkstraMap = roadMap.findShortestPaths(iter->startVertex, [](RoadSegment roadSegment){return roadSegment.miles;});
+            report.merge(local);
         }
 
-        int last = iter->endVertex;
-        properties end = properties{last, roadMap.vertexInfo(last), roadMap.edgeInfo(dijkstraMap[last], last)};
-        roadTripVector.push_back(end);
-        double distance = end.information.miles;
-        
-        while(last != iter->startVertex)
+        return routes;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool report = false;
+    unsigned int threadCount = std::thread::hardware_concurrency();
+    RouteFormat format = RouteFormat::Text;
+    std::vector<std::string> deltaPaths;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string option{argv[i]};
+
+        if (option == "--report")
         {
-            int temp = last;
-            last = dijkstraMap[last];
-            roadTripVector.push_back(properties{last, roadMap.vertexInfo(last), roadMap.edgeInfo(last, temp)});
-                        
-            if (last != iter->startVertex)
+            report = true;
+
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0])))
             {
-                distance += roadMap.edgeInfo(last, temp).miles;
+                threadCount = std::stoul(argv[++i]);
             }
         }
-
-        if (iter->metric == TripMetric::Time)
+        else if (option == "--format" && i + 1 < argc)
+        {
+            try
+            {
+                format = RouteWriter::parseFormat(argv[++i]);
+            }
+            catch (const std::invalid_argument& e)
+            {
+                std::cerr << e.what() << std::endl;
+                writeUsage();
+                return 2;
+            }
+        }
+        else if (option == "--delta" && i + 1 < argc)
         {
-            std::cout << "Shortest driving time from " << roadMap.vertexInfo(roadTripVector.back().vertex)<< 
-                " to " << roadMap.vertexInfo(roadTripVector.front().vertex)<<std::endl;
+            deltaPaths.emplace_back(argv[++i]);
         }
         else
         {
-            std::cout << "Shortest distance from "<< roadMap.vertexInfo(roadTripVector.back().vertex)<<
-                " to "<<roadMap.vertexInfo(roadTripVector.front().vertex)<<std::endl;
+            writeUsage();
+            return 2;
         }
     }
 
+    InputReader inR = InputReader(std::cin);    //readLine() // readIntLine()
+    RoadMapReader rM;                           // knows how to read RoadMap
+    TurnTable turns;                            // banned turns and turn penalties, if any
+    RoadMap roadMap = rM.readRoadMap(inR, turns);   // <name, RoadSegment>
+    LocationIndex locations{roadMap};           // lets trips name their locations
+
+    for (const std::string& path : deltaPaths)
+    {
+        std::ifstream deltaFile{path};
+
+        if (!deltaFile)
+        {
+            std::cerr << "Can't open " << path << std::endl;
+            return 1;
+        }
+
+        // A delta that can't be read, or doesn't fit the map, leaves the
+        // map as it was, but the trips were meant for the edited one.
+        try
+        {
+            InputReader deltaIn{deltaFile};
+            MapDeltaReader{}.readMapDelta(deltaIn).applyTo(roadMap, locations, turns);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << path << ": " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Trip> trip;                     // start Vertex, endVertex, metric
+    TripReader tR{locations};
+    trip = tR.readTrips(inR);                   //read the trip
+
+    TripPlanner planner{turns};                 // one search per (start, metric) group
+    std::vector<Route> routes;
+    TripLatencyReport latencies;
+    auto start = std::chrono::steady_clock::now();
+
+    if (report)
+    {
+        routes = planTimed(roadMap, turns, trip, std::max(1u, threadCount), latencies);
+    }
+    else
+    {
+        routes = planner.planTrips(roadMap, trip);
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    {
+        RouteWriter writer{std::cout, turns, format};      // buffers the output; flushed at the end
+
+        for(std::size_t i = 0; i < trip.size(); ++i)
+        {
+            writer.writeRoute(roadMap, trip[i], routes[i]);
+        }
+    }
+
+    if (report)
+    {
+        latencies.write(format == RouteFormat::Text ? std::cout : std::cerr, seconds);
+    }
+
     return 0;
 }
-
@@ -0,0 +1,116 @@
+// servermain.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// This is the main() function for the routing server, which reads a
+// RoadMap from the standard input (in the same format as the main
+// program, including any TURNS section, but without any trips), then
+// answers trip requests on a Unix domain socket, as described in
+// RoutingServer.hpp, until it receives a SIGINT or SIGTERM:
+//
+//     servermain SOCKET [WORKERS] [--numa] < map.txt
+//
+// With --numa, the RoadMap is copied onto every NUMA node and the workers
+// are pinned across the nodes, each planning trips on its local copy.
+//
+// For example, once it's running, "echo '0 3 D' | nc -U SOCKET" plans a
+// trip.  loadgenmain measures how quickly it answers.
+
+#include <csignal>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <pthread.h>
+#include "InputReader.hpp"
+#include "NumaReplicas.hpp"
+#include "RoadMapReader.hpp"
+#include "RoutingServer.hpp"
+#include "TurnTable.hpp"
+
+
+int main(int argc, char** argv)
+{
+    unsigned int workerCount = 0;
+    bool numa = false;
+    bool usage = argc < 2;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string option{argv[i]};
+
+        if (option == "--numa")
+        {
+            numa = true;
+        }
+        else if (workerCount == 0 && option.find_first_not_of("0123456789") == std::string::npos)
+        {
+            workerCount = static_cast<unsigned int>(std::stoul(option));
+        }
+        else
+        {
+            usage = true;
+        }
+    }
+
+    if (usage)
+    {
+        std::cerr << "usage: servermain SOCKET [WORKERS] [--numa] < map.txt" << std::endl;
+        return 2;
+    }
+
+    // SIGINT and SIGTERM are blocked in every thread and waited for by
+    // one thread of their own, which can then stop the server safely,
+    // rather than in a signal handler.
+    sigset_t stopSignals;
+    sigemptyset(&stopSignals);
+    sigaddset(&stopSignals, SIGINT);
+    sigaddset(&stopSignals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stopSignals, nullptr);
+
+    try
+    {
+        InputReader in{std::cin};
+        TurnTable turns;
+        RoadMap roadMap = RoadMapReader{}.readRoadMap(in, turns);
+
+        std::unique_ptr<NumaReplicas<RoadMap>> replicas;
+        std::unique_ptr<RoutingServer> server;
+
+        if (numa)
+        {
+            replicas = std::make_unique<NumaReplicas<RoadMap>>(
+                NumaTopology::detect(), [&]() { return roadMap.detachedCopy(); });
+
+            server = std::make_unique<RoutingServer>(*replicas, turns, workerCount);
+
+            std::cerr << "Replicated the map on " << replicas->topology().nodeCount()
+                << " NUMA node(s)" << std::endl;
+        }
+        else
+        {
+            server = std::make_unique<RoutingServer>(roadMap, turns, workerCount);
+        }
+
+        std::thread{
+            [&]()
+            {
+                int signal;
+                sigwait(&stopSignals, &signal);
+                server->stop();
+            }}.detach();
+
+        std::cerr << "Serving " << roadMap.vertexCount() << " locations and "
+            << turns.size() << " turn rules on " << argv[1] << std::endl;
+        server->serve(argv[1]);
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
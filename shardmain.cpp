@@ -0,0 +1,353 @@
+// shardmain.cpp
+//
+// ICS 46 Winter 2022
+// Project #5: Rock and Roll Stops the Traffic
+//
+// This is the main() function for sharded routing, which runs in two
+// steps so that no process but the first ever holds the whole RoadMap:
+//
+//     shardmain partition SHARDS DIRECTORY < map.txt
+//         reads a RoadMap, splits it into the given number of shards
+//         with a RoadMapPartition, and writes the partition (which shard
+//         each location is in, and the cut edges between shards) to
+//         DIRECTORY/partition.txt and each shard's own RoadMap to
+//         DIRECTORY/shard-N.txt, creating the directory if need be
+//
+//     shardmain route DIRECTORY [--verify MAP] < trips.txt
+//         reads only the partition, then starts one child process per
+//         shard, each running a ShardWorker over the shard it reads from
+//         its own file.  The trips are answered by a ShardedRouter
+//         talking to those processes over socket pairs, and written out
+//         the same way the main program does, using only the locations
+//         and road segments the routes need, fetched from the shards
+//
+// Summaries of the partition, and of the overlay and routing, go to the
+// standard error.  With --verify, every trip is also planned by a
+// TripPlanner over the whole RoadMap read from MAP, and any trip whose
+// cost differs is reported there; the exit status is then 1 if there
+// were any.  (That is the only time the route step loads the whole map.)
+//
+// The shards search without turn rules, so a map with a TURNS section
+// that has any rules in it is refused rather than routed without them.
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "InputReader.hpp"
+#include "RoadMapPartition.hpp"
+#include "RoadMapReader.hpp"
+#include "RoadMapWriter.hpp"
+#include "RouteWriter.hpp"
+#include "ShardWorker.hpp"
+#include "ShardedRouter.hpp"
+#include "TripPlanner.hpp"
+#include "TripReader.hpp"
+#include "TurnTable.hpp"
+
+
+namespace
+{
+    std::string partitionPath(const std::string& directory)
+    {
+        return directory + "/partition.txt";
+    }
+
+
+    std::string shardPath(const std::string& directory, int shard)
+    {
+        return directory + "/shard-" + std::to_string(shard) + ".txt";
+    }
+
+
+    // writeFile() writes a file using the given function, throwing a
+    // std::system_error if it can't be created or written.
+    void writeFile(const std::string& path, const std::function<void(std::ostream&)>& writeFunc)
+    {
+        std::ofstream out{path};
+
+        if (!out)
+        {
+            throw std::system_error{errno, std::generic_category(), path};
+        }
+
+        writeFunc(out);
+        out.flush();
+
+        if (!out)
+        {
+            throw std::system_error{errno, std::generic_category(), path};
+        }
+    }
+
+
+    // readFile() reads a file using the given function, throwing a
+    // std::system_error if it can't be opened.
+    template <typename ReadFunc>
+    auto readFile(const std::string& path, ReadFunc readFunc)
+    {
+        std::ifstream file{path};
+
+        if (!file)
+        {
+            throw std::system_error{errno, std::generic_category(), path};
+        }
+
+        InputReader in{file};
+        return readFunc(in);
+    }
+
+
+    // readMapWithoutTurns() reads a RoadMap, throwing a
+    // std::invalid_argument if it has any turn rules, since the shards
+    // search without them.
+    RoadMap readMapWithoutTurns(InputReader& in)
+    {
+        TurnTable turns;
+        RoadMap roadMap = RoadMapReader{}.readRoadMap(in, turns);
+
+        if (!turns.empty())
+        {
+            throw std::invalid_argument{
+                "Sharded routing can't obey turn rules, but the map has " + std::to_string(turns.size())};
+        }
+
+        return roadMap;
+    }
+
+
+    // startShards() forks one ShardWorker process per shard, each reading
+    // its shard from the given directory, returning the coordinator's
+    // end of each one's socket pair, in shard order.
+    std::vector<UnixSocket> startShards(
+        const std::string& directory, int shardCount, std::vector<pid_t>& children)
+    {
+        std::vector<UnixSocket> sockets;
+
+        for (int shard = 0; shard < shardCount; ++shard)
+        {
+            std::pair<UnixSocket, UnixSocket> ends = UnixSocket::pair();
+            pid_t child = ::fork();
+
+            if (child < 0)
+            {
+                throw std::system_error{errno, std::generic_category(), "fork"};
+            }
+            else if (child == 0)
+            {
+                // The child closes every coordinator end it inherited, so
+                // that each worker sees its connection close when the
+                // coordinator closes it, then never returns.
+                sockets.clear();
+                ends.first = UnixSocket{-1};
+
+                try
+                {
+                    ShardWorker worker{readFile(
+                        shardPath(directory, shard),
+                        [](InputReader& in) { return RoadMapReader{}.readNumberedRoadMap(in); })};
+
+                    worker.serve(ends.second);
+                }
+                catch (const std::exception& e)
+                {
+                    std::cerr << "Shard " << shard << ": " << e.what() << std::endl;
+                    ::_exit(1);
+                }
+
+                ::_exit(0);
+            }
+
+            children.push_back(child);
+            sockets.push_back(std::move(ends.first));
+        }
+
+        return sockets;
+    }
+
+
+    double costOf(const Route& route, TripMetric metric)
+    {
+        return metric == TripMetric::Time ? route.hours : route.miles;
+    }
+
+
+    // sameCost() returns true if the two routes are equally good, allowing
+    // for the different order in which their costs were added up.
+    bool sameCost(const Route& a, const Route& b, TripMetric metric)
+    {
+        if (a.vertices.empty() || b.vertices.empty())
+        {
+            return a.vertices.empty() == b.vertices.empty();
+        }
+
+        double difference = std::fabs(costOf(a, metric) - costOf(b, metric));
+        return difference <= 1e-9 * std::max(1.0, costOf(b, metric));
+    }
+
+
+    // writeSummary() writes the size of each shard to the standard error.
+    void writeSummary(const RoadMapPartition& partition)
+    {
+        for (int shard = 0; shard < partition.shardCount(); ++shard)
+        {
+            std::cerr << "Shard " << shard << ": " << partition.shardSize(shard) << " locations, "
+                      << partition.boundaryVertices(shard).size() << " on the boundary" << std::endl;
+        }
+    }
+
+
+    int partition(int shardCount, const std::string& directory)
+    {
+        InputReader in{std::cin};
+        RoadMap roadMap = readMapWithoutTurns(in);
+        RoadMapPartition partition{roadMap, shardCount};
+
+        if (::mkdir(directory.c_str(), 0777) != 0 && errno != EEXIST)
+        {
+            throw std::system_error{errno, std::generic_category(), directory};
+        }
+
+        writeFile(partitionPath(directory), [&](std::ostream& out) { partition.write(out); });
+
+        for (int shard = 0; shard < partition.shardCount(); ++shard)
+        {
+            writeFile(
+                shardPath(directory, shard),
+                [&](std::ostream& out) { RoadMapWriter{}.writeNumberedRoadMap(out, partition.shardRoadMap(roadMap, shard)); });
+        }
+
+        writeSummary(partition);
+        std::cerr << partition.cutEdges().size() << " cut edges" << std::endl;
+
+        return 0;
+    }
+
+
+    int route(const std::string& directory, const std::string& verifyPath, std::vector<pid_t>& children)
+    {
+        RoadMapPartition partition = readFile(partitionPath(directory), &RoadMapPartition::read);
+        writeSummary(partition);
+
+        InputReader in{std::cin};
+        std::vector<Trip> trips = TripReader{}.readTrips(in);
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<Route> routes;
+        RoadMap routeMap;
+
+        {
+            ShardedRouter router{partition, startShards(directory, partition.shardCount(), children)};
+
+            std::cerr << "Overlay: " << router.overlayVertexCount() << " vertices, "
+                      << router.overlayEdgeCount() << " edges, built in "
+                      << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()
+                      << " s" << std::endl;
+
+            start = std::chrono::steady_clock::now();
+
+            for (const Trip& trip : trips)
+            {
+                routes.push_back(router.route(trip));
+            }
+
+            std::cerr << "Routed " << trips.size() << " trips in "
+                      << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()
+                      << " s" << std::endl;
+
+            routeMap = router.routeMapFor(trips, routes);
+        }
+
+        {
+            RouteWriter writer{std::cout};
+
+            for (std::size_t i = 0; i < trips.size(); ++i)
+            {
+                writer.writeRoute(routeMap, trips[i], routes[i]);
+            }
+        }
+
+        if (verifyPath.empty())
+        {
+            return 0;
+        }
+
+        RoadMap roadMap = readFile(verifyPath, &readMapWithoutTurns);
+        std::vector<Route> expected = TripPlanner{}.planTrips(roadMap, trips);
+        int mismatches = 0;
+
+        for (std::size_t i = 0; i < trips.size(); ++i)
+        {
+            if (!sameCost(routes[i], expected[i], trips[i].metric))
+            {
+                std::cerr << "Trip " << i << " differs: " << costOf(routes[i], trips[i].metric)
+                          << " instead of " << costOf(expected[i], trips[i].metric) << std::endl;
+                mismatches++;
+            }
+        }
+
+        std::cerr << "Verified " << trips.size() - mismatches << " of " << trips.size() << " trips" << std::endl;
+        return mismatches == 0 ? 0 : 1;
+    }
+
+
+    int usage()
+    {
+        std::cerr << "usage: shardmain partition SHARDS DIRECTORY < map.txt" << std::endl
+                  << "       shardmain route DIRECTORY [--verify MAP] < trips.txt" << std::endl;
+        return 2;
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> args{argv + 1, argv + argc};
+    std::vector<pid_t> children;
+    int status = 1;
+
+    try
+    {
+        if (args.size() == 3 && args[0] == "partition")
+        {
+            status = partition(std::stoi(args[1]), args[2]);
+        }
+        else if (args.size() == 2 && args[0] == "route")
+        {
+            status = route(args[1], "", children);
+        }
+        else if (args.size() == 4 && args[0] == "route" && args[2] == "--verify")
+        {
+            status = route(args[1], args[3], children);
+        }
+        else
+        {
+            return usage();
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        status = 1;
+    }
+
+    // The router's sockets are closed by now, so every shard finishes.
+    for (pid_t child : children)
+    {
+        ::waitpid(child, nullptr, 0);
+    }
+
+    return status;
+}